@@ -2,31 +2,156 @@
 #include <random>
 #include <numeric>
 #include <cmath>
-#include <glib.h> // For G_PI
+#include <stdexcept>
+#include <utility>
+#include "Common.hpp"
+#include "CpuDispatch.hpp"
 
 AWGN::AWGN(double targetSNRdB, double bitRate, double bandwidth, ModulationType mod, CodingType code, unsigned int seed)
     : snrController_(targetSNRdB, bitRate, bandwidth), seed_(seed), channelModel_(mod, code) {}
 
-std::vector<double> AWGN::addNoise(const std::vector<double>& signal) {
-    double noisePower;
-    snrController_.adjustNoisePower(const_cast<std::vector<double>&>(signal), noisePower);
-    double noiseStdDev = std::sqrt(noisePower);
-
-    std::mt19937 gen(seed_);
+void AWGN::generateUnitNoise(unsigned int seed, double* out, size_t n) {
+    std::mt19937 gen(seed);
     std::uniform_real_distribution<> uniform(0.0, 1.0);
-
-    std::vector<double> noisySignal(signal.size());
-    for (size_t i = 0; i < signal.size(); ++i) {
+    for (size_t i = 0; i < n; ++i) {
         // Box-Muller transform
         double u1 = uniform(gen);
         double u2 = uniform(gen);
-        double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * G_PI * u2); // Standard normal
-        noisySignal[i] = signal[i] + noiseStdDev * z; // Scale by noiseStdDev
+        out[i] = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * Constants::PI * u2); // Standard normal
     }
+}
 
+std::vector<double> AWGN::addNoise(const std::vector<double>& signal) {
+    Arena scratch;
+    std::vector<double> noisySignal(signal.size());
+    addNoise(signal.data(), signal.size(), noisySignal.data(), scratch);
     return noisySignal;
 }
 
+void AWGN::generateShapedNoise(const NoiseShaper* shaper, unsigned int seed, double* out, size_t n,
+                               Arena& scratch) {
+    if (shaper) {
+        // Shaped noise: generate extra history so the filter output is in steady state
+        size_t numWhite = n + shaper->getHistoryLength();
+        double* white = scratch.allocate<double>(numWhite);
+        generateUnitNoise(seed, white, numWhite);
+        shaper->apply(white, out, n, scratch);
+    } else {
+        generateUnitNoise(seed, out, n);
+    }
+}
+
+uint64_t AWGN::noiseLayout() const {
+    if (!noiseShaper_) {
+        return 0;
+    }
+    // FNV-1a over the filter taps: identical shaping shares cache entries
+    uint64_t h = 1469598103934665603ULL;
+    for (double tap : noiseShaper_->getTaps()) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&tap);
+        for (size_t b = 0; b < sizeof(double); ++b) {
+            h = (h ^ bytes[b]) * 1099511628211ULL;
+        }
+    }
+    return h | 1; // Never collides with white noise
+}
+
+void AWGN::addNoise(const double* signal, size_t numSamples, double* noisy, Arena& scratch) {
+    addNoise(signal, 1, noisy, 1, numSamples, scratch);
+}
+
+const double* AWGN::drawNoise(const double* signal, size_t signalStride, size_t numSamples, double& noiseStdDev,
+                             NoisePool::Lease& lease, Arena& scratch) {
+    double noisePower;
+    snrController_.adjustNoisePower(signal, numSamples, noisePower, signalStride);
+    noiseStdDev = std::sqrt(noisePower);
+
+    if (unitNoise_) {
+        if (unitNoise_->size() != numSamples) {
+            throw std::invalid_argument("Unit noise block does not match the signal length");
+        }
+        return unitNoise_->data();
+    }
+    if (noiseCache_) {
+        NoiseKey key{seed_, numSamples, noiseLayout()};
+        return noiseCache_->get(key, [this, &scratch](double* out, size_t n) {
+            generateShapedNoise(noiseShaper_.get(), seed_, out, n, scratch);
+        }).data();
+    }
+    if (noisePool_) {
+        // Queued blocks keep their own reference to the shaper
+        std::shared_ptr<const NoiseShaper> shaper = noiseShaper_;
+        NoiseKey key{seed_, numSamples, noiseLayout()};
+        lease = noisePool_->acquire(key, [shaper](unsigned int seed, double* out, size_t n, Arena& work) {
+            generateShapedNoise(shaper.get(), seed, out, n, work);
+        }, scratch);
+        return lease.data();
+    }
+    double* generated = scratch.allocate<double>(numSamples);
+    generateShapedNoise(noiseShaper_.get(), seed_, generated, numSamples, scratch);
+    return generated;
+}
+
+void AWGN::addNoise(const double* signal, size_t signalStride, double* noisy, size_t noisyStride, size_t numSamples,
+                    Arena& scratch) {
+    double noiseStdDev;
+    NoisePool::Lease lease; // Holds the pool slab until the noise is added
+    const double* noise = drawNoise(signal, signalStride, numSamples, noiseStdDev, lease, scratch);
+
+    // Fused scale-and-add, the only per-sample work on a cache hit
+    if (signalStride == 1 && noisyStride == 1) {
+        CpuDispatch::kernels().scaleAdd(signal, noise, noiseStdDev, noisy, numSamples);
+    } else {
+        for (size_t i = 0; i < numSamples; ++i) {
+            noisy[i * noisyStride] = signal[i * signalStride] + noiseStdDev * noise[i];
+        }
+    }
+}
+
 ChannelModel& AWGN::getChannelModel() {
     return channelModel_;
+}
+
+const ChannelModel& AWGN::getChannelModel() const {
+    return channelModel_;
+}
+
+void AWGN::setNoiseShaper(std::shared_ptr<const NoiseShaper> shaper) {
+    noiseShaper_ = std::move(shaper);
+}
+
+void AWGN::enableBandlimitedNoise(size_t numTaps) {
+    noiseShaper_ = std::make_shared<NoiseShaper>(NoiseShaper::lowpass(snrController_.getBandwidth(), numTaps));
+}
+
+const NoiseShaper* AWGN::getNoiseShaper() const {
+    return noiseShaper_.get();
+}
+
+void AWGN::setNoiseCache(std::shared_ptr<NoiseCache> cache) {
+    noiseCache_ = std::move(cache);
+}
+
+void AWGN::setNoisePool(std::shared_ptr<NoisePool> pool) {
+    noisePool_ = std::move(pool);
+}
+
+void AWGN::setUnitNoise(std::shared_ptr<const std::vector<double>> noise) {
+    unitNoise_ = std::move(noise);
+}
+
+void AWGN::setTargetSNRdB(double snr_dB) {
+    snrController_.setTargetSNRdB(snr_dB);
+}
+
+double AWGN::getTargetSNRdB() const {
+    return snrController_.getTargetSNRdB();
+}
+
+unsigned int AWGN::getSeed() const {
+    return seed_;
+}
+
+void AWGN::setSeed(unsigned int seed) {
+    seed_ = seed;
 }
\ No newline at end of file
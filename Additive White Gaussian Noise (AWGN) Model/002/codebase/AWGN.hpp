@@ -2,19 +2,61 @@
 #define AWGN_HPP
 
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include "SignalToNoiseRatio.hpp"
 #include "ChannelModel.hpp"
+#include "NoiseShaper.hpp"
+#include "Arena.hpp"
+#include "NoiseCache.hpp"
+#include "NoisePool.hpp"
 
 class AWGN {
 private:
     SignalToNoiseRatio snrController_;
     unsigned int seed_;
     ChannelModel channelModel_;
+    std::shared_ptr<const NoiseShaper> noiseShaper_; // Null for white noise
+    std::shared_ptr<NoiseCache> noiseCache_;         // Null to regenerate on every call
+    std::shared_ptr<NoisePool> noisePool_;           // Null to generate on the calling thread
+    std::shared_ptr<const std::vector<double>> unitNoise_; // Null unless set with setUnitNoise
+    uint64_t noiseLayout() const;
 
 public:
+    // The unit noise behind addNoise: white, or shaped when `shaper` is set
+    static void generateUnitNoise(unsigned int seed, double* out, size_t n);
+    static void generateShapedNoise(const NoiseShaper* shaper, unsigned int seed, double* out, size_t n,
+                                    Arena& scratch);
+
     AWGN(double targetSNRdB, double bitRate, double bandwidth, ModulationType mod, CodingType code = NONE, unsigned int seed = 0);
     std::vector<double> addNoise(const std::vector<double>& signal);
+    // Writes numSamples noisy samples to `noisy` (may alias `signal`); shaping history comes from `scratch`
+    void addNoise(const double* signal, size_t numSamples, double* noisy, Arena& scratch);
+    // Same on strided buffers (strides in samples), e.g. one channel of an interleaved recording
+    void addNoise(const double* signal, size_t signalStride, double* noisy, size_t noisyStride, size_t numSamples,
+                  Arena& scratch);
+    // The unit noise addNoise would add, for callers that fuse it into their own pass:
+    // noiseStdDev is set for the target SNR against `signal`. The block stays valid
+    // while `lease` and `scratch` are held and no other noise is drawn.
+    const double* drawNoise(const double* signal, size_t signalStride, size_t numSamples, double& noiseStdDev,
+                            NoisePool::Lease& lease, Arena& scratch);
     ChannelModel& getChannelModel();
+    const ChannelModel& getChannelModel() const;
+    void setNoiseShaper(std::shared_ptr<const NoiseShaper> shaper);
+    void enableBandlimitedNoise(size_t numTaps = 63); // Lowpass to the controller's bandwidth
+    const NoiseShaper* getNoiseShaper() const;
+    // Share a cache between runs so repeated seeds only rescale the stored unit noise
+    void setNoiseCache(std::shared_ptr<NoiseCache> cache);
+    // Generate the next seeds' noise in the background; a cache, if set, is asked first
+    void setNoisePool(std::shared_ptr<NoisePool> pool);
+    // Use this block, generated for the same seed and shaping, instead of drawing the
+    // noise; every call must then be for exactly noise->size() samples. Read only, so
+    // one block can serve many AWGN objects on different threads.
+    void setUnitNoise(std::shared_ptr<const std::vector<double>> noise);
+    void setTargetSNRdB(double snr_dB);
+    double getTargetSNRdB() const;
+    unsigned int getSeed() const;
+    void setSeed(unsigned int seed);
 };
 
-#endif // AWGN_HPP
\ No newline at end of file
+#endif // AWGN_HPP
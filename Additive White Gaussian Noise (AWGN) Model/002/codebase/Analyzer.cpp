@@ -4,21 +4,30 @@
 #include <limits>
 #include <cmath>
 #include <random>
+#include "CpuDispatch.hpp"
 
 double Analyzer::computeSNR(const std::vector<double>& original, const std::vector<double>& noisy) {
     if (original.size() != noisy.size()) {
         throw std::invalid_argument("Signal and noisy signal must have the same size");
     }
+    return computeSNR(original.data(), 1, noisy.data(), 1, original.size());
+}
 
-    double signalPower = std::accumulate(original.begin(), original.end(), 0.0,
-        [](double sum, double x) { return sum + x * x; }) / original.size();
-
-    std::vector<double> noise(original.size());
-    for (size_t i = 0; i < original.size(); ++i) {
-        noise[i] = noisy[i] - original[i];
+double Analyzer::computeSNR(const double* original, size_t originalStride, const double* noisy, size_t noisyStride, size_t count) {
+    double signalPower = 0.0;
+    double noisePower = 0.0;
+    if (originalStride == 1 && noisyStride == 1) {
+        CpuDispatch::kernels().sumSquaresAndError(original, noisy, count, signalPower, noisePower);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            double x = original[i * originalStride];
+            double noise = noisy[i * noisyStride] - x;
+            signalPower += x * x;
+            noisePower += noise * noise;
+        }
     }
-    double noisePower = std::accumulate(noise.begin(), noise.end(), 0.0,
-        [](double sum, double x) { return sum + x * x; }) / noise.size();
+    signalPower /= count;
+    noisePower /= count;
 
     if (noisePower == 0.0) {
         return std::numeric_limits<double>::infinity();
@@ -33,13 +42,26 @@ double Analyzer::computeZeroCrossings(const std::vector<double>& noisy, double f
 }
 
 std::vector<size_t> Analyzer::computeZeroCrossingPoints(const std::vector<double>& noisy) {
-    std::vector<size_t> crossingPoints;
-    for (size_t i = 1; i < noisy.size(); ++i) {
-        if ((noisy[i-1] < 0 && noisy[i] >= 0) || (noisy[i-1] > 0 && noisy[i] <= 0)) {
-            crossingPoints.push_back(i);
+    // Count first, then fill exactly
+    std::vector<size_t> crossingPoints(computeZeroCrossingPoints(noisy.data(), noisy.size(), 1, nullptr, 0));
+    computeZeroCrossingPoints(noisy.data(), noisy.size(), 1, crossingPoints.data(), crossingPoints.size());
+    return crossingPoints;
+}
+
+size_t Analyzer::computeZeroCrossingPoints(const double* noisy, size_t count, size_t stride, size_t* points, size_t capacity) {
+    if (stride == 1) {
+        return CpuDispatch::kernels().zeroCrossings(noisy, count, points, capacity);
+    }
+    size_t found = 0;
+    for (size_t i = 1; i < count; ++i) {
+        double previous = noisy[(i - 1) * stride];
+        double current = noisy[i * stride];
+        if ((previous < 0 && current >= 0) || (previous > 0 && current <= 0)) {
+            if (found < capacity) points[found] = i;
+            ++found;
         }
     }
-    return crossingPoints;
+    return found;
 }
 
 std::tuple<double, double, double> Analyzer::computePhasorStatistics(const std::vector<double>& noisy, const std::vector<double>& original, unsigned int seed) {
@@ -47,29 +69,23 @@ std::tuple<double, double, double> Analyzer::computePhasorStatistics(const std::
         throw std::invalid_argument("Signal and noisy signal must have the same size");
     }
 
-    // Compute noise
-    std::vector<double> noise(noisy.size());
+    // Compute noise power
+    double noisePower = 0.0;
     for (size_t i = 0; i < noisy.size(); ++i) {
-        noise[i] = noisy[i] - original[i];
+        double noise = noisy[i] - original[i];
+        noisePower += noise * noise;
     }
-
-    // Generate bandlimited AWGN
-    double noisePower = std::accumulate(noise.begin(), noise.end(), 0.0,
-        [](double sum, double x) { return sum + x * x; }) / noise.size();
+    noisePower /= noisy.size();
     double sigma = std::sqrt(noisePower / 2);
 
+    // Generate bandlimited AWGN and compute magnitudes on the fly
     std::mt19937 gen(seed);
     std::normal_distribution<> dist(0.0, sigma);
-    std::vector<double> real_parts(noisy.size()), imag_parts(noisy.size());
-    for (size_t i = 0; i < noisy.size(); ++i) {
-        real_parts[i] = dist(gen);
-        imag_parts[i] = dist(gen);
-    }
-
-    // Compute magnitudes
     int count1 = 0, count2 = 0, count3 = 0;
     for (size_t i = 0; i < noisy.size(); ++i) {
-        double magnitude = std::sqrt(real_parts[i] * real_parts[i] + imag_parts[i] * imag_parts[i]);
+        double real_part = dist(gen);
+        double imag_part = dist(gen);
+        double magnitude = std::sqrt(real_part * real_part + imag_part * imag_part);
         if (magnitude <= sigma) count1++;
         if (magnitude <= 2 * sigma) count2++;
         if (magnitude <= 3 * sigma) count3++;
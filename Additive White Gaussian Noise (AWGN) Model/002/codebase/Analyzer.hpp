@@ -8,8 +8,11 @@
 class Analyzer {
 public:
     double computeSNR(const std::vector<double>& original, const std::vector<double>& noisy);
+    double computeSNR(const double* original, size_t originalStride, const double* noisy, size_t noisyStride, size_t count);
     double computeZeroCrossings(const std::vector<double>& noisy, double frequency, double bandwidth, double snr_db);
     std::vector<size_t> computeZeroCrossingPoints(const std::vector<double>& noisy);
+    // Writes up to `capacity` crossing indices (in samples, not memory offsets); returns how many there are
+    size_t computeZeroCrossingPoints(const double* noisy, size_t count, size_t stride, size_t* points, size_t capacity);
     std::tuple<double, double, double> computePhasorStatistics(const std::vector<double>& noisy, const std::vector<double>& original, unsigned int seed);
 };
 
@@ -0,0 +1,115 @@
+#include "Arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+    constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+    constexpr size_t MIN_BLOCK_SIZE = size_t(64) << 10;
+}
+
+Arena::Arena(size_t initialSize, bool useHugePages)
+    : offset_(0), used_(0), highWater_(0), useHugePages_(useHugePages), systemAllocations_(0) {
+    if (initialSize > 0) {
+        blocks_.push_back(allocateBlock(initialSize));
+    }
+}
+
+Arena::~Arena() {
+    for (const auto& block : blocks_) {
+        releaseBlock(block);
+    }
+}
+
+Arena::Block Arena::allocateBlock(size_t size) {
+    size = std::max(size, MIN_BLOCK_SIZE);
+    ++systemAllocations_;
+#ifdef __linux__
+    if (useHugePages_) {
+        size_t rounded = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void* p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED) {
+            // No reserved huge pages: fall back to transparent huge pages
+            p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, rounded, MADV_HUGEPAGE);
+            }
+        }
+        if (p != MAP_FAILED) {
+            return Block{static_cast<char*>(p), rounded, true};
+        }
+    }
+#endif
+    char* p = static_cast<char*>(::operator new(size, std::align_val_t(DEFAULT_ALIGNMENT)));
+    return Block{p, size, false};
+}
+
+void Arena::releaseBlock(const Block& block) {
+#ifdef __linux__
+    if (block.mapped) {
+        munmap(block.data, block.size);
+        return;
+    }
+#endif
+    ::operator delete(block.data, std::align_val_t(DEFAULT_ALIGNMENT));
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Arena alignment must be a power of two");
+    }
+    // Count worst-case padding so a single block of highWater_ bytes always fits a repeat run
+    used_ += bytes + alignment;
+    if (!blocks_.empty()) {
+        const Block& block = blocks_.back();
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        uintptr_t aligned = (base + offset_ + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        size_t end = (aligned - base) + bytes;
+        if (end <= block.size) {
+            offset_ = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+
+    // Spill into a new block; reset() folds the chain back into one block
+    size_t lastSize = blocks_.empty() ? 0 : blocks_.back().size;
+    blocks_.push_back(allocateBlock(std::max(2 * lastSize, bytes + alignment)));
+    const Block& block = blocks_.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+    uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    offset_ = (aligned - base) + bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::reset() {
+    highWater_ = std::max(highWater_, used_);
+    if (blocks_.size() > 1) {
+        for (const auto& block : blocks_) {
+            releaseBlock(block);
+        }
+        blocks_.clear();
+        blocks_.push_back(allocateBlock(highWater_));
+    }
+    offset_ = 0;
+    used_ = 0;
+}
+
+size_t Arena::getCapacity() const {
+    size_t capacity = 0;
+    for (const auto& block : blocks_) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+size_t Arena::getHighWater() const {
+    return std::max(highWater_, used_);
+}
+
+size_t Arena::getSystemAllocations() const {
+    return systemAllocations_;
+}
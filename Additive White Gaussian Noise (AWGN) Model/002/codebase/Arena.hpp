@@ -0,0 +1,48 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <vector>
+#include <cstddef> // For size_t
+
+// Bump allocator for per-run scratch buffers. allocate() only advances an offset;
+// reset() rewinds it. If a run outgrows the current block, further blocks are
+// chained, and the next reset() replaces them with one block that fits the whole
+// run, so repeated runs of the same size stop touching the system allocator.
+// Memory is handed out uninitialized and is only valid until the next reset().
+class Arena {
+private:
+    struct Block {
+        char* data;
+        size_t size;
+        bool mapped; // Obtained from mmap (huge pages) rather than operator new
+    };
+    std::vector<Block> blocks_;
+    size_t offset_;    // Bytes used in the last block
+    size_t used_;      // Bytes requested since the last reset, plus worst-case alignment padding
+    size_t highWater_; // Largest used_ seen
+    bool useHugePages_;
+    size_t systemAllocations_;
+    Block allocateBlock(size_t size);
+    void releaseBlock(const Block& block);
+
+public:
+    static constexpr size_t DEFAULT_ALIGNMENT = 64; // Cache line, also enough for AVX-512
+
+    explicit Arena(size_t initialSize = 0, bool useHugePages = false);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = DEFAULT_ALIGNMENT);
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T) > DEFAULT_ALIGNMENT ? alignof(T) : DEFAULT_ALIGNMENT));
+    }
+    void reset();
+
+    size_t getCapacity() const;
+    size_t getHighWater() const;
+    size_t getSystemAllocations() const; // Blocks obtained from the OS so far
+};
+
+#endif // ARENA_HPP
@@ -0,0 +1,255 @@
+#define AWGN_BUILDING
+#include "awgn_c.h"
+#include "AWGN.hpp"
+#include "Analyzer.hpp"
+#include "Arena.hpp"
+#include "SignalGenerator.hpp"
+#include "SignalToNoiseRatio.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+struct awgn_channel {
+    AWGN awgn;
+    Arena scratch;
+
+    explicit awgn_channel(const awgn_channel_config& config)
+        : awgn(config.snr_db, config.bit_rate, config.bandwidth, static_cast<ModulationType>(config.modulation),
+               static_cast<CodingType>(config.coding), config.seed) {}
+};
+
+namespace {
+    thread_local std::string lastError;
+
+    // Size of awgn_channel_config in API version 1; later fields are appended after it
+    const size_t CONFIG_V1_SIZE = offsetof(awgn_channel_config, bandlimited_noise) + sizeof(int);
+
+    awgn_status fail(awgn_status status, const char* message) {
+        lastError = message;
+        return status;
+    }
+
+    // Every entry point runs its body through here so no exception crosses the C boundary
+    template <typename Body>
+    awgn_status guarded(Body body) {
+        try {
+            body();
+            return AWGN_OK;
+        } catch (const std::invalid_argument& e) {
+            return fail(AWGN_ERROR_INVALID_ARGUMENT, e.what());
+        } catch (const std::bad_alloc&) {
+            return fail(AWGN_ERROR_OUT_OF_MEMORY, "Out of memory");
+        } catch (const std::exception& e) {
+            return fail(AWGN_ERROR_INTERNAL, e.what());
+        } catch (...) {
+            return fail(AWGN_ERROR_INTERNAL, "Unknown error");
+        }
+    }
+
+    bool validStrides(size_t a, size_t b) {
+        return a > 0 && b > 0;
+    }
+}
+
+extern "C" {
+
+int awgn_api_version(void) {
+    return AWGN_API_VERSION;
+}
+
+const char* awgn_last_error(void) {
+    return lastError.c_str();
+}
+
+void awgn_channel_config_init(awgn_channel_config* config) {
+    if (!config) return;
+    config->size = sizeof(awgn_channel_config);
+    config->modulation = AWGN_MODULATION_BPSK;
+    config->coding = AWGN_CODING_NONE;
+    config->snr_db = 10.0;
+    config->bit_rate = 1000.0;
+    config->bandwidth = 0.1;
+    config->seed = 0;
+    config->bandlimited_noise = 0;
+}
+
+awgn_status awgn_channel_create(const awgn_channel_config* config, awgn_channel** channel) {
+    if (!config || !channel) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null config or channel pointer");
+    }
+    if (config->size < CONFIG_V1_SIZE) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Config was not initialized with awgn_channel_config_init");
+    }
+    // Older callers pass a shorter struct: their fields over our defaults. Newer
+    // callers' extra fields are ignored.
+    awgn_channel_config settings;
+    awgn_channel_config_init(&settings);
+    std::memcpy(&settings, config, std::min(config->size, sizeof(awgn_channel_config)));
+    settings.size = sizeof(awgn_channel_config);
+    if (settings.modulation < AWGN_MODULATION_BPSK || settings.modulation > AWGN_MODULATION_QAM16 ||
+        settings.coding < AWGN_CODING_NONE || settings.coding > AWGN_CODING_TURBO) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Unknown modulation or coding");
+    }
+    *channel = nullptr;
+    return guarded([&] {
+        awgn_channel* created = new awgn_channel(settings);
+        if (settings.bandlimited_noise) {
+            try {
+                created->awgn.enableBandlimitedNoise();
+            } catch (...) {
+                delete created;
+                throw;
+            }
+        }
+        *channel = created;
+    });
+}
+
+void awgn_channel_destroy(awgn_channel* channel) {
+    delete channel;
+}
+
+awgn_status awgn_channel_set_snr_db(awgn_channel* channel, double snr_db) {
+    if (!channel) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null channel");
+    }
+    channel->awgn.setTargetSNRdB(snr_db);
+    return AWGN_OK;
+}
+
+awgn_status awgn_channel_set_seed(awgn_channel* channel, unsigned int seed) {
+    if (!channel) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null channel");
+    }
+    channel->awgn.setSeed(seed);
+    return AWGN_OK;
+}
+
+awgn_status awgn_add_noise(awgn_channel* channel, const double* in, size_t in_stride,
+                           double* out, size_t out_stride, size_t count) {
+    if (!channel || (count > 0 && (!in || !out)) || !validStrides(in_stride, out_stride)) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null pointer or zero stride");
+    }
+    if (count == 0) {
+        return AWGN_OK;
+    }
+    return guarded([&] {
+        channel->scratch.reset();
+        channel->awgn.addNoise(in, in_stride, out, out_stride, count, channel->scratch);
+    });
+}
+
+size_t awgn_modulated_length(const awgn_channel* channel, size_t num_bits) {
+    return channel ? channel->awgn.getChannelModel().modulatedLength(num_bits) : 0;
+}
+
+awgn_status awgn_modulate(awgn_channel* channel, const int* bits, size_t bits_stride, size_t num_bits,
+                          double* samples, size_t samples_stride, size_t capacity, size_t* written) {
+    if (!channel || !written || (num_bits > 0 && (!bits || !samples)) || !validStrides(bits_stride, samples_stride)) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null pointer or zero stride");
+    }
+    const ChannelModel& model = channel->awgn.getChannelModel();
+    if (capacity < model.modulatedLength(num_bits)) {
+        return fail(AWGN_ERROR_BUFFER_TOO_SMALL, "Sample buffer smaller than awgn_modulated_length()");
+    }
+    return guarded([&] {
+        Arena& scratch = channel->scratch;
+        scratch.reset();
+        const int* input = bits;
+        if (bits_stride != 1) {
+            int* gathered = scratch.allocate<int>(num_bits);
+            for (size_t i = 0; i < num_bits; ++i) {
+                gathered[i] = bits[i * bits_stride];
+            }
+            input = gathered;
+        }
+        double* output = samples_stride == 1 ? samples : scratch.allocate<double>(model.modulatedLength(num_bits));
+        size_t count = model.modulate(input, num_bits, output, scratch);
+        if (samples_stride != 1) {
+            for (size_t i = 0; i < count; ++i) {
+                samples[i * samples_stride] = output[i];
+            }
+        }
+        *written = count;
+    });
+}
+
+size_t awgn_demodulated_length(const awgn_channel* channel, size_t num_samples) {
+    return channel ? channel->awgn.getChannelModel().demodulatedLength(num_samples) : 0;
+}
+
+awgn_status awgn_demodulate(awgn_channel* channel, const double* samples, size_t samples_stride,
+                            size_t num_samples, int* bits, size_t bits_stride, size_t capacity,
+                            size_t* written) {
+    if (!channel || !written || (num_samples > 0 && (!samples || !bits)) || !validStrides(samples_stride, bits_stride)) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null pointer or zero stride");
+    }
+    const ChannelModel& model = channel->awgn.getChannelModel();
+    if (capacity < model.demodulatedLength(num_samples)) {
+        return fail(AWGN_ERROR_BUFFER_TOO_SMALL, "Bit buffer smaller than awgn_demodulated_length()");
+    }
+    return guarded([&] {
+        Arena& scratch = channel->scratch;
+        scratch.reset();
+        const double* input = samples;
+        if (samples_stride != 1) {
+            double* gathered = scratch.allocate<double>(num_samples);
+            for (size_t i = 0; i < num_samples; ++i) {
+                gathered[i] = samples[i * samples_stride];
+            }
+            input = gathered;
+        }
+        int* output = bits_stride == 1 ? bits : scratch.allocate<int>(model.demodulatedLength(num_samples));
+        size_t count = model.demodulate(input, num_samples, output, scratch);
+        if (bits_stride != 1) {
+            for (size_t i = 0; i < count; ++i) {
+                bits[i * bits_stride] = output[i];
+            }
+        }
+        *written = count;
+    });
+}
+
+awgn_status awgn_ebn0_db(const double* signal, size_t stride, size_t count, double snr_db,
+                         double bit_rate, double bandwidth, double* ebn0_db) {
+    if (!signal || !ebn0_db || stride == 0 || count == 0) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null pointer, zero stride or empty signal");
+    }
+    return guarded([&] {
+        *ebn0_db = SignalToNoiseRatio(snr_db, bit_rate, bandwidth).calculateEbN0(signal, count, stride);
+    });
+}
+
+awgn_status awgn_measure_snr_db(const double* original, size_t original_stride, const double* noisy,
+                                size_t noisy_stride, size_t count, double* snr_db) {
+    if (!original || !noisy || !snr_db || !validStrides(original_stride, noisy_stride) || count == 0) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null pointer, zero stride or empty signal");
+    }
+    return guarded([&] {
+        *snr_db = Analyzer().computeSNR(original, original_stride, noisy, noisy_stride, count);
+    });
+}
+
+awgn_status awgn_zero_crossings(const double* signal, size_t stride, size_t count, size_t* points,
+                                size_t capacity, size_t* found) {
+    if ((count > 0 && !signal) || (capacity > 0 && !points) || !found || stride == 0) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null pointer or zero stride");
+    }
+    return guarded([&] {
+        *found = Analyzer().computeZeroCrossingPoints(signal, count, stride, points, capacity);
+    });
+}
+
+awgn_status awgn_sine_wave(double* out, size_t stride, size_t count, double amplitude, double frequency) {
+    if ((count > 0 && !out) || stride == 0) {
+        return fail(AWGN_ERROR_INVALID_ARGUMENT, "Null pointer or zero stride");
+    }
+    return guarded([&] {
+        SignalGenerator(count, amplitude, frequency).generateSineWave(out, stride);
+    });
+}
+
+} // extern "C"
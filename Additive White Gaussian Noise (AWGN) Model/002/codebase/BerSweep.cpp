@@ -0,0 +1,156 @@
+#include "BerSweep.hpp"
+#include "BerTheory.hpp"
+#include "CpuDispatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+double SweepPoint::getBER() const {
+    return bits > 0 ? static_cast<double>(errors) / bits : 0.0;
+}
+
+void SweepPoint::getConfidenceInterval(double& low, double& high) const {
+    if (bits == 0) {
+        low = 0.0;
+        high = 1.0;
+        return;
+    }
+    const double z = 1.959964; // Two-sided 95%
+    const double n = static_cast<double>(bits);
+    const double p = static_cast<double>(errors) / n;
+    const double denominator = 1.0 + z * z / n;
+    const double center = (p + z * z / (2.0 * n)) / denominator;
+    const double half = z * std::sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denominator;
+    low = std::max(0.0, center - half);
+    high = std::min(1.0, center + half);
+}
+
+BerSweep::BerSweep(const SweepConfig& config, std::shared_ptr<NoiseCache> cache)
+    : config_(config), noiseCache_(std::move(cache)),
+      awgn_(0.0, config.bitRate, config.bandwidth, config.modulation, config.coding, config.seed) {
+    if (config_.bitsPerFrame == 0) {
+        throw std::invalid_argument("Frames must carry at least one bit");
+    }
+    if (config_.bandlimitedNoise) {
+        awgn_.enableBandlimitedNoise();
+    }
+    if (awgn_.getChannelModel().supportsPuncturing()) {
+        awgn_.getChannelModel().setCodeRate(config_.codeRate);
+    }
+    if (config_.samplesPerSymbol > 1) {
+        awgn_.getChannelModel().setPulseShaping(config_.rolloff, config_.samplesPerSymbol);
+    }
+    awgn_.setNoiseCache(noiseCache_);
+    if (config_.equalizerTaps > 0) {
+        if (config_.samplesPerSymbol > 1) {
+            throw std::invalid_argument("The equalizer is symbol spaced; it needs samplesPerSymbol 1");
+        }
+        equalizer_.reset(new LmsEqualizer(config_.modulation, config_.equalizerTaps, config_.equalizerStep,
+                                          config_.normalizedLms));
+    }
+    if (!config_.multipath.empty()) {
+        multipath_.reset(new MultipathChannel(config_.multipath, config_.multipathDoppler, config_.seed));
+    }
+}
+
+std::vector<SweepPoint> BerSweep::run(const std::vector<double>& snrPoints) {
+    std::vector<SweepPoint> points;
+    for (double snr : snrPoints) {
+        points.push_back(SweepPoint{snr, 0, 0});
+    }
+    runFrames(points, 0, config_.framesPerPoint);
+    return points;
+}
+
+void BerSweep::runFrames(std::vector<SweepPoint>& points, size_t firstFrame, size_t numFrames) {
+    const ChannelModel& channel = awgn_.getChannelModel();
+    const DspKernels& dsp = CpuDispatch::kernels();
+    const size_t numBits = config_.bitsPerFrame;
+
+    for (size_t f = firstFrame; f < firstFrame + numFrames; ++f) {
+        unsigned int frameSeed = config_.seed + static_cast<unsigned int>(f);
+        context_.beginRun();
+        Arena& scratch = context_.getArena();
+
+        std::mt19937 gen(frameSeed);
+        std::uniform_int_distribution<> bitDist(0, 1);
+        int* bits = context_.allocate<int>(numBits);
+        for (size_t i = 0; i < numBits; ++i) {
+            bits[i] = bitDist(gen);
+        }
+        double* signal = context_.allocate<double>(channel.modulatedLength(numBits));
+        size_t signalLength = channel.modulate(bits, numBits, signal, scratch);
+        int* decoded = context_.allocate<int>(channel.demodulatedLength(signalLength));
+
+        // The equalizer lags by `lag` values: its input gets that many trailing
+        // zeros, its reference as many leading ones (nothing was sent before the frame)
+        const size_t lag = equalizer_ ? equalizer_->getDelay() * (config_.modulation == BPSK ? 1 : 2) : 0;
+        double* reference = nullptr;
+        double* equalized = nullptr;
+        if (equalizer_) {
+            equalized = context_.allocate<double>(signalLength + lag);
+            reference = context_.allocate<double>(signalLength + lag);
+            std::fill(reference, reference + lag, 0.0);
+            std::copy(signal, signal + signalLength, reference + lag);
+        }
+        if (multipath_) {
+            // Static taps only need an empty delay line; fading taps restart from the frame seed
+            if (multipath_->isTimeVarying()) {
+                multipath_->reset(frameSeed);
+            } else {
+                multipath_->reset();
+            }
+            multipath_->apply(signal, signalLength, channel.getBitsPerSymbol(), scratch);
+        }
+        double* noisy = context_.allocate<double>(signalLength + lag);
+        std::fill(noisy + signalLength, noisy + signalLength + lag, 0.0);
+
+        awgn_.setSeed(frameSeed);
+        for (auto& point : points) {
+            awgn_.setTargetSNRdB(point.snrDb);
+            awgn_.addNoise(signal, signalLength, noisy, scratch);
+            const double* received = noisy;
+            if (equalizer_) {
+                equalizer_->reset();
+                equalizer_->setTraining(equalizer_->getDelay() + config_.trainingSymbols);
+                equalizer_->process(noisy, signalLength + lag, equalized, reference);
+                received = equalized + lag;
+            }
+            size_t decodedLength = channel.demodulate(received, signalLength, decoded, scratch);
+
+            size_t errors = dsp.countMismatches(bits, decoded, std::min(numBits, decodedLength));
+            point.bits += numBits;
+            point.errors += errors;
+        }
+    }
+}
+
+const SweepConfig& BerSweep::getConfig() const {
+    return config_;
+}
+
+const NoiseCache& BerSweep::getNoiseCache() const {
+    if (!noiseCache_) {
+        throw std::logic_error("Sweep has no noise cache");
+    }
+    return *noiseCache_;
+}
+
+bool BerSweep::hasClosedForm(const SweepConfig& config) {
+    return config.coding == NONE && !config.bandlimitedNoise && config.samplesPerSymbol <= 1 &&
+           config.multipath.empty() && config.equalizerTaps == 0;
+}
+
+std::vector<double> BerSweep::theoryBer(const SweepConfig& config, const std::vector<double>& snrPoints) {
+    if (!hasClosedForm(config)) {
+        throw std::invalid_argument("Sweep setup has no closed-form BER");
+    }
+    std::vector<double> ebN0(snrPoints.size());
+    for (size_t i = 0; i < snrPoints.size(); ++i) {
+        ebN0[i] = BerTheory::ebN0FromSnr(snrPoints[i], config.modulation);
+    }
+    std::vector<double> ber(snrPoints.size());
+    BerTheory::bitErrorRate(config.modulation, ebN0.data(), ebN0.size(), ber.data());
+    return ber;
+}
@@ -0,0 +1,76 @@
+#ifndef BER_SWEEP_HPP
+#define BER_SWEEP_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef> // For size_t
+#include "AWGN.hpp"
+#include "NoiseCache.hpp"
+#include "MultipathChannel.hpp"
+#include "LmsEqualizer.hpp"
+#include "SimulationContext.hpp"
+
+struct SweepPoint {
+    double snrDb;
+    size_t bits;
+    size_t errors;
+    double getBER() const;
+    // 95% Wilson score interval of the BER, meaningful even with few or no errors
+    void getConfidenceInterval(double& low, double& high) const;
+};
+
+struct SweepConfig {
+    ModulationType modulation = BPSK;
+    CodingType coding = NONE;
+    CodeRate codeRate = RATE_1_2; // Convolutional codes only
+    size_t bitsPerFrame = 1000;
+    size_t framesPerPoint = 1;
+    unsigned int seed = 0;   // Frame f uses seed + f for both its bits and its noise
+    double bitRate = 1000.0;
+    double bandwidth = 0.1;
+    bool bandlimitedNoise = false;
+    size_t samplesPerSymbol = 1; // 1 disables pulse shaping
+    double rolloff = 0.35;
+    std::vector<MultipathTap> multipath; // Empty for a flat channel
+    double multipathDoppler = 0.0;       // > 0 fades each tap, seeded per frame
+    size_t equalizerTaps = 0;            // 0 disables the LMS equalizer; needs samplesPerSymbol 1
+    double equalizerStep = 0.2;          // NLMS steps run from 0 to 2; plain LMS needs far smaller ones
+    bool normalizedLms = true;
+    size_t trainingSymbols = 100;        // Leading samples of each frame the equalizer trains on
+};
+
+// Headless BER-vs-SNR sweep. Each frame follows the Generate pipeline of the GUI
+// (seeded bits, modulation, AWGN, demodulation). Frames are the outer loop, so the
+// bits and modulated signal of a frame are built once and its unit noise comes
+// from the cache; every SNR point after the first only rescales it.
+//
+// With a multipath profile, each frame goes through the channel once before the
+// noise, and the SNR is measured at the receiver. The equalizer restarts on
+// every frame and point, trains on the frame's leading samples, then runs
+// decision directed; errors are counted over the whole frame.
+class BerSweep {
+private:
+    SweepConfig config_;
+    std::shared_ptr<NoiseCache> noiseCache_;
+    SimulationContext context_;
+    AWGN awgn_;
+    std::unique_ptr<MultipathChannel> multipath_; // Null for a flat channel
+    std::unique_ptr<LmsEqualizer> equalizer_;     // Null without equalization
+
+public:
+    explicit BerSweep(const SweepConfig& config, std::shared_ptr<NoiseCache> cache = std::make_shared<NoiseCache>());
+    std::vector<SweepPoint> run(const std::vector<double>& snrPoints);
+    // Adds the bit/error counts of frames [firstFrame, firstFrame + numFrames) to each point
+    void runFrames(std::vector<SweepPoint>& points, size_t firstFrame, size_t numFrames);
+    const SweepConfig& getConfig() const;
+    const NoiseCache& getNoiseCache() const;
+
+    // Setups whose BER BerTheory gives exactly: uncoded, white noise, no pulse
+    // shaping, no multipath. Shaped links lose a little to the truncated filters,
+    // and coded, bandlimited or multipath ones are not covered at all.
+    static bool hasClosedForm(const SweepConfig& config);
+    // Closed-form BER at each SNR point, without simulating; throws unless hasClosedForm
+    static std::vector<double> theoryBer(const SweepConfig& config, const std::vector<double>& snrPoints);
+};
+
+#endif // BER_SWEEP_HPP
@@ -0,0 +1,99 @@
+#include "BerTheory.hpp"
+#include <cmath>
+#include <stdexcept>
+#include "FastMath.hpp"
+
+namespace {
+    inline double tail(double x) {
+        return 0.5 * FastMath::erfc(x * 0.7071067811865476);
+    }
+
+    // sqrt(Eb/N0) from dB, without the sqrt call that keeps loops from vectorizing
+    inline double amplitude(double ebN0Db) {
+        return FastMath::exp(ebN0Db * (std::log(10.0) / 20.0));
+    }
+
+    // Per axis, 16-QAM is a Gray 4-PAM; x is half the level spacing over the
+    // noise deviation, sqrt(0.8 Eb/N0)
+    inline double qam16Amplitude(double ebN0Db) {
+        return std::sqrt(0.8) * amplitude(ebN0Db);
+    }
+}
+
+double BerTheory::q(double x) {
+    return tail(x);
+}
+
+void BerTheory::q(const double* x, size_t count, double* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = tail(x[i]);
+    }
+}
+
+double BerTheory::bitErrorRate(ModulationType mod, double ebN0Db) {
+    double ber;
+    bitErrorRate(mod, &ebN0Db, 1, &ber);
+    return ber;
+}
+
+void BerTheory::bitErrorRate(ModulationType mod, const double* ebN0Db, size_t count, double* out) {
+    switch (mod) {
+        case BPSK:
+        case QPSK:
+            // Q(sqrt(2 Eb/N0)); QPSK is two independent BPSK axes
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = tail(std::sqrt(2.0) * amplitude(ebN0Db[i]));
+            }
+            return;
+        case QAM16:
+            for (size_t i = 0; i < count; ++i) {
+                double x = qam16Amplitude(ebN0Db[i]);
+                out[i] = (3.0 * tail(x) + 2.0 * tail(3.0 * x) - tail(5.0 * x)) / 4.0;
+            }
+            return;
+        default: throw std::invalid_argument("Unsupported modulation type");
+    }
+}
+
+double BerTheory::symbolErrorRate(ModulationType mod, double ebN0Db) {
+    double ser;
+    symbolErrorRate(mod, &ebN0Db, 1, &ser);
+    return ser;
+}
+
+void BerTheory::symbolErrorRate(ModulationType mod, const double* ebN0Db, size_t count, double* out) {
+    switch (mod) {
+        case BPSK:
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = tail(std::sqrt(2.0) * amplitude(ebN0Db[i]));
+            }
+            return;
+        case QPSK:
+            // Either axis wrong: 1 - (1 - p)^2
+            for (size_t i = 0; i < count; ++i) {
+                double p = tail(std::sqrt(2.0) * amplitude(ebN0Db[i]));
+                out[i] = p * (2.0 - p);
+            }
+            return;
+        case QAM16:
+            // Per axis, the two inner levels err both ways: 2 (1 - 1/4) Q(x)
+            for (size_t i = 0; i < count; ++i) {
+                double p = 1.5 * tail(qam16Amplitude(ebN0Db[i]));
+                out[i] = p * (2.0 - p);
+            }
+            return;
+        default: throw std::invalid_argument("Unsupported modulation type");
+    }
+}
+
+double BerTheory::ebN0FromSnr(double snrDb, ModulationType mod, double codeRate, size_t samplesPerSymbol) {
+    // Eb/N0 = SNR * sps * (reals per symbol) / (2 * bits per symbol * rate)
+    double realsPerBit;
+    switch (mod) {
+        case BPSK: realsPerBit = 1.0; break;
+        case QPSK: realsPerBit = 1.0; break;
+        case QAM16: realsPerBit = 0.5; break;
+        default: throw std::invalid_argument("Unsupported modulation type");
+    }
+    return snrDb + 10.0 * std::log10(samplesPerSymbol * realsPerBit / (2.0 * codeRate));
+}
@@ -0,0 +1,29 @@
+#ifndef BER_THEORY_HPP
+#define BER_THEORY_HPP
+
+#include <cstddef> // For size_t
+#include "ChannelModel.hpp"
+
+// Closed-form AWGN error rates of the uncoded modulations, with the Gray
+// mappings of ChannelModel, and the Eb/N0 a simulator SNR corresponds to.
+// Eb/N0 is in dB. The array forms are branch-free loops over FastMath::erfc
+// that vectorize, for sweeps and plots that need many points; out may be the
+// input array.
+class BerTheory {
+public:
+    static double q(double x); // Gaussian tail probability P(N(0, 1) > x)
+    static void q(const double* x, size_t count, double* out);
+
+    static double bitErrorRate(ModulationType mod, double ebN0Db);
+    static void bitErrorRate(ModulationType mod, const double* ebN0Db, size_t count, double* out);
+    static double symbolErrorRate(ModulationType mod, double ebN0Db);
+    static void symbolErrorRate(ModulationType mod, const double* ebN0Db, size_t count, double* out);
+
+    // The SNR is per real sample against the measured signal power. The receiver
+    // uses I and Q once per symbol (16-QAM's repeated pair adds no energy to the
+    // decision), the matched filter gains samplesPerSymbol, and a code spends
+    // 1 / codeRate coded bits per data bit.
+    static double ebN0FromSnr(double snrDb, ModulationType mod, double codeRate = 1.0, size_t samplesPerSymbol = 1);
+};
+
+#endif // BER_THEORY_HPP
@@ -0,0 +1,158 @@
+#include "ChannelBatch.hpp"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "CpuDispatch.hpp"
+
+ChannelBatch::ChannelBatch(size_t numChannels, ModulationType mod, double snrDb, unsigned int seed)
+    : numChannels_(numChannels), modulation_(mod), snrDb_(numChannels, snrDb), seeds_(numChannels), frame_(0) {
+    if (numChannels == 0) {
+        throw std::invalid_argument("Number of channels must be greater than 0");
+    }
+    switch (mod) {
+        case BPSK: bitsPerSymbol_ = 1; break;
+        case QPSK: bitsPerSymbol_ = 2; break;
+        case QAM16: bitsPerSymbol_ = 4; break;
+        default: throw std::invalid_argument("Unsupported modulation type");
+    }
+    // Consecutive seeds by default, like the frames of a sweep
+    for (size_t c = 0; c < numChannels; ++c) {
+        seeds_[c] = static_cast<uint32_t>(seed + c);
+    }
+}
+
+void ChannelBatch::checkChannel(size_t channel) const {
+    if (channel >= numChannels_) {
+        throw std::invalid_argument("Channel index out of range");
+    }
+}
+
+size_t ChannelBatch::modulatedLength(size_t bitsPerChannel) const {
+    // Interleaved input leaves no room to pad a partial symbol, and dropping its bits would go unnoticed
+    if (bitsPerChannel % bitsPerSymbol_ != 0) {
+        throw std::invalid_argument("Bits per channel must be a multiple of the bits per symbol");
+    }
+    return bitsPerChannel;
+}
+
+size_t ChannelBatch::modulate(const int* bits, size_t bitsPerChannel, double* symbols) const {
+    const size_t length = modulatedLength(bitsPerChannel);
+    const DspKernels& dsp = CpuDispatch::kernels();
+    if (modulation_ == QAM16) {
+        // Same layout as ChannelModel: I, Q, I, Q per four bits
+        dsp.mapQam16(bits, length / 4, numChannels_, symbols);
+    } else {
+        // One bit per real value, so the interleaving does not matter
+        const double level = modulation_ == QPSK ? std::sqrt(2.0) / 2.0 : 1.0;
+        dsp.mapAntipodal(bits, length * numChannels_, level, symbols);
+    }
+    return length;
+}
+
+void ChannelBatch::addNoise(const double* signal, size_t samplesPerChannel, double* noisy, Arena& scratch) {
+    const size_t n = numChannels_;
+    if (samplesPerChannel == 0) {
+        ++frame_;
+        return;
+    }
+
+    // Per-channel noise standard deviation from the measured signal power
+    double* stdDev = scratch.allocate<double>(n);
+    for (size_t c = 0; c < n; ++c) {
+        stdDev[c] = 0.0;
+    }
+    for (size_t i = 0; i < samplesPerChannel; ++i) {
+        const double* row = signal + i * n;
+        for (size_t c = 0; c < n; ++c) {
+            stdDev[c] += row[c] * row[c];
+        }
+    }
+    for (size_t c = 0; c < n; ++c) {
+        double signalPower = stdDev[c] / samplesPerChannel;
+        stdDev[c] = std::sqrt(signalPower / std::pow(10.0, snrDb_[c] / 10.0));
+    }
+
+    // Philox counter per sample pair: (pair low, frame low, frame high, pair high)
+    const DspKernels& dsp = CpuDispatch::kernels();
+    const size_t pairs = samplesPerChannel / 2;
+    for (size_t p = 0; p < pairs; ++p) {
+        const double* in0 = signal + 2 * p * n;
+        double* out0 = noisy + 2 * p * n;
+        dsp.addPhiloxNoise(seeds_.data(), stdDev, n, p, frame_, in0, in0 + n, out0, out0 + n);
+    }
+    if (samplesPerChannel % 2) {
+        dsp.addPhiloxNoise(seeds_.data(), stdDev, n, pairs, frame_, signal + 2 * pairs * n, nullptr,
+                           noisy + 2 * pairs * n, nullptr);
+    }
+    ++frame_;
+}
+
+size_t ChannelBatch::demodulate(const double* symbols, size_t samplesPerChannel, int* bits) const {
+    const size_t length = modulatedLength(samplesPerChannel);
+    const DspKernels& dsp = CpuDispatch::kernels();
+    if (modulation_ == QAM16) {
+        dsp.demapQam16Hard(symbols, length / 4, numChannels_, bits);
+    } else {
+        dsp.demapHard(symbols, length * numChannels_, bits);
+    }
+    return length;
+}
+
+size_t ChannelBatch::demapSoft(const double* symbols, size_t samplesPerChannel, double* llrs) const {
+    const size_t length = modulatedLength(samplesPerChannel);
+    if (modulation_ == QAM16) {
+        // Max-log LLRs in units of the level spacing, as in ChannelModel::demapSoft
+        CpuDispatch::kernels().demapQam16Soft(symbols, length / 4, numChannels_, llrs);
+    } else {
+        std::memcpy(llrs, symbols, length * numChannels_ * sizeof(double));
+    }
+    return length;
+}
+
+void ChannelBatch::countErrors(const int* bits, const int* decoded, size_t bitsPerChannel, size_t* errors) const {
+    const size_t n = numChannels_;
+    const DspKernels& dsp = CpuDispatch::kernels();
+    for (size_t i = 0; i < bitsPerChannel; ++i) {
+        dsp.addMismatches(bits + i * n, decoded + i * n, n, errors);
+    }
+}
+
+size_t ChannelBatch::getNumChannels() const {
+    return numChannels_;
+}
+
+ModulationType ChannelBatch::getModulation() const {
+    return modulation_;
+}
+
+size_t ChannelBatch::getBitsPerSymbol() const {
+    return bitsPerSymbol_;
+}
+
+void ChannelBatch::setSnrDb(size_t channel, double snrDb) {
+    checkChannel(channel);
+    snrDb_[channel] = snrDb;
+}
+
+double ChannelBatch::getSnrDb(size_t channel) const {
+    checkChannel(channel);
+    return snrDb_[channel];
+}
+
+void ChannelBatch::setSeed(size_t channel, unsigned int seed) {
+    checkChannel(channel);
+    seeds_[channel] = seed;
+}
+
+unsigned int ChannelBatch::getSeed(size_t channel) const {
+    checkChannel(channel);
+    return seeds_[channel];
+}
+
+void ChannelBatch::setFrame(uint64_t frame) {
+    frame_ = frame;
+}
+
+uint64_t ChannelBatch::getFrame() const {
+    return frame_;
+}
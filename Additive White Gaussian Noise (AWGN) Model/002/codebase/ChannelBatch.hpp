@@ -0,0 +1,72 @@
+#ifndef CHANNEL_BATCH_HPP
+#define CHANNEL_BATCH_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "ChannelModel.hpp"
+#include "Arena.hpp"
+
+// N independent uncoded links simulated together. Buffers are channel-interleaved:
+// value i of channel c is at [i * N + c], so every inner loop runs across the
+// channels with the same operation in every lane and short frames still fill
+// whole vector registers.
+//
+// Each channel has its own SNR and seed. Noise is drawn from Philox4x32-10 keyed by
+// the seed and counted by (frame, sample pair), so a channel's noise depends only on
+// its seed and the frame number, not on its position in the batch or on N.
+// Noise power follows AWGN: signalPower / 10^(SNR_dB/10), measured per channel.
+class ChannelBatch {
+private:
+    size_t numChannels_;
+    ModulationType modulation_;
+    size_t bitsPerSymbol_;
+    std::vector<double> snrDb_;
+    std::vector<uint32_t> seeds_;
+    uint64_t frame_; // Philox counter words 1-2; advanced by every addNoise()
+
+    void checkChannel(size_t channel) const;
+
+public:
+    ChannelBatch(size_t numChannels, ModulationType mod, double snrDb = 10.0, unsigned int seed = 0);
+
+    // Per-channel lengths are in values (bits or reals) of one channel. Unlike
+    // ChannelModel, which pads, bitsPerChannel must be a whole number of symbols
+    // (1, 2 or 4 bits); other counts throw std::invalid_argument.
+    size_t modulatedLength(size_t bitsPerChannel) const;
+    size_t modulate(const int* bits, size_t bitsPerChannel, double* symbols) const;
+    // noisy may alias signal; adds fresh noise for the current frame, then advances it
+    void addNoise(const double* signal, size_t samplesPerChannel, double* noisy, Arena& scratch);
+    size_t demodulate(const double* symbols, size_t samplesPerChannel, int* bits) const;
+    size_t demapSoft(const double* symbols, size_t samplesPerChannel, double* llrs) const; // Positive favours 1
+    // errors[c] += bit errors of channel c over the first bitsPerChannel values
+    void countErrors(const int* bits, const int* decoded, size_t bitsPerChannel, size_t* errors) const;
+
+    // Copy one channel between the interleaved layout and a contiguous buffer
+    template <typename T>
+    void gather(const T* batch, size_t channel, size_t length, T* out) const {
+        checkChannel(channel);
+        for (size_t i = 0; i < length; ++i) {
+            out[i] = batch[i * numChannels_ + channel];
+        }
+    }
+    template <typename T>
+    void scatter(const T* in, size_t channel, size_t length, T* batch) const {
+        checkChannel(channel);
+        for (size_t i = 0; i < length; ++i) {
+            batch[i * numChannels_ + channel] = in[i];
+        }
+    }
+
+    size_t getNumChannels() const;
+    ModulationType getModulation() const;
+    size_t getBitsPerSymbol() const;
+    void setSnrDb(size_t channel, double snrDb);
+    double getSnrDb(size_t channel) const;
+    void setSeed(size_t channel, unsigned int seed);
+    unsigned int getSeed(size_t channel) const;
+    void setFrame(uint64_t frame); // Replays the noise of an earlier frame
+    uint64_t getFrame() const;
+};
+
+#endif // CHANNEL_BATCH_HPP
@@ -0,0 +1,21 @@
+#ifndef CHANNEL_CODEC_HPP
+#define CHANNEL_CODEC_HPP
+
+#include <cstddef> // For size_t
+#include "Arena.hpp"
+
+// Forward error correction as seen by ChannelModel. encode() writes coded bits
+// into caller-owned storage sized with encodedLength(); decode() takes one soft
+// value per coded bit, positive meaning "1", and writes the decided
+// information bits. Work buffers come from `scratch`.
+class ChannelCodec {
+public:
+    virtual ~ChannelCodec() = default;
+    virtual size_t encode(const int* bits, size_t numBits, int* encoded, Arena& scratch) const = 0;
+    virtual size_t decode(const double* llrs, size_t numLlrs, int* bits, Arena& scratch) const = 0;
+    virtual size_t encodedLength(size_t numBits) const = 0;
+    virtual size_t decodedLength(size_t numLlrs) const = 0;
+    virtual double getRate() const = 0; // Nominal, ignoring termination and block padding
+};
+
+#endif // CHANNEL_CODEC_HPP
@@ -1,8 +1,10 @@
 #include "ChannelModel.hpp"
+#include <algorithm>
 #include <cmath>
 #include <random>
 #include <stdexcept>
 #include "Common.hpp"
+#include "CpuDispatch.hpp"
 
 ChannelModel::ChannelModel(ModulationType mod, CodingType code)
     : modulation_(mod), coding_(code), codeRate_(1.0) {
@@ -12,131 +14,223 @@ ChannelModel::ChannelModel(ModulationType mod, CodingType code)
         case QAM16: bitsPerSymbol_ = 4; break;
         default: throw std::invalid_argument("Unsupported modulation type");
     }
-    if (coding_ == CONVOLUTIONAL) {
-        codeRate_ = 0.5; // 1/2 rate convolutional code
+    switch (coding_) {
+        case NONE: break;
+        case CONVOLUTIONAL: codec_ = std::make_shared<ConvolutionalCode<3, 07, 05>>(); break;
+        case CONVOLUTIONAL_K7: codec_ = std::make_shared<ConvolutionalCode<7, 0171, 0133>>(); break;
+        case LDPC: codec_ = std::make_shared<LdpcCode>(LdpcCode::ieee80211nRate12()); break;
+        case TURBO: codec_ = std::make_shared<TurboCode>(TurboCode::lte(1024)); break;
+        default: throw std::invalid_argument("Unsupported coding type");
+    }
+    if (codec_) {
+        codeRate_ = codec_->getRate();
     }
 }
 
-std::vector<int> ChannelModel::encodeConvolutional(const std::vector<int>& bits) {
-    // Simple 1/2 rate convolutional encoder (generator polynomials: 7, 5 in octal)
-    std::vector<int> encoded;
-    int state = 0;
-    for (size_t i = 0; i < bits.size(); ++i) {
-        int input = bits[i];
-        encoded.push_back((input ^ ((state >> 1) & 1) ^ (state & 1)) & 1);
-        encoded.push_back((input ^ (state & 1)) & 1);
-        state = ((state >> 1) | (input << 2)) & 7;
-    }
-    return encoded;
+size_t ChannelModel::modulateBPSK(const int* bits, size_t numBits, double* symbols) const {
+    CpuDispatch::kernels().mapAntipodal(bits, numBits, 1.0, symbols);
+    return numBits;
 }
 
-std::vector<int> ChannelModel::decodeConvolutional(const std::vector<double>& softBits) {
-    // Simplified Viterbi decoder for 1/2 rate code
-    std::vector<int> decoded;
-    // For simplicity, convert soft bits to hard bits (threshold at 0)
-    for (size_t i = 0; i < softBits.size(); i += 2) {
-        int b1 = softBits[i] > 0 ? 1 : 0;
-        int b2 = softBits[i + 1] > 0 ? 1 : 0;
-        // Basic decoding: assume b1^b2 gives original bit (simplified)
-        decoded.push_back(b1 ^ b2);
-    }
-    return decoded;
+size_t ChannelModel::modulateQPSK(const int* bits, size_t numBits, double* symbols) const {
+    const size_t count = numBits / 2 * 2; // Ensure even number
+    // I and Q interleaved, one bit each
+    CpuDispatch::kernels().mapAntipodal(bits, count, std::sqrt(2.0) / 2.0, symbols);
+    return count;
 }
 
-std::vector<double> ChannelModel::modulateBPSK(const std::vector<int>& bits) {
-    std::vector<double> symbols(bits.size());
-    for (size_t i = 0; i < bits.size(); ++i) {
-        symbols[i] = bits[i] ? 1.0 : -1.0;
-    }
-    return symbols;
+size_t ChannelModel::modulateQAM16(const int* bits, size_t numBits, double* symbols) const {
+    const size_t count = numBits / 4 * 4; // Ensure multiple of 4
+    // I, Q, then both again for compatibility, at unit average power
+    CpuDispatch::kernels().mapQam16(bits, count / 4, 1, symbols);
+    return count;
+}
+
+size_t ChannelModel::demodulateBPSK(const double* symbols, size_t numSymbols, int* bits) const {
+    CpuDispatch::kernels().demapHard(symbols, numSymbols, bits);
+    return numSymbols;
 }
 
-std::vector<double> ChannelModel::modulateQPSK(const std::vector<int>& bits) {
-    std::vector<double> symbols(bits.size() / 2 * 2); // Ensure even number
-    const double scale = std::sqrt(2.0) / 2.0;
-    for (size_t i = 0; i < bits.size() - 1; i += 2) {
-        double I = bits[i] ? scale : -scale;
-        double Q = bits[i + 1] ? scale : -scale;
-        symbols[i] = I;     // Real part
-        symbols[i + 1] = Q; // Imaginary part
+size_t ChannelModel::demodulateQPSK(const double* symbols, size_t numSymbols, int* bits) const {
+    const size_t count = numSymbols / 2 * 2;
+    CpuDispatch::kernels().demapHard(symbols, count, bits);
+    std::fill(bits + count, bits + numSymbols, 0);
+    return numSymbols;
+}
+
+size_t ChannelModel::demodulateQAM16(const double* symbols, size_t numSymbols, int* bits) const {
+    // Gray levels per axis: 00 -> -3, 01 -> -1, 11 -> +1, 10 -> +3
+    const size_t count = numSymbols / 4 * 4;
+    CpuDispatch::kernels().demapQam16Hard(symbols, count / 4, 1, bits);
+    std::fill(bits + count, bits + numSymbols, 0);
+    return numSymbols;
+}
+
+size_t ChannelModel::demapSoft(const double* symbols, size_t numSymbols, double* llrs) const {
+    switch (modulation_) {
+        case BPSK:
+        case QPSK:
+            // Each real component carries one bit, sign is the decision
+            std::copy(symbols, symbols + numSymbols, llrs);
+            break;
+        case QAM16: {
+            // Max-log LLRs for the Gray levels above, in units of the level spacing
+            const size_t count = numSymbols / 4 * 4;
+            CpuDispatch::kernels().demapQam16Soft(symbols, count / 4, 1, llrs);
+            std::fill(llrs + count, llrs + numSymbols, 0.0);
+            break;
+        }
+        default: throw std::invalid_argument("Unsupported modulation type");
     }
-    return symbols;
+    return numSymbols;
+}
+
+size_t ChannelModel::mappedLength(size_t numCodedBits) const {
+    return numCodedBits / bitsPerSymbol_ * bitsPerSymbol_;
 }
 
-std::vector<double> ChannelModel::modulateQAM16(const std::vector<int>& bits) {
-    std::vector<double> symbols(bits.size() / 4 * 4); // Ensure multiple of 4
-    const double scale = std::sqrt(10.0); // Normalize power
-    for (size_t i = 0; i < bits.size() - 3; i += 4) {
-        int I_bits = bits[i] * 2 + bits[i + 1];
-        int Q_bits = bits[i + 2] * 2 + bits[i + 3];
-        double I = (I_bits == 0 ? -3.0 : I_bits == 1 ? -1.0 : I_bits == 2 ? 3.0 : 1.0) / scale;
-        double Q = (Q_bits == 0 ? -3.0 : Q_bits == 1 ? -1.0 : Q_bits == 2 ? 3.0 : 1.0) / scale;
-        symbols[i] = I;
-        symbols[i + 1] = Q;
-        symbols[i + 2] = I; // Duplicate for compatibility
-        symbols[i + 3] = Q;
+size_t ChannelModel::encodedLength(size_t numBits) const {
+    if (!codec_) {
+        return numBits;
+    }
+    // Coded bits are punctured, then zero-padded to whole symbols
+    size_t coded = codec_->encodedLength(numBits);
+    if (puncturer_) {
+        coded = puncturer_->puncturedLength(coded);
     }
-    return symbols;
+    return (coded + bitsPerSymbol_ - 1) / bitsPerSymbol_ * bitsPerSymbol_;
+}
+
+size_t ChannelModel::modulatedLength(size_t numBits) const {
+    return mapLength(encodedLength(numBits));
 }
 
-std::vector<int> ChannelModel::demodulateBPSK(const std::vector<double>& symbols) {
-    std::vector<int> bits(symbols.size());
-    for (size_t i = 0; i < symbols.size(); ++i) {
-        bits[i] = symbols[i] > 0 ? 1 : 0;
+size_t ChannelModel::mapLength(size_t numCodedBits) const {
+    size_t numSymbols = mappedLength(numCodedBits);
+    return pulseShaper_ ? pulseShaper_->shapedLength(numSymbols / bitsPerSymbol_) * bitsPerSymbol_ : numSymbols;
+}
+
+size_t ChannelModel::demodulatedLength(size_t numSamples) const {
+    size_t numSymbols = pulseShaper_ ? pulseShaper_->matchedLength(numSamples, bitsPerSymbol_) : numSamples;
+    if (!codec_) {
+        return numSymbols;
     }
-    return bits;
+    return codec_->decodedLength(puncturer_ ? puncturer_->depuncturedLength(numSymbols) : numSymbols);
 }
 
-std::vector<int> ChannelModel::demodulateQPSK(const std::vector<double>& symbols) {
-    std::vector<int> bits(symbols.size());
-    for (size_t i = 0; i < symbols.size() - 1; i += 2) {
-        bits[i] = symbols[i] > 0 ? 1 : 0;
-        bits[i + 1] = symbols[i + 1] > 0 ? 1 : 0;
+size_t ChannelModel::encode(const int* bits, size_t numBits, int* encoded, Arena& scratch) const {
+    if (!codec_) {
+        std::copy(bits, bits + numBits, encoded);
+        return numBits;
     }
-    return bits;
+    size_t coded = 0;
+    if (puncturer_) {
+        int* mother = scratch.allocate<int>(codec_->encodedLength(numBits));
+        coded = puncturer_->puncture(mother, codec_->encode(bits, numBits, mother, scratch), encoded);
+    } else {
+        coded = codec_->encode(bits, numBits, encoded, scratch);
+    }
+    size_t padded = encodedLength(numBits);
+    std::fill(encoded + coded, encoded + padded, 0);
+    return padded;
 }
 
-std::vector<int> ChannelModel::demodulateQAM16(const std::vector<double>& symbols) {
-    std::vector<int> bits(symbols.size());
-    const double scale = std::sqrt(10.0);
-    for (size_t i = 0; i < symbols.size() - 3; i += 4) {
-        double I = symbols[i] * scale;
-        double Q = symbols[i + 1] * scale;
-        bits[i] = (I > 0) ? (I > 2 ? 1 : 0) : (I < -2 ? 0 : 1);
-        bits[i + 1] = (I > 0) ? (I > 2 ? 0 : 1) : (I < -2 ? 1 : 0);
-        bits[i + 2] = (Q > 0) ? (Q > 2 ? 1 : 0) : (Q < -2 ? 0 : 1);
-        bits[i + 3] = (Q > 0) ? (Q > 2 ? 0 : 1) : (Q < -2 ? 1 : 0);
+size_t ChannelModel::modulate(const int* bits, size_t numBits, double* samples, Arena& scratch) const {
+    if (coding_ == NONE) {
+        return map(bits, numBits, samples, scratch);
     }
-    return bits;
+    int* encoded = scratch.allocate<int>(encodedLength(numBits));
+    size_t numEncoded = encode(bits, numBits, encoded, scratch);
+    return map(encoded, numEncoded, samples, scratch);
 }
 
-std::vector<double> ChannelModel::modulate(const std::vector<int>& bits) {
-    std::vector<int> encodedBits = (coding_ == CONVOLUTIONAL) ? encodeConvolutional(bits) : bits;
+size_t ChannelModel::map(const int* encodedBits, size_t numEncoded, double* samples, Arena& scratch) const {
+    // Map straight into the output unless the pulse shaper still has to run
+    double* symbols = pulseShaper_ ? scratch.allocate<double>(mappedLength(numEncoded)) : samples;
+    size_t numSymbols = 0;
     switch (modulation_) {
-        case BPSK: return modulateBPSK(encodedBits);
-        case QPSK: return modulateQPSK(encodedBits);
-        case QAM16: return modulateQAM16(encodedBits);
+        case BPSK: numSymbols = modulateBPSK(encodedBits, numEncoded, symbols); break;
+        case QPSK: numSymbols = modulateQPSK(encodedBits, numEncoded, symbols); break;
+        case QAM16: numSymbols = modulateQAM16(encodedBits, numEncoded, symbols); break;
         default: throw std::invalid_argument("Unsupported modulation type");
     }
+    if (!pulseShaper_) {
+        return numSymbols;
+    }
+    // Each of the bitsPerSymbol_ interleaved components is shaped as its own stream
+    pulseShaper_->shape(symbols, numSymbols / bitsPerSymbol_, bitsPerSymbol_, samples);
+    return pulseShaper_->shapedLength(numSymbols / bitsPerSymbol_) * bitsPerSymbol_;
+}
+
+size_t ChannelModel::receiveFilter(const double* samples, size_t numSamples, const double*& symbols, Arena& scratch) const {
+    if (!pulseShaper_) {
+        symbols = samples;
+        return numSamples;
+    }
+    double* filtered = scratch.allocate<double>(pulseShaper_->matchedLength(numSamples, bitsPerSymbol_));
+    symbols = filtered;
+    return pulseShaper_->matchedFilter(samples, numSamples, bitsPerSymbol_, filtered);
 }
 
-std::vector<int> ChannelModel::demodulate(const std::vector<double>& symbols) {
-    std::vector<int> bits;
+size_t ChannelModel::receiveWaveform(const double* samples, size_t numSamples, double* waveform) const {
+    if (!pulseShaper_) {
+        numSamples = numSamples / bitsPerSymbol_ * bitsPerSymbol_;
+        std::copy(samples, samples + numSamples, waveform);
+        return numSamples;
+    }
+    return pulseShaper_->matchedWaveform(samples, numSamples, bitsPerSymbol_, waveform);
+}
+
+size_t ChannelModel::receivedWaveformLength(size_t numSamples) const {
+    return pulseShaper_ ? pulseShaper_->matchedWaveformLength(numSamples, bitsPerSymbol_)
+                        : numSamples / bitsPerSymbol_ * bitsPerSymbol_;
+}
+
+size_t ChannelModel::demodulate(const double* samples, size_t numSamples, int* bits, Arena& scratch) const {
+    const double* symbols = nullptr;
+    size_t numSymbols = receiveFilter(samples, numSamples, symbols, scratch);
+    if (codec_) {
+        // Padding zeros decode as extra tail steps, so the padded length is fine here
+        double* llrs = scratch.allocate<double>(numSymbols);
+        size_t numLlrs = demapSoft(symbols, numSymbols, llrs);
+        if (puncturer_) {
+            double* depunctured = scratch.allocate<double>(puncturer_->depuncturedLength(numLlrs));
+            numLlrs = puncturer_->depuncture(llrs, numLlrs, depunctured);
+            llrs = depunctured;
+        }
+        return codec_->decode(llrs, numLlrs, bits, scratch);
+    }
     switch (modulation_) {
-        case BPSK: bits = demodulateBPSK(symbols); break;
-        case QPSK: bits = demodulateQPSK(symbols); break;
-        case QAM16: bits = demodulateQAM16(symbols); break;
+        case BPSK: return demodulateBPSK(symbols, numSymbols, bits);
+        case QPSK: return demodulateQPSK(symbols, numSymbols, bits);
+        case QAM16: return demodulateQAM16(symbols, numSymbols, bits);
         default: throw std::invalid_argument("Unsupported modulation type");
     }
-    return (coding_ == CONVOLUTIONAL) ? decodeConvolutional(symbols) : bits;
 }
 
-std::vector<int> ChannelModel::encode(const std::vector<int>& bits) {
-    return (coding_ == CONVOLUTIONAL) ? encodeConvolutional(bits) : bits;
+std::vector<double> ChannelModel::modulate(const std::vector<int>& bits) const {
+    Arena scratch;
+    std::vector<double> samples(modulatedLength(bits.size()));
+    samples.resize(modulate(bits.data(), bits.size(), samples.data(), scratch));
+    return samples;
+}
+
+std::vector<int> ChannelModel::demodulate(const std::vector<double>& samples) const {
+    Arena scratch;
+    std::vector<int> bits(demodulatedLength(samples.size()));
+    bits.resize(demodulate(samples.data(), samples.size(), bits.data(), scratch));
+    return bits;
 }
 
-std::vector<int> ChannelModel::decode(const std::vector<double>& softBits) {
-    return (coding_ == CONVOLUTIONAL) ? decodeConvolutional(softBits) : demodulate(softBits);
+std::vector<int> ChannelModel::encode(const std::vector<int>& bits) const {
+    Arena scratch;
+    std::vector<int> encoded(encodedLength(bits.size()));
+    encode(bits.data(), bits.size(), encoded.data(), scratch);
+    return encoded;
+}
+
+std::vector<int> ChannelModel::decode(const std::vector<double>& softBits) const {
+    return demodulate(softBits);
 }
 
 size_t ChannelModel::getBitsPerSymbol() const {
@@ -145,4 +239,38 @@ size_t ChannelModel::getBitsPerSymbol() const {
 
 double ChannelModel::getCodeRate() const {
     return codeRate_;
-}
\ No newline at end of file
+}
+
+const ChannelCodec* ChannelModel::getCodec() const {
+    return codec_.get();
+}
+
+bool ChannelModel::supportsPuncturing() const {
+    return coding_ == CONVOLUTIONAL || coding_ == CONVOLUTIONAL_K7;
+}
+
+void ChannelModel::setCodeRate(CodeRate rate) {
+    if (rate == RATE_1_2) {
+        puncturer_.reset();
+        codeRate_ = codec_ ? codec_->getRate() : 1.0;
+        return;
+    }
+    if (!supportsPuncturing()) {
+        throw std::invalid_argument("Puncturing needs a rate 1/2 convolutional code");
+    }
+    puncturer_ = std::make_shared<Puncturer>(Puncturer::forRate(rate));
+    // Input bits per period over coded bits kept per period
+    codeRate_ = static_cast<double>(puncturer_->getPeriod() / 2) / puncturer_->getKeptPerPeriod();
+}
+
+void ChannelModel::setPulseShaping(double rolloff, size_t samplesPerSymbol, size_t spanSymbols) {
+    pulseShaper_ = std::make_shared<PulseShaper>(rolloff, samplesPerSymbol, spanSymbols);
+}
+
+void ChannelModel::disablePulseShaping() {
+    pulseShaper_.reset();
+}
+
+size_t ChannelModel::getSamplesPerSymbol() const {
+    return pulseShaper_ ? pulseShaper_->getSamplesPerSymbol() : 1;
+}
@@ -3,10 +3,19 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include "SignalToNoiseRatio.hpp"
+#include "PulseShaper.hpp"
+#include "ConvolutionalCode.hpp"
+#include "LdpcCode.hpp"
+#include "TurboCode.hpp"
+#include "Puncturer.hpp"
+#include "Arena.hpp"
 
 enum ModulationType { BPSK, QPSK, QAM16 };
-enum CodingType { NONE, CONVOLUTIONAL }; // Turbo and LDPC as future extensions
+// CONVOLUTIONAL is K=3 (7,5), CONVOLUTIONAL_K7 the K=7 (171,133) code, LDPC the 802.11n
+// rate 1/2 n=648 code, TURBO the LTE rate 1/3 code with a 1024-bit QPP interleaver
+enum CodingType { NONE, CONVOLUTIONAL, CONVOLUTIONAL_K7, LDPC, TURBO };
 
 class ChannelModel {
 private:
@@ -14,23 +23,53 @@ private:
     CodingType coding_;
     size_t bitsPerSymbol_;
     double codeRate_;
-    std::vector<int> encodeConvolutional(const std::vector<int>& bits);
-    std::vector<int> decodeConvolutional(const std::vector<double>& softBits);
-    std::vector<double> modulateBPSK(const std::vector<int>& bits);
-    std::vector<double> modulateQPSK(const std::vector<int>& bits);
-    std::vector<double> modulateQAM16(const std::vector<int>& bits);
-    std::vector<int> demodulateBPSK(const std::vector<double>& symbols);
-    std::vector<int> demodulateQPSK(const std::vector<double>& symbols);
-    std::vector<int> demodulateQAM16(const std::vector<double>& symbols);
+    std::shared_ptr<const PulseShaper> pulseShaper_; // Null for one sample per symbol
+    std::shared_ptr<const ChannelCodec> codec_;      // Null when uncoded
+    std::shared_ptr<const Puncturer> puncturer_;     // Null for the mother rate
+    size_t modulateBPSK(const int* bits, size_t numBits, double* symbols) const;
+    size_t modulateQPSK(const int* bits, size_t numBits, double* symbols) const;
+    size_t modulateQAM16(const int* bits, size_t numBits, double* symbols) const;
+    size_t demodulateBPSK(const double* symbols, size_t numSymbols, int* bits) const;
+    size_t demodulateQPSK(const double* symbols, size_t numSymbols, int* bits) const;
+    size_t demodulateQAM16(const double* symbols, size_t numSymbols, int* bits) const;
+    size_t mappedLength(size_t numCodedBits) const;
+    size_t receiveFilter(const double* samples, size_t numSamples, const double*& symbols, Arena& scratch) const;
 
 public:
     ChannelModel(ModulationType mod, CodingType code = NONE);
-    std::vector<double> modulate(const std::vector<int>& bits);
-    std::vector<int> demodulate(const std::vector<double>& symbols);
-    std::vector<int> encode(const std::vector<int>& bits);
-    std::vector<int> decode(const std::vector<double>& softBits);
+    std::vector<double> modulate(const std::vector<int>& bits) const;
+    std::vector<int> demodulate(const std::vector<double>& samples) const;
+    std::vector<int> encode(const std::vector<int>& bits) const;
+    std::vector<int> decode(const std::vector<double>& softBits) const;
+
+    // Buffer variants: the caller owns the output (sized with the *Length queries)
+    // and intermediate buffers come from `scratch`, so no heap allocation happens
+    // once the arena is warm. Each returns the number of values written.
+    size_t modulate(const int* bits, size_t numBits, double* samples, Arena& scratch) const;
+    size_t demodulate(const double* samples, size_t numSamples, int* bits, Arena& scratch) const;
+    size_t encode(const int* bits, size_t numBits, int* encoded, Arena& scratch) const;
+    // One soft value per coded bit from received symbols, positive meaning "1"
+    size_t demapSoft(const double* symbols, size_t numSymbols, double* llrs) const;
+    // Symbol mapping and pulse shaping of already-encoded bits (modulate = encode + map)
+    size_t map(const int* encodedBits, size_t numEncoded, double* samples, Arena& scratch) const;
+    size_t encodedLength(size_t numBits) const;
+    size_t mapLength(size_t numCodedBits) const;
+    size_t modulatedLength(size_t numBits) const;
+    size_t demodulatedLength(size_t numSamples) const;
+    // Receive filtering alone, for constellation and eye plots: every matched-filter
+    // output sample in the modulate() layout, symbol n at sample n * getSamplesPerSymbol().
+    // Without pulse shaping this is a copy.
+    size_t receiveWaveform(const double* samples, size_t numSamples, double* waveform) const;
+    size_t receivedWaveformLength(size_t numSamples) const;
+
     size_t getBitsPerSymbol() const;
     double getCodeRate() const;
+    const ChannelCodec* getCodec() const;
+    bool supportsPuncturing() const; // True for the rate 1/2 convolutional codes
+    void setCodeRate(CodeRate rate); // Punctures the rate 1/2 code; RATE_1_2 turns puncturing off
+    void setPulseShaping(double rolloff, size_t samplesPerSymbol, size_t spanSymbols = 8);
+    void disablePulseShaping();
+    size_t getSamplesPerSymbol() const;
 };
 
-#endif // CHANNEL_MODEL_HPP
\ No newline at end of file
+#endif // CHANNEL_MODEL_HPP
@@ -0,0 +1,242 @@
+#ifndef CONVOLUTIONAL_CODE_HPP
+#define CONVOLUTIONAL_CODE_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "ChannelCodec.hpp"
+#include "CpuDispatch.hpp"
+
+enum Termination {
+    ZERO_TAIL,  // K-1 zero bits flush the encoder back to state 0
+    TAIL_BITING // Encoder starts in the state it ends in; no rate loss
+};
+
+// Rate 1/N convolutional code. Coded bits are emitted step by step (N per
+// input bit); decode() runs a soft-decision Viterbi search.
+class ConvolutionalCodec : public ChannelCodec {
+public:
+    virtual size_t getConstraintLength() const = 0;
+    virtual size_t getOutputsPerBit() const = 0;
+    virtual Termination getTermination() const = 0;
+};
+
+// Generators are given in the usual octal form, most significant bit tapping
+// the current input: ConvolutionalCode<7, 0171, 0133> is the K=7 industry code.
+// The state holds the previous K-1 inputs, newest in bit K-2.
+template <unsigned K, unsigned... Generators>
+class ConvolutionalCode : public ConvolutionalCodec {
+    static_assert(K >= 3 && K <= 9, "Constraint length must be between 3 and 9");
+    static_assert(sizeof...(Generators) >= 2 && sizeof...(Generators) <= 8, "Rate 1/N needs 2 to 8 generators");
+
+public:
+    static constexpr unsigned N = sizeof...(Generators);
+    static constexpr unsigned NUM_STATES = 1u << (K - 1);
+
+private:
+    Termination termination_;
+
+    // Output pattern (bit j = generator j) for register value (input << (K-1)) | state
+    static const std::vector<uint8_t>& outputTable() {
+        static const std::vector<uint8_t> table = [] {
+            const unsigned generators[N] = {Generators...};
+            std::vector<uint8_t> t(1u << K);
+            for (unsigned r = 0; r < (1u << K); ++r) {
+                unsigned pattern = 0;
+                for (unsigned j = 0; j < N; ++j) {
+                    unsigned taps = r & generators[j];
+                    unsigned parity = 0;
+                    while (taps) {
+                        parity ^= taps & 1;
+                        taps >>= 1;
+                    }
+                    pattern |= parity << j;
+                }
+                t[r] = static_cast<uint8_t>(pattern);
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    // All 8N coded bits for one input byte (bit k = input k) from each state,
+    // packed in emission order
+    static const std::vector<uint64_t>& byteTable() {
+        static const std::vector<uint64_t> table = [] {
+            const std::vector<uint8_t>& outputs = outputTable();
+            std::vector<uint64_t> t(NUM_STATES * 256);
+            for (unsigned s = 0; s < NUM_STATES; ++s) {
+                for (unsigned byte = 0; byte < 256; ++byte) {
+                    uint64_t packed = 0;
+                    unsigned state = s;
+                    for (unsigned k = 0; k < 8; ++k) {
+                        unsigned r = (((byte >> k) & 1u) << (K - 1)) | state;
+                        packed |= static_cast<uint64_t>(outputs[r]) << (k * N);
+                        state = r >> 1;
+                    }
+                    t[(s << 8) | byte] = packed;
+                }
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    static unsigned encodeBit(unsigned& state, int bit, int* out) {
+        unsigned r = (static_cast<unsigned>(bit & 1) << (K - 1)) | state;
+        unsigned pattern = outputTable()[r];
+        for (unsigned j = 0; j < N; ++j) {
+            out[j] = (pattern >> j) & 1;
+        }
+        state = r >> 1;
+        return state;
+    }
+
+    // Viterbi over steps [0, numSteps) of `llrs`, which are read at step index
+    // (first + t) mod period so the tail-biting decoder can wrap around.
+    // Writes the input decision of every step to `decisions`.
+    void viterbi(const double* llrs, size_t period, size_t first, size_t numSteps,
+                 bool knownStart, bool knownEnd, int* decisions, Arena& scratch) const {
+        const std::vector<uint8_t>& outputs = outputTable();
+        const DspKernels& dsp = CpuDispatch::kernels();
+        const size_t words = (NUM_STATES + 63) / 64;
+        uint64_t* survivors = scratch.allocate<uint64_t>(numSteps * words);
+        double* metric = scratch.allocate<double>(NUM_STATES);
+        double* next = scratch.allocate<double>(NUM_STATES);
+        const double lost = -std::numeric_limits<double>::infinity();
+        for (unsigned s = 0; s < NUM_STATES; ++s) {
+            metric[s] = (knownStart && s != 0) ? lost : 0.0;
+        }
+
+        double branch[1u << N];
+        for (size_t t = 0; t < numSteps; ++t) {
+            // Correlation metric of each output pattern against this step's soft values
+            const double* l = llrs + ((first + t) % period) * N;
+            for (unsigned p = 0; p < (1u << N); ++p) {
+                double m = 0.0;
+                for (unsigned j = 0; j < N; ++j) {
+                    m += ((p >> j) & 1) ? l[j] : -l[j];
+                }
+                branch[p] = m;
+            }
+
+            // Add-compare-select: state u is reached from (2u) mod S and (2u + 1) mod S
+            dsp.viterbiAcs(metric, branch, outputs.data(), NUM_STATES, next, survivors + t * words);
+            std::swap(metric, next);
+
+            // Keep metrics near zero on long blocks
+            if ((t & 1023) == 1023) {
+                double best = *std::max_element(metric, metric + NUM_STATES);
+                for (unsigned s = 0; s < NUM_STATES; ++s) {
+                    metric[s] -= best;
+                }
+            }
+        }
+
+        unsigned state = knownEnd ? 0 : static_cast<unsigned>(std::max_element(metric, metric + NUM_STATES) - metric);
+        for (size_t t = numSteps; t-- > 0;) {
+            const uint64_t* decision = survivors + t * words;
+            decisions[t] = static_cast<int>(state >> (K - 2));
+            unsigned pick = (decision[state >> 6] >> (state & 63)) & 1;
+            state = ((state << 1) & (NUM_STATES - 1)) | pick;
+        }
+    }
+
+public:
+    explicit ConvolutionalCode(Termination termination = ZERO_TAIL) : termination_(termination) {}
+
+    size_t encode(const int* bits, size_t numBits, int* encoded, Arena&) const override {
+        if (termination_ == TAIL_BITING && numBits < K - 1) {
+            throw std::invalid_argument("Tail-biting needs at least K-1 input bits");
+        }
+        // Tail-biting starts from the state the last K-1 inputs leave behind
+        unsigned state = 0;
+        if (termination_ == TAIL_BITING) {
+            for (size_t i = numBits - (K - 1); i < numBits; ++i) {
+                state = ((static_cast<unsigned>(bits[i] & 1) << (K - 1)) | state) >> 1;
+            }
+        }
+
+        // Eight inputs per table lookup
+        const std::vector<uint64_t>& table = byteTable();
+        size_t i = 0;
+        int* out = encoded;
+        for (; i + 8 <= numBits; i += 8) {
+            unsigned byte = 0;
+            for (unsigned k = 0; k < 8; ++k) {
+                byte |= static_cast<unsigned>(bits[i + k] & 1) << k;
+            }
+            uint64_t packed = table[(state << 8) | byte];
+            for (unsigned m = 0; m < 8 * N; ++m) {
+                out[m] = static_cast<int>((packed >> m) & 1);
+            }
+            out += 8 * N;
+            state = ((byte << (K - 1)) | state) >> 8;
+        }
+        for (; i < numBits; ++i, out += N) {
+            encodeBit(state, bits[i], out);
+        }
+        if (termination_ == ZERO_TAIL) {
+            for (unsigned k = 0; k + 1 < K; ++k, out += N) {
+                encodeBit(state, 0, out);
+            }
+        }
+        return static_cast<size_t>(out - encoded);
+    }
+
+    size_t decode(const double* llrs, size_t numLlrs, int* bits, Arena& scratch) const override {
+        const size_t numBits = decodedLength(numLlrs);
+        if (numBits == 0) {
+            return 0;
+        }
+        if (termination_ == ZERO_TAIL) {
+            const size_t numSteps = numBits + K - 1;
+            int* decisions = scratch.allocate<int>(numSteps);
+            viterbi(llrs, numSteps, 0, numSteps, true, true, decisions, scratch);
+            std::copy(decisions, decisions + numBits, bits);
+            return numBits;
+        }
+
+        // Tail-biting: decode the block with wrapped copies of its ends on both
+        // sides, so the search settles before and after the part that is kept
+        const size_t wrap = std::min<size_t>(numBits, 6 * K);
+        const size_t numSteps = numBits + 2 * wrap;
+        int* decisions = scratch.allocate<int>(numSteps);
+        viterbi(llrs, numBits, numBits - wrap, numSteps, false, false, decisions, scratch);
+        std::copy(decisions + wrap, decisions + wrap + numBits, bits);
+        return numBits;
+    }
+
+    size_t encodedLength(size_t numBits) const override {
+        return N * (termination_ == ZERO_TAIL ? numBits + K - 1 : numBits);
+    }
+
+    size_t decodedLength(size_t numLlrs) const override {
+        size_t steps = numLlrs / N;
+        if (termination_ == TAIL_BITING) {
+            return steps;
+        }
+        return steps > K - 1 ? steps - (K - 1) : 0;
+    }
+
+    double getRate() const override {
+        return 1.0 / N;
+    }
+
+    size_t getConstraintLength() const override {
+        return K;
+    }
+
+    size_t getOutputsPerBit() const override {
+        return N;
+    }
+
+    Termination getTermination() const override {
+        return termination_;
+    }
+};
+
+#endif // CONVOLUTIONAL_CODE_HPP
@@ -0,0 +1,83 @@
+#include "CpuDispatch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+std::atomic<const DspKernels*> bound(nullptr);
+
+// AWGN_ISA if set, else the best the CPU supports
+const DspKernels* startupKernels() {
+    IsaLevel level = CpuDispatch::detectIsaLevel();
+    const char* forced = std::getenv("AWGN_ISA");
+    if (forced && *forced) {
+        level = std::min(level, CpuDispatch::parseIsaLevel(forced));
+    }
+    return &DspKernels::forLevel(level);
+}
+
+} // namespace
+
+IsaLevel CpuDispatch::detectIsaLevel() {
+    static const IsaLevel detected = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        // __builtin_cpu_supports also checks that the OS saves the wide registers
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+            __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("bmi2")) {
+            return ISA_AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")) {
+            return ISA_AVX2;
+        }
+        if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+            return ISA_SSE42;
+        }
+#endif
+        return ISA_BASELINE;
+    }();
+    return detected;
+}
+
+IsaLevel CpuDispatch::getIsaLevel() {
+    return kernels().level;
+}
+
+IsaLevel CpuDispatch::setIsaLevel(IsaLevel level) {
+    const DspKernels& table = DspKernels::forLevel(std::min(level, detectIsaLevel()));
+    bound.store(&table, std::memory_order_release);
+    return table.level;
+}
+
+const DspKernels& CpuDispatch::kernels() {
+    const DspKernels* table = bound.load(std::memory_order_acquire);
+    if (!table) {
+        // An explicit setIsaLevel() that got in first wins over the startup choice
+        const DspKernels* startup = startupKernels();
+        bound.compare_exchange_strong(table, startup, std::memory_order_acq_rel);
+        table = bound.load(std::memory_order_acquire);
+    }
+    return *table;
+}
+
+const char* CpuDispatch::isaName(IsaLevel level) {
+    switch (level) {
+        case ISA_BASELINE: return "baseline";
+        case ISA_SSE42: return "sse4.2";
+        case ISA_AVX2: return "avx2";
+        case ISA_AVX512: return "avx512";
+        default: return "unknown";
+    }
+}
+
+IsaLevel CpuDispatch::parseIsaLevel(const std::string& name) {
+    for (IsaLevel level : {ISA_BASELINE, ISA_SSE42, ISA_AVX2, ISA_AVX512}) {
+        if (name == isaName(level)) {
+            return level;
+        }
+    }
+    throw std::invalid_argument("Unknown ISA level: " + name + " (baseline, sse4.2, avx2 or avx512)");
+}
@@ -0,0 +1,28 @@
+#ifndef CPU_DISPATCH_HPP
+#define CPU_DISPATCH_HPP
+
+#include <string>
+#include "DspKernels.hpp"
+
+// Binds the DspKernels variant for the running CPU. The first kernels() call
+// detects the CPU and binds the best level it supports, unless the AWGN_ISA
+// environment variable (baseline, sse4.2, avx2, avx512) or an earlier
+// setIsaLevel() asks for a lower one.
+//
+// Every level gives bit-identical results: the wider variants run more lanes at
+// a time but keep the same operation order and never fuse multiply-adds. Forcing
+// a level is for benchmarking; a sweep merged from workers on different CPUs
+// matches one run on a single machine either way.
+class CpuDispatch {
+public:
+    static IsaLevel detectIsaLevel(); // Best level the CPU and OS support
+    static IsaLevel getIsaLevel();    // Level of the bound kernels
+    // Binds min(level, detectIsaLevel()) and returns it. Call while no kernels are running.
+    static IsaLevel setIsaLevel(IsaLevel level);
+    static const DspKernels& kernels();
+
+    static const char* isaName(IsaLevel level);
+    static IsaLevel parseIsaLevel(const std::string& name); // Throws std::invalid_argument
+};
+
+#endif // CPU_DISPATCH_HPP
@@ -0,0 +1,523 @@
+#include "DspKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "FastMath.hpp"
+
+// Each kernel body is written once, force-inlined into a wrapper per level, and
+// compiled there with that level's instruction set. Build with -O3 -fno-math-errno.
+
+// AVX-512 brings its own FMA; fused multiply-adds round differently, and the
+// levels must match each other bit for bit
+#pragma GCC optimize("fp-contract=off")
+
+#define DSP_INLINE inline __attribute__((always_inline))
+
+namespace {
+
+// Two standard normals by Box-Muller from one Philox4x32-10 block.
+// u1 takes 52 bits from words 0-1 (tails out to 8.5 sigma), the angle takes word 2.
+DSP_INLINE void normalPair(uint32_t key, uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, double& z0,
+                           double& z1) {
+    uint32_t k0 = key;
+    uint32_t k1 = 0;
+#pragma GCC unroll 10
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+        uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+        c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        c1 = static_cast<uint32_t>(p1);
+        c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c3 = static_cast<uint32_t>(p0);
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+
+    uint64_t mantissa = (static_cast<uint64_t>(c0) << 20) | (c1 >> 12);
+    double u1 = 2.0 - FastMath::fromBits(0x3FF0000000000000ULL | mantissa); // (0, 1]
+    double radius = std::sqrt(-2.0 * FastMath::logPositive(u1));
+
+    double sine, cosine;
+    FastMath::sinCosTurn(static_cast<uint64_t>(c2) << 32, sine, cosine);
+    z0 = radius * cosine;
+    z1 = radius * sine;
+}
+
+// Gray levels per axis: 00 -> -3, 01 -> -1, 11 -> +1, 10 -> +3, over sqrt(10)
+DSP_INLINE double qam16Level(int msb, int lsb) {
+    const double inner = 1.0 / std::sqrt(10.0);
+    const double outer = 3.0 / std::sqrt(10.0);
+    return msb ? (lsb ? inner : outer) : (lsb ? -inner : -outer);
+}
+
+DSP_INLINE void scaleAddBody(const double* signal, const double* noise, double scale, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = signal[i] + scale * noise[i];
+    }
+}
+
+DSP_INLINE void addPhiloxNoiseBody(const uint32_t* keys, const double* stdDev, size_t n, uint64_t pair,
+                                   uint64_t frame, const double* in0, const double* in1, double* out0,
+                                   double* out1) {
+    const uint32_t pairLow = static_cast<uint32_t>(pair);
+    const uint32_t pairHigh = static_cast<uint32_t>(pair >> 32);
+    const uint32_t frameLow = static_cast<uint32_t>(frame);
+    const uint32_t frameHigh = static_cast<uint32_t>(frame >> 32);
+    if (out1) {
+        for (size_t c = 0; c < n; ++c) {
+            double z0, z1;
+            normalPair(keys[c], pairLow, frameLow, frameHigh, pairHigh, z0, z1);
+            out0[c] = in0[c] + stdDev[c] * z0;
+            out1[c] = in1[c] + stdDev[c] * z1;
+        }
+    } else {
+        for (size_t c = 0; c < n; ++c) {
+            double z0, z1;
+            normalPair(keys[c], pairLow, frameLow, frameHigh, pairHigh, z0, z1);
+            out0[c] = in0[c] + stdDev[c] * z0;
+        }
+    }
+}
+
+DSP_INLINE void mapAntipodalBody(const int* bits, size_t n, double level, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = bits[i] ? level : -level;
+    }
+}
+
+DSP_INLINE void mapQam16Body(const int* __restrict bits, size_t numSymbols, size_t width, double* __restrict out) {
+    if (width == 1) {
+        for (size_t s = 0; s < numSymbols; ++s) {
+            const int* b = bits + 4 * s;
+            double I = qam16Level(b[0], b[1]);
+            double Q = qam16Level(b[2], b[3]);
+            out[4 * s] = I;
+            out[4 * s + 1] = Q;
+            out[4 * s + 2] = I;
+            out[4 * s + 3] = Q;
+        }
+        return;
+    }
+    for (size_t s = 0; s < numSymbols; ++s) {
+        const int* b = bits + 4 * s * width;
+        double* o = out + 4 * s * width;
+        for (size_t c = 0; c < width; ++c) {
+            double I = qam16Level(b[c], b[width + c]);
+            double Q = qam16Level(b[2 * width + c], b[3 * width + c]);
+            o[c] = I;
+            o[width + c] = Q;
+            o[2 * width + c] = I;
+            o[3 * width + c] = Q;
+        }
+    }
+}
+
+DSP_INLINE void demapHardBody(const double* values, size_t n, int* bits) {
+    for (size_t i = 0; i < n; ++i) {
+        bits[i] = values[i] > 0 ? 1 : 0;
+    }
+}
+
+DSP_INLINE void demapQam16HardBody(const double* __restrict values, size_t numSymbols, size_t width,
+                                   int* __restrict bits) {
+    const double scale = std::sqrt(10.0);
+    if (width == 1) {
+        for (size_t s = 0; s < numSymbols; ++s) {
+            double I = values[4 * s] * scale;
+            double Q = values[4 * s + 1] * scale;
+            bits[4 * s] = I > 0 ? 1 : 0;
+            bits[4 * s + 1] = std::fabs(I) < 2 ? 1 : 0;
+            bits[4 * s + 2] = Q > 0 ? 1 : 0;
+            bits[4 * s + 3] = std::fabs(Q) < 2 ? 1 : 0;
+        }
+        return;
+    }
+    for (size_t s = 0; s < numSymbols; ++s) {
+        const double* in = values + 4 * s * width;
+        int* b = bits + 4 * s * width;
+        for (size_t c = 0; c < width; ++c) {
+            double I = in[c] * scale;
+            double Q = in[width + c] * scale;
+            b[c] = I > 0 ? 1 : 0;
+            b[width + c] = std::fabs(I) < 2 ? 1 : 0;
+            b[2 * width + c] = Q > 0 ? 1 : 0;
+            b[3 * width + c] = std::fabs(Q) < 2 ? 1 : 0;
+        }
+    }
+}
+
+DSP_INLINE void demapQam16SoftBody(const double* __restrict values, size_t numSymbols, size_t width,
+                                   double* __restrict llrs) {
+    // Max-log LLRs in units of the level spacing
+    const double scale = std::sqrt(10.0);
+    if (width == 1) {
+        for (size_t s = 0; s < numSymbols; ++s) {
+            double I = values[4 * s] * scale;
+            double Q = values[4 * s + 1] * scale;
+            llrs[4 * s] = I;
+            llrs[4 * s + 1] = 2.0 - std::fabs(I);
+            llrs[4 * s + 2] = Q;
+            llrs[4 * s + 3] = 2.0 - std::fabs(Q);
+        }
+        return;
+    }
+    for (size_t s = 0; s < numSymbols; ++s) {
+        const double* in = values + 4 * s * width;
+        double* out = llrs + 4 * s * width;
+        for (size_t c = 0; c < width; ++c) {
+            double I = in[c] * scale;
+            double Q = in[width + c] * scale;
+            out[c] = I;
+            out[width + c] = 2.0 - std::fabs(I);
+            out[2 * width + c] = Q;
+            out[3 * width + c] = 2.0 - std::fabs(Q);
+        }
+    }
+}
+
+DSP_INLINE void viterbiAcsBody(const double* __restrict metric, const double* __restrict branch,
+                               const uint8_t* __restrict outputs, size_t numStates, double* __restrict next,
+                               uint64_t* __restrict decision) {
+    // States u and u + S/2 share the predecessors 2u mod S and 2u mod S + 1, so
+    // both halves read the metrics in order
+    const size_t half = numStates / 2;
+    uint8_t picks[256];
+    for (size_t h = 0; h < 2; ++h) {
+        const uint8_t* out = outputs + h * numStates;
+        for (size_t v = 0; v < half; ++v) {
+            double m0 = metric[2 * v] + branch[out[2 * v]];
+            double m1 = metric[2 * v + 1] + branch[out[2 * v + 1]];
+            next[h * half + v] = m1 > m0 ? m1 : m0;
+            picks[h * half + v] = m1 > m0;
+        }
+    }
+    for (size_t w = 0; 64 * w < numStates; ++w) {
+        const size_t count = std::min<size_t>(64, numStates - 64 * w);
+        uint64_t word = 0;
+        for (size_t j = 0; j < count; ++j) {
+            word |= static_cast<uint64_t>(picks[64 * w + j]) << j;
+        }
+        decision[w] = word;
+    }
+}
+
+// Sums run in 16 fixed lanes, combined pairwise, so every level adds in the same
+// order. The lane loops stay rolled so GCC vectorizes them, not the outer loop.
+DSP_INLINE double sumLanes(const double* lanes) {
+    double sum[8];
+    for (size_t j = 0; j < 8; ++j) {
+        sum[j] = lanes[j] + lanes[j + 8];
+    }
+    return ((sum[0] + sum[4]) + (sum[2] + sum[6])) + ((sum[1] + sum[5]) + (sum[3] + sum[7]));
+}
+
+DSP_INLINE double sumSquaresBody(const double* x, size_t n) {
+    double lanes[16] = {};
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+#pragma GCC unroll 1
+        for (size_t j = 0; j < 16; ++j) {
+            lanes[j] += x[i + j] * x[i + j];
+        }
+    }
+    double sum = sumLanes(lanes);
+    for (; i < n; ++i) {
+        sum += x[i] * x[i];
+    }
+    return sum;
+}
+
+DSP_INLINE void sumSquaresAndErrorBody(const double* x, const double* y, size_t n, double& xx, double& ee) {
+    double signal[16] = {};
+    double error[16] = {};
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+#pragma GCC unroll 1
+        for (size_t j = 0; j < 16; ++j) {
+            double e = y[i + j] - x[i + j];
+            signal[j] += x[i + j] * x[i + j];
+            error[j] += e * e;
+        }
+    }
+    xx = sumLanes(signal);
+    ee = sumLanes(error);
+    for (; i < n; ++i) {
+        double e = y[i] - x[i];
+        xx += x[i] * x[i];
+        ee += e * e;
+    }
+}
+
+DSP_INLINE void powerSumsBody(const double* x, size_t n, double* sums) {
+    double s1[16] = {}, s2[16] = {}, s3[16] = {}, s4[16] = {};
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+#pragma GCC unroll 1
+        for (size_t j = 0; j < 16; ++j) {
+            double v = x[i + j];
+            double v2 = v * v;
+            s1[j] += v;
+            s2[j] += v2;
+            s3[j] += v2 * v;
+            s4[j] += v2 * v2;
+        }
+    }
+    sums[0] = sumLanes(s1);
+    sums[1] = sumLanes(s2);
+    sums[2] = sumLanes(s3);
+    sums[3] = sumLanes(s4);
+    for (; i < n; ++i) {
+        double v2 = x[i] * x[i];
+        sums[0] += x[i];
+        sums[1] += v2;
+        sums[2] += v2 * x[i];
+        sums[3] += v2 * v2;
+    }
+}
+
+DSP_INLINE void lagProductsBody(const double* x, size_t n, size_t maxLag, double* sums) {
+    for (size_t lag = 1; lag <= maxLag; ++lag) {
+        const double* y = x + maxLag - lag;
+        const double* z = x + maxLag;
+        double lanes[16] = {};
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+#pragma GCC unroll 1
+            for (size_t j = 0; j < 16; ++j) {
+                lanes[j] += z[i + j] * y[i + j];
+            }
+        }
+        double sum = sumLanes(lanes);
+        for (; i < n; ++i) {
+            sum += z[i] * y[i];
+        }
+        sums[lag - 1] = sum;
+    }
+}
+
+// Clamping before the conversion keeps the index in range. The top clamp goes
+// first: NaN fails its comparison, so it lands in the last bin
+DSP_INLINE void binIndicesBody(const double* __restrict x, size_t n, double scale, double offset, uint32_t last,
+                               uint32_t* __restrict index) {
+    const double top = static_cast<double>(last);
+    for (size_t i = 0; i < n; ++i) {
+        double v = x[i] * scale + offset;
+        v = v < top ? v : top;
+        v = v > 0.0 ? v : 0.0;
+        index[i] = static_cast<uint32_t>(static_cast<int32_t>(v));
+    }
+}
+
+DSP_INLINE size_t countMismatchesBody(const int* a, const int* b, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += a[i] != b[i];
+    }
+    return count;
+}
+
+DSP_INLINE void addMismatchesBody(const int* a, const int* b, size_t n, size_t* counts) {
+    for (size_t i = 0; i < n; ++i) {
+        counts[i] += a[i] != b[i];
+    }
+}
+
+template <IsaLevel Level>
+DSP_INLINE size_t zeroCrossingsBody(const double* x, size_t count, size_t* points, size_t capacity) {
+    size_t found = 0;
+    if (Level == ISA_BASELINE) {
+        // SSE2 cannot narrow double compares to flag bytes; a plain scan is faster there
+        for (size_t i = 1; i < count; ++i) {
+            if ((x[i - 1] < 0 && x[i] >= 0) || (x[i - 1] > 0 && x[i] <= 0)) {
+                if (found < capacity) points[found] = i;
+                ++found;
+            }
+        }
+        return found;
+    }
+    // Flags for 64 samples at a time, then only the flagged ones are visited,
+    // eight flag bytes per word
+    uint8_t flags[64];
+    for (size_t start = 1; start < count; start += 64) {
+        const size_t block = std::min<size_t>(64, count - start);
+        for (size_t j = 0; j < block; ++j) {
+            double previous = x[start + j - 1];
+            double current = x[start + j];
+            flags[j] = ((previous < 0) & (current >= 0)) | ((previous > 0) & (current <= 0));
+        }
+        std::fill(flags + block, flags + 64, 0);
+        for (size_t j = 0; j < 64; j += 8) {
+            uint64_t word;
+            std::memcpy(&word, flags + j, sizeof(word));
+            for (; word; word &= word - 1) {
+                if (found < capacity) points[found] = start + j + __builtin_ctzll(word) / 8;
+                ++found;
+            }
+        }
+    }
+    return found;
+}
+
+DSP_INLINE void addTapBody(const double* __restrict xI, const double* __restrict xQ, double gI, double gQ,
+                           size_t n, double* __restrict yI, double* __restrict yQ) {
+    if (!xQ) {
+        for (size_t i = 0; i < n; ++i) {
+            yI[i] += gI * xI[i];
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        yI[i] += gI * xI[i] - gQ * xQ[i];
+        yQ[i] += gI * xQ[i] + gQ * xI[i];
+    }
+}
+
+DSP_INLINE void addFadingTapBody(const double* __restrict xI, const double* __restrict xQ,
+                                 const double* __restrict gI, const double* __restrict gQ, size_t n,
+                                 double* __restrict yI, double* __restrict yQ) {
+    if (!xQ) {
+        for (size_t i = 0; i < n; ++i) {
+            yI[i] += gI[i] * xI[i];
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        yI[i] += gI[i] * xI[i] - gQ[i] * xQ[i];
+        yQ[i] += gI[i] * xQ[i] + gQ[i] * xI[i];
+    }
+}
+
+DSP_INLINE void philoxNormalsBody(uint32_t key, uint64_t pair, size_t numPairs, double* __restrict out) {
+    for (size_t k = 0; k < numPairs; ++k) {
+        uint64_t p = pair + k;
+        normalPair(key, static_cast<uint32_t>(p), 0, 0, static_cast<uint32_t>(p >> 32), out[2 * k], out[2 * k + 1]);
+    }
+}
+
+DSP_INLINE void sinCosTableBody(const uint64_t* __restrict phase, size_t n, double* __restrict cosine,
+                                double* __restrict sine) {
+    for (size_t i = 0; i < n; ++i) {
+        FastMath::sinCosTurn(phase[i], sine[i], cosine[i]);
+    }
+}
+
+} // namespace
+
+// One wrapper per kernel; expanded once per level under that level's target,
+// in a namespace that defines LEVEL
+#define DSP_KERNEL_WRAPPERS                                                                                    \
+    void scaleAdd(const double* signal, const double* noise, double scale, double* out, size_t n) {            \
+        scaleAddBody(signal, noise, scale, out, n);                                                             \
+    }                                                                                                           \
+    void addPhiloxNoise(const uint32_t* keys, const double* stdDev, size_t n, uint64_t pair, uint64_t frame,   \
+                        const double* in0, const double* in1, double* out0, double* out1) {                    \
+        addPhiloxNoiseBody(keys, stdDev, n, pair, frame, in0, in1, out0, out1);                                 \
+    }                                                                                                           \
+    void mapAntipodal(const int* bits, size_t n, double level, double* out) {                                  \
+        mapAntipodalBody(bits, n, level, out);                                                                  \
+    }                                                                                                           \
+    void mapQam16(const int* bits, size_t numSymbols, size_t width, double* out) {                             \
+        mapQam16Body(bits, numSymbols, width, out);                                                             \
+    }                                                                                                           \
+    void demapHard(const double* values, size_t n, int* bits) {                                                \
+        demapHardBody(values, n, bits);                                                                         \
+    }                                                                                                           \
+    void demapQam16Hard(const double* values, size_t numSymbols, size_t width, int* bits) {                    \
+        demapQam16HardBody(values, numSymbols, width, bits);                                                    \
+    }                                                                                                           \
+    void demapQam16Soft(const double* values, size_t numSymbols, size_t width, double* llrs) {                 \
+        demapQam16SoftBody(values, numSymbols, width, llrs);                                                    \
+    }                                                                                                           \
+    void viterbiAcs(const double* metric, const double* branch, const uint8_t* outputs, size_t numStates,      \
+                    double* next, uint64_t* decision) {                                                        \
+        viterbiAcsBody(metric, branch, outputs, numStates, next, decision);                                     \
+    }                                                                                                           \
+    double sumSquares(const double* x, size_t n) {                                                             \
+        return sumSquaresBody(x, n);                                                                            \
+    }                                                                                                           \
+    void sumSquaresAndError(const double* x, const double* y, size_t n, double& xx, double& ee) {              \
+        sumSquaresAndErrorBody(x, y, n, xx, ee);                                                                \
+    }                                                                                                           \
+    size_t countMismatches(const int* a, const int* b, size_t n) {                                             \
+        return countMismatchesBody(a, b, n);                                                                    \
+    }                                                                                                           \
+    void addMismatches(const int* a, const int* b, size_t n, size_t* counts) {                                 \
+        addMismatchesBody(a, b, n, counts);                                                                     \
+    }                                                                                                           \
+    size_t zeroCrossings(const double* x, size_t count, size_t* points, size_t capacity) {                     \
+        return zeroCrossingsBody<LEVEL>(x, count, points, capacity);                                                   \
+    }                                                                                                           \
+    void addTap(const double* xI, const double* xQ, double gI, double gQ, size_t n, double* yI, double* yQ) {  \
+        addTapBody(xI, xQ, gI, gQ, n, yI, yQ);                                                                  \
+    }                                                                                                           \
+    void addFadingTap(const double* xI, const double* xQ, const double* gI, const double* gQ, size_t n,        \
+                      double* yI, double* yQ) {                                                                \
+        addFadingTapBody(xI, xQ, gI, gQ, n, yI, yQ);                                                            \
+    }                                                                                                           \
+    void powerSums(const double* x, size_t n, double* sums) {                                                  \
+        powerSumsBody(x, n, sums);                                                                              \
+    }                                                                                                           \
+    void lagProducts(const double* x, size_t n, size_t maxLag, double* sums) {                                 \
+        lagProductsBody(x, n, maxLag, sums);                                                                    \
+    }                                                                                                           \
+    void binIndices(const double* x, size_t n, double scale, double offset, uint32_t last, uint32_t* index) {  \
+        binIndicesBody(x, n, scale, offset, last, index);                                                       \
+    }                                                                                                           \
+    void philoxNormals(uint32_t key, uint64_t pair, size_t numPairs, double* out) {                            \
+        philoxNormalsBody(key, pair, numPairs, out);                                                            \
+    }                                                                                                           \
+    void sinCosTable(const uint64_t* phase, size_t n, double* cosine, double* sine) {                          \
+        sinCosTableBody(phase, n, cosine, sine);                                                                \
+    }
+
+#define DSP_KERNEL_TABLE(level, ns)                                                                            \
+    {level, ns::scaleAdd, ns::addPhiloxNoise, ns::mapAntipodal, ns::mapQam16, ns::demapHard,                  \
+     ns::demapQam16Hard, ns::demapQam16Soft, ns::viterbiAcs, ns::sumSquares, ns::sumSquaresAndError,          \
+     ns::countMismatches, ns::addMismatches, ns::zeroCrossings, ns::addTap, ns::addFadingTap,                 \
+     ns::philoxNormals, ns::sinCosTable, ns::powerSums, ns::lagProducts, ns::binIndices}
+
+namespace baseline {
+constexpr IsaLevel LEVEL = ISA_BASELINE;
+DSP_KERNEL_WRAPPERS
+} // namespace baseline
+
+#if defined(__x86_64__) || defined(__i386__)
+#pragma GCC push_options
+#pragma GCC target("sse4.2,popcnt")
+namespace sse42 {
+constexpr IsaLevel LEVEL = ISA_SSE42;
+DSP_KERNEL_WRAPPERS
+} // namespace sse42
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,bmi2")
+namespace avx2 {
+constexpr IsaLevel LEVEL = ISA_AVX2;
+DSP_KERNEL_WRAPPERS
+} // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512dq,avx512vl,avx512bw,bmi,bmi2,prefer-vector-width=512")
+namespace avx512 {
+constexpr IsaLevel LEVEL = ISA_AVX512;
+DSP_KERNEL_WRAPPERS
+} // namespace avx512
+#pragma GCC pop_options
+#else
+// Other architectures only have the portable build
+namespace sse42 = baseline;
+namespace avx2 = baseline;
+namespace avx512 = baseline;
+#endif
+
+const DspKernels& DspKernels::forLevel(IsaLevel level) {
+    static const DspKernels tables[] = {
+        DSP_KERNEL_TABLE(ISA_BASELINE, baseline),
+        DSP_KERNEL_TABLE(ISA_SSE42, sse42),
+        DSP_KERNEL_TABLE(ISA_AVX2, avx2),
+        DSP_KERNEL_TABLE(ISA_AVX512, avx512),
+    };
+    return tables[std::min<size_t>(level, ISA_AVX512)];
+}
@@ -0,0 +1,73 @@
+#ifndef DSP_KERNELS_HPP
+#define DSP_KERNELS_HPP
+
+#include <cstdint>
+#include <cstddef> // For size_t
+
+// Instruction set levels of the x86 fleet, lowest first
+enum IsaLevel {
+    ISA_BASELINE, // SSE2, any x86-64
+    ISA_SSE42,
+    ISA_AVX2,
+    ISA_AVX512    // F, DQ, VL and BW
+};
+
+// The per-sample loops of the channel, compiled once per IsaLevel from the same
+// source. Get the table bound for this CPU from CpuDispatch::kernels().
+//
+// Multi-row layouts follow ChannelBatch: value k of symbol s in column c is at
+// (4 * s + k) * width + c; width 1 is the ChannelModel layout.
+struct DspKernels {
+    IsaLevel level;
+
+    // out[i] = signal[i] + scale * noise[i]; out may alias signal
+    void (*scaleAdd)(const double* signal, const double* noise, double scale, double* out, size_t n);
+    // ChannelBatch noise for sample pair `pair` of frame `frame` across n channels:
+    // out0/out1 = in0/in1 + stdDev * (z0, z1). in1 and out1 are null for a lone last sample.
+    void (*addPhiloxNoise)(const uint32_t* keys, const double* stdDev, size_t n, uint64_t pair, uint64_t frame,
+                           const double* in0, const double* in1, double* out0, double* out1);
+
+    void (*mapAntipodal)(const int* bits, size_t n, double level, double* out); // bit ? level : -level
+    void (*mapQam16)(const int* bits, size_t numSymbols, size_t width, double* out); // Gray, unit power, I Q I Q
+    void (*demapHard)(const double* values, size_t n, int* bits);                   // value > 0
+    void (*demapQam16Hard)(const double* values, size_t numSymbols, size_t width, int* bits);
+    void (*demapQam16Soft)(const double* values, size_t numSymbols, size_t width, double* llrs);
+
+    // One Viterbi add-compare-select step for up to 256 states. State u is reached
+    // from (2u) mod S and (2u + 1) mod S through register values 2u and 2u + 1, whose
+    // output patterns index `branch`. Bit u of `decision` is set when the odd
+    // predecessor wins.
+    void (*viterbiAcs)(const double* metric, const double* branch, const uint8_t* outputs, size_t numStates,
+                       double* next, uint64_t* decision);
+
+    double (*sumSquares)(const double* x, size_t n);
+    // Sums of x^2 and of (y - x)^2
+    void (*sumSquaresAndError)(const double* x, const double* y, size_t n, double& xx, double& ee);
+    size_t (*countMismatches)(const int* a, const int* b, size_t n);
+    void (*addMismatches)(const int* a, const int* b, size_t n, size_t* counts); // counts[i] += a[i] != b[i]
+    // As Analyzer::computeZeroCrossingPoints on a contiguous buffer
+    size_t (*zeroCrossings)(const double* x, size_t count, size_t* points, size_t capacity);
+
+    // One multipath tap on split I/Q buffers: y += g * x, complex. xQ and yQ are
+    // null for a real signal, which takes the in-phase part of g only.
+    void (*addTap)(const double* xI, const double* xQ, double gI, double gQ, size_t n, double* yI, double* yQ);
+    // Same with a gain per sample
+    void (*addFadingTap)(const double* xI, const double* xQ, const double* gI, const double* gQ, size_t n,
+                         double* yI, double* yQ);
+
+    // Standard normals 2k and 2k + 1 from Philox block `pair + k` under `key`
+    void (*philoxNormals)(uint32_t key, uint64_t pair, size_t numPairs, double* out);
+    // cos and sin of fixed-point phases (2^64 is one turn), for carrier rotations
+    void (*sinCosTable)(const uint64_t* phase, size_t n, double* cosine, double* sine);
+
+    // Noise validation. sums[0..3] = sum of x, x^2, x^3, x^4
+    void (*powerSums)(const double* x, size_t n, double* sums);
+    // x holds maxLag samples of history, then n new ones; sums[lag - 1] = sum of x[t] * x[t - lag] over the new t
+    void (*lagProducts)(const double* x, size_t n, size_t maxLag, double* sums);
+    // index[i] = floor(x[i] * scale + offset) clamped to [0, last]; NaN gives last
+    void (*binIndices)(const double* x, size_t n, double scale, double offset, uint32_t last, uint32_t* index);
+
+    static const DspKernels& forLevel(IsaLevel level); // Whether the CPU runs it is up to the caller
+};
+
+#endif // DSP_KERNELS_HPP
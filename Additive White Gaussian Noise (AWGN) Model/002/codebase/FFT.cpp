@@ -0,0 +1,69 @@
+#include "FFT.hpp"
+#include <stdexcept>
+#include <utility>
+#include "Common.hpp"
+
+FFT::FFT(size_t size) : size_(size) {
+    if (size_ == 0 || (size_ & (size_ - 1)) != 0) {
+        throw std::invalid_argument("FFT size must be a power of two");
+    }
+
+    twiddles_.resize(size_ / 2);
+    for (size_t k = 0; k < size_ / 2; ++k) {
+        double angle = -2.0 * Constants::PI * k / size_;
+        twiddles_[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+
+    size_t bits = 0;
+    while ((size_t(1) << bits) < size_) ++bits;
+    bitReverse_.resize(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitReverse_[i] = r;
+    }
+}
+
+void FFT::transform(std::complex<double>* data, bool inverse) const {
+    for (size_t i = 0; i < size_; ++i) {
+        if (i < bitReverse_[i]) std::swap(data[i], data[bitReverse_[i]]);
+    }
+
+    for (size_t len = 2; len <= size_; len <<= 1) {
+        size_t half = len / 2;
+        size_t step = size_ / len;
+        for (size_t start = 0; start < size_; start += len) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<double> w = twiddles_[k * step];
+                if (inverse) w = std::conj(w);
+                std::complex<double> t = w * data[start + k + half];
+                data[start + k + half] = data[start + k] - t;
+                data[start + k] += t;
+            }
+        }
+    }
+}
+
+void FFT::forward(std::complex<double>* data) const {
+    transform(data, false);
+}
+
+void FFT::inverse(std::complex<double>* data) const {
+    transform(data, true);
+    const double scale = 1.0 / size_;
+    for (size_t i = 0; i < size_; ++i) {
+        data[i] *= scale;
+    }
+}
+
+size_t FFT::getSize() const {
+    return size_;
+}
+
+size_t FFT::nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
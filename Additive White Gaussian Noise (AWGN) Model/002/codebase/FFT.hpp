@@ -0,0 +1,25 @@
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <vector>
+#include <complex>
+#include <cstddef> // For size_t
+
+// Iterative radix-2 FFT with precomputed twiddles and bit-reversal table.
+// Size must be a power of two.
+class FFT {
+private:
+    size_t size_;
+    std::vector<std::complex<double>> twiddles_;
+    std::vector<size_t> bitReverse_;
+    void transform(std::complex<double>* data, bool inverse) const;
+
+public:
+    explicit FFT(size_t size);
+    void forward(std::complex<double>* data) const;
+    void inverse(std::complex<double>* data) const; // Scaled by 1/size
+    size_t getSize() const;
+    static size_t nextPowerOfTwo(size_t n);
+};
+
+#endif // FFT_HPP
@@ -0,0 +1,190 @@
+#include "FadingChannel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include "Common.hpp"
+
+FadingChannel::FadingChannel(double maxDoppler, double kFactor, size_t numSinusoids, unsigned int seed)
+    : maxDoppler_(maxDoppler), kFactor_(kFactor), numSinusoids_((numSinusoids + 3) / 4 * 4), seed_(seed), time_(0) {
+    if (maxDoppler_ < 0.0 || maxDoppler_ > 0.5) {
+        throw std::invalid_argument("Doppler shift must be between 0 and 0.5 of the sample rate");
+    }
+    if (kFactor_ < 0.0) {
+        throw std::invalid_argument("Rician K-factor must be non-negative");
+    }
+    if (numSinusoids_ == 0) {
+        throw std::invalid_argument("Fading needs at least one sinusoid");
+    }
+
+    drawPaths();
+}
+
+void FadingChannel::drawPaths() {
+    // Zheng-Xiao: alpha_n = (2*pi*n - pi + theta) / (4M) with random theta and path phases
+    std::mt19937 gen(seed_);
+    std::uniform_real_distribution<> uniform(-Constants::PI, Constants::PI);
+    const size_t M = numSinusoids_;
+    const double wd = 2.0 * Constants::PI * maxDoppler_;
+    double theta = uniform(gen);
+    omega_.resize(2 * M);
+    phase_.resize(2 * M);
+    for (size_t n = 0; n < M; ++n) {
+        double alpha = (2.0 * Constants::PI * (n + 1) - Constants::PI + theta) / (4.0 * M);
+        omega_[n] = wd * std::cos(alpha);
+        phase_[n] = uniform(gen);
+        omega_[M + n] = wd * std::sin(alpha);
+        phase_[M + n] = uniform(gen);
+    }
+    losOmega_ = wd * std::cos(uniform(gen));
+    losPhase_ = uniform(gen);
+
+    re_.resize(2 * M);
+    im_.resize(2 * M);
+    rotRe_.resize(2 * M);
+    rotIm_.resize(2 * M);
+    for (size_t p = 0; p < 2 * M; ++p) {
+        rotRe_[p] = std::cos(omega_[p]);
+        rotIm_[p] = std::sin(omega_[p]);
+    }
+}
+
+void FadingChannel::generateGains(size_t count) {
+    const size_t M = numSinusoids_;
+    const size_t P = 2 * M;
+    const double diffuse = std::sqrt(1.0 / (M * (kFactor_ + 1.0))); // E|h|^2 = 1
+    const double los = std::sqrt(kFactor_ / (kFactor_ + 1.0));
+
+    // Each path is a unit phasor advanced by a fixed rotation per sample, so the
+    // inner loops are element-wise multiplies over the path tables instead of
+    // 2M cos() calls per sample. Phasors are refreshed exactly every
+    // RESYNC_INTERVAL samples to keep rounding drift bounded.
+    double* re = re_.data();
+    double* im = im_.data();
+    const double* rotRe = rotRe_.data();
+    const double* rotIm = rotIm_.data();
+    const double losRotRe = std::cos(losOmega_);
+    const double losRotIm = std::sin(losOmega_);
+    double losRe = 0.0, losIm = 0.0;
+
+    gainI_.resize(count);
+    gainQ_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        double t = static_cast<double>(time_ + i);
+        if (i % RESYNC_INTERVAL == 0) {
+            for (size_t p = 0; p < P; ++p) {
+                re[p] = std::cos(omega_[p] * t + phase_[p]);
+                im[p] = std::sin(omega_[p] * t + phase_[p]);
+            }
+            losRe = los * std::cos(losOmega_ * t + losPhase_);
+            losIm = los * std::sin(losOmega_ * t + losPhase_);
+        }
+
+        // Four independent partial sums map onto vector lanes
+        double laneI[4] = {0.0, 0.0, 0.0, 0.0};
+        double laneQ[4] = {0.0, 0.0, 0.0, 0.0};
+        for (size_t p = 0; p < M; p += 4) {
+            for (size_t l = 0; l < 4; ++l) {
+                laneI[l] += re[p + l];
+                laneQ[l] += im[M + p + l];
+            }
+        }
+        double sumI = (laneI[0] + laneI[1]) + (laneI[2] + laneI[3]);
+        double sumQ = (laneQ[0] + laneQ[1]) + (laneQ[2] + laneQ[3]);
+
+        gainI_[i] = diffuse * sumI + losRe;
+        gainQ_[i] = diffuse * sumQ + losIm;
+
+        for (size_t p = 0; p < P; ++p) {
+            double r = re[p] * rotRe[p] - im[p] * rotIm[p];
+            im[p] = re[p] * rotIm[p] + im[p] * rotRe[p];
+            re[p] = r;
+        }
+        double r = losRe * losRotRe - losIm * losRotIm;
+        losIm = losRe * losRotIm + losIm * losRotRe;
+        losRe = r;
+    }
+    time_ += count;
+}
+
+std::vector<double> FadingChannel::apply(const std::vector<double>& signal, size_t stride) {
+    std::vector<double> faded(signal);
+    apply(faded.data(), faded.size(), stride);
+    return faded;
+}
+
+void FadingChannel::apply(double* samples, size_t numValues, size_t stride) {
+    const size_t numSamples = numValues / stride;
+    generateGains(numSamples);
+
+    for (size_t t = 0; t < numSamples; ++t) {
+        double* s = &samples[t * stride];
+        if (stride == 1) {
+            // Real BPSK: coherent detection sees the envelope
+            s[0] *= std::sqrt(gainI_[t] * gainI_[t] + gainQ_[t] * gainQ_[t]);
+        } else {
+            for (size_t j = 0; j + 1 < stride; j += 2) {
+                double I = s[j], Q = s[j + 1];
+                s[j] = I * gainI_[t] - Q * gainQ_[t];
+                s[j + 1] = I * gainQ_[t] + Q * gainI_[t];
+            }
+        }
+    }
+}
+
+std::vector<double> FadingChannel::compensate(const std::vector<double>& received, size_t stride) const {
+    std::vector<double> equalized(received);
+    compensate(equalized.data(), equalized.size(), stride);
+    return equalized;
+}
+
+void FadingChannel::compensate(double* samples, size_t numValues, size_t stride) const {
+    const size_t numSamples = std::min(numValues / stride, gainI_.size());
+    for (size_t t = 0; t < numSamples; ++t) {
+        double power = gainI_[t] * gainI_[t] + gainQ_[t] * gainQ_[t];
+        if (power <= 0.0) continue;
+        double* s = &samples[t * stride];
+        if (stride == 1) {
+            s[0] /= std::sqrt(power);
+        } else {
+            // Zero-forcing: multiply by conj(h) / |h|^2
+            for (size_t j = 0; j + 1 < stride; j += 2) {
+                double I = s[j], Q = s[j + 1];
+                s[j] = (I * gainI_[t] + Q * gainQ_[t]) / power;
+                s[j + 1] = (Q * gainI_[t] - I * gainQ_[t]) / power;
+            }
+        }
+    }
+}
+
+void FadingChannel::advance(size_t numSamples) {
+    generateGains(numSamples);
+}
+
+void FadingChannel::reset() {
+    time_ = 0;
+    gainI_.clear();
+    gainQ_.clear();
+}
+
+void FadingChannel::reset(unsigned int seed) {
+    seed_ = seed;
+    drawPaths(); // Same table sizes, so nothing is reallocated
+    reset();
+}
+
+const std::vector<double>& FadingChannel::getGainI() const {
+    return gainI_;
+}
+
+const std::vector<double>& FadingChannel::getGainQ() const {
+    return gainQ_;
+}
+
+double FadingChannel::getMaxDoppler() const {
+    return maxDoppler_;
+}
+
+double FadingChannel::getKFactor() const {
+    return kFactor_;
+}
@@ -0,0 +1,49 @@
+#ifndef FADING_CHANNEL_HPP
+#define FADING_CHANNEL_HPP
+
+#include <vector>
+#include <cstddef> // For size_t
+
+// Flat Rayleigh/Rician fading from the Zheng-Xiao sum-of-sinusoids model.
+// Apply before AWGN::addNoise; compensate() removes the known gains (perfect CSI)
+// before the demappers. Samples use the same interleaved layout as ChannelModel:
+// stride 1 is real (coherent envelope |h|), stride 2 or 4 is I/Q pairs (complex h).
+class FadingChannel {
+private:
+    double maxDoppler_; // Maximum Doppler shift normalized to the sample rate
+    double kFactor_;    // Rician K (linear), 0 for Rayleigh
+    size_t numSinusoids_;
+    unsigned int seed_;
+    size_t time_;       // Sample index of the next generated gain
+
+    // Per-path tables, structure-of-arrays so the path loop vectorizes.
+    // Paths [0, M) build the in-phase sum, paths [M, 2M) the quadrature sum.
+    std::vector<double> omega_;
+    std::vector<double> phase_;
+    double losOmega_;
+    double losPhase_;
+
+    std::vector<double> gainI_;
+    std::vector<double> gainQ_;
+    std::vector<double> re_, im_, rotRe_, rotIm_; // Phasor state, kept to avoid per-call allocation
+    void drawPaths(); // Path frequencies and phases from seed_
+    void generateGains(size_t count);
+
+public:
+    static constexpr size_t RESYNC_INTERVAL = 1024; // Samples between exact phasor refreshes
+
+    FadingChannel(double maxDoppler, double kFactor = 0.0, size_t numSinusoids = 16, unsigned int seed = 0);
+    std::vector<double> apply(const std::vector<double>& signal, size_t stride);
+    std::vector<double> compensate(const std::vector<double>& received, size_t stride) const;
+    void apply(double* samples, size_t numValues, size_t stride); // In place
+    void compensate(double* samples, size_t numValues, size_t stride) const;
+    void advance(size_t numSamples); // Next gains into getGainI/getGainQ, applied to nothing
+    void reset();
+    void reset(unsigned int seed); // Restart as if constructed with `seed`, reusing the tables
+    const std::vector<double>& getGainI() const;
+    const std::vector<double>& getGainQ() const;
+    double getMaxDoppler() const;
+    double getKFactor() const;
+};
+
+#endif // FADING_CHANNEL_HPP
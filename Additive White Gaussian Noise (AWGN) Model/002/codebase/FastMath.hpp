@@ -0,0 +1,233 @@
+#ifndef FAST_MATH_HPP
+#define FAST_MATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "Common.hpp"
+
+// Branch-free replacements for libm calls in hot loops. Everything is plain
+// integer and floating-point arithmetic, so loops calling these still vectorize.
+namespace FastMath {
+
+inline uint64_t toBits(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double fromBits(uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Natural log of a positive normal double: exponent plus 2 atanh((m-1)/(m+1))
+// on m in [sqrt(1/2), sqrt(2)), absolute error below 1e-12
+inline double logPositive(double x) {
+    uint64_t bits = toBits(x);
+    uint64_t fraction = bits & 0x000FFFFFFFFFFFFFULL;
+    // 1 when the mantissa is at least sqrt(2); it then moves to the next exponent
+    uint64_t high = (fraction + (0x0010000000000000ULL - 0x6A09E667F3BCDULL)) >> 52;
+    double m = fromBits(fraction | ((0x3FFULL - high) << 52));
+    double e = fromBits(0x4330000000000000ULL | ((bits >> 52) + high)) - (4503599627370496.0 + 1023.0);
+    double s = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double series = 2.0 / 13.0;
+    series = series * s2 + 2.0 / 11.0;
+    series = series * s2 + 2.0 / 9.0;
+    series = series * s2 + 2.0 / 7.0;
+    series = series * s2 + 2.0 / 5.0;
+    series = series * s2 + 2.0 / 3.0;
+    series = series * s2 + 2.0;
+    return e * 0.6931471805599453 + s * series;
+}
+
+// sin and cos of 2*pi*phase/2^64. The phase is a fixed-point fraction of a turn,
+// so it wraps exactly. The error is that of the truncated Taylor polynomials,
+// largest near +-pi/4: at most 2.1e-14 absolute, measured over the full circle.
+inline void sinCosTurn(uint64_t phase, double& sine, double& cosine) {
+    // Nearest quadrant, and the remaining angle in [-pi/4, pi/4) from its top 52 bits
+    uint64_t shifted = phase + (1ULL << 61);
+    uint64_t quadrant = shifted >> 62;
+    double fraction = fromBits(0x4330000000000000ULL | ((shifted >> 10) & 0x000FFFFFFFFFFFFFULL))
+                    - (4503599627370496.0 + 2251799813685248.0);
+    double theta = fraction * (Constants::PI / 2.0 / 4503599627370496.0);
+    double t2 = theta * theta;
+    double s = -1.0 / 6227020800.0;
+    s = s * t2 + 1.0 / 39916800.0;
+    s = s * t2 - 1.0 / 362880.0;
+    s = s * t2 + 1.0 / 5040.0;
+    s = s * t2 - 1.0 / 120.0;
+    s = s * t2 + 1.0 / 6.0;
+    s = theta - theta * t2 * s;
+    double c = 1.0 / 87178291200.0;
+    c = c * t2 - 1.0 / 479001600.0;
+    c = c * t2 + 1.0 / 3628800.0;
+    c = c * t2 - 1.0 / 40320.0;
+    c = c * t2 + 1.0 / 720.0;
+    c = c * t2 - 1.0 / 24.0;
+    c = c * t2 + 1.0 / 2.0;
+    c = 1.0 - t2 * c;
+
+    // Rotate by the quadrant: swap for odd quadrants, then flip signs. Bit masks
+    // rather than selects, since SSE2 has no 64-bit lane compare.
+    uint64_t swap = 0 - (quadrant & 1);
+    uint64_t cBits = toBits(c);
+    uint64_t sBits = toBits(s);
+    uint64_t flipCos = (((quadrant + 1) >> 1) & 1) << 63;
+    uint64_t flipSin = ((quadrant >> 1) & 1) << 63;
+    cosine = fromBits(((cBits & ~swap) | (sBits & swap)) ^ flipCos);
+    sine = fromBits(((sBits & ~swap) | (cBits & swap)) ^ flipSin);
+}
+
+// All ones when the sign bit of x is set, else zero
+inline uint64_t signMask(double x) {
+    return 0 - (toBits(x) >> 63);
+}
+
+// Bitwise select. Under the default -ftrapping-math GCC will not if-convert a
+// ?: whose arms do arithmetic, so loops using one would not vectorize.
+inline double select(uint64_t mask, double ifSet, double ifClear) {
+    return fromBits((toBits(ifSet) & mask) | (toBits(ifClear) & ~mask));
+}
+
+// e^x for x in [-708, 709], clamped outside it; relative error about 2e-16.
+// Reduces to r in [-ln2/2, ln2/2] with a two-part ln2 and scales by 2^n.
+inline double exp(double x) {
+    x = select(signMask(x + 708.0), -708.0, x);
+    x = select(signMask(709.0 - x), 709.0, x);
+    double k = x * 1.4426950408889634 + 6755399441055744.0; // 1.5 * 2^52 rounds to an integer
+    double n = k - 6755399441055744.0;
+    double r = x - n * 0.6931471803691238 - n * 1.9082149292705877e-10;
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    // The low bits of k hold n, which becomes the exponent field
+    return p * fromBits((toBits(k) + 1023) << 52);
+}
+
+// Complementary error function, relative error below 3e-15 over the whole
+// range, including the far tail where 1 - erf underflows. For |x| it uses
+// erfc(x) = 2 exp(-x^2) h(t) / (1 + 2x), with h a Chebyshev series in
+// t = (x - 3.5) / (x + 3.5) that maps [0, inf) onto [-1, 1), then
+// erfc(-x) = 2 - erfc(x). Zero beyond |x| = 26.6, where erfc is subnormal.
+inline double erfc(double x) {
+    static const double coefficients[24] = {
+        5.88816365818061960e-01, -8.15088641707314402e-04, -4.36684128673157299e-02,
+        2.90048741851466341e-02, -1.21700576980911124e-02, 3.76474185781787429e-03,
+        -8.71940878855626054e-04, 1.41349149082777920e-04, -1.15924558056316994e-05,
+        -1.05588334906650053e-06, 4.38288007844588317e-07, -3.05285131755125474e-08,
+        -8.55833235816543947e-09, 1.69568013440202117e-09, 1.27330809658170743e-10,
+        -6.24139206205982988e-11, -1.10613803476467512e-12, 2.21363002730098720e-12,
+        -1.68364020641798000e-14, -8.25960874944586090e-14, 9.51236973304597698e-16,
+        3.30049979317334477e-15, 1.41705223943855417e-17, -1.38913403349705256e-16};
+    double a = std::fabs(x);
+    uint64_t tail = signMask(26.6 - a); // Clear for NaN, which then propagates
+    a = select(tail, 27.0, a);
+    double t = (a - 3.5) / (a + 3.5);
+    // Clenshaw recurrence, unrolled so loops over erfc still vectorize
+    double b1 = 0.0, b2 = 0.0;
+#pragma GCC unroll 23
+    for (int k = 23; k > 0; --k) {
+        double b0 = 2.0 * t * b1 - b2 + coefficients[k];
+        b2 = b1;
+        b1 = b0;
+    }
+    double h = t * b1 - b2 + coefficients[0];
+    // exp(-a^2) from an exact square of the high half of a, corrected to second
+    // order for the rest, so rounding a^2 does not cost up to 1e-13 in the tail
+    double high = fromBits(toBits(a) & 0xFFFFFFFFF8000000ULL); // 26 significant bits
+    double low = a - high;
+    double rest = (2.0 * high + low) * low;
+    double gaussian = exp(-high * high) * (1.0 - rest + 0.5 * rest * rest);
+    double result = fromBits(toBits(2.0 * h * gaussian / (1.0 + 2.0 * a)) & ~tail);
+    return select(signMask(x), 2.0 - result, result);
+}
+
+// Fixed-point phase for a fraction of a turn; any real value, reduced modulo 1
+inline uint64_t turnsToPhase(double turns) {
+    if (turns < 0.0) {
+        return 0 - turnsToPhase(-turns); // Keeps small negative values exact
+    }
+    double fraction = turns - std::floor(turns);
+    if (!(fraction < 1.0)) {
+        return 0; // Rounded up to a whole turn
+    }
+    // Split so each half converts exactly
+    double high = std::floor(fraction * 4294967296.0);
+    double low = (fraction * 4294967296.0 - high) * 4294967296.0;
+    return (static_cast<uint64_t>(high) << 32) + static_cast<uint64_t>(low + 0.5);
+}
+
+// 128-bit fixed-point phase, in units of 2^-128 of a turn. The high word is
+// what sinCosTurn reads; the low word keeps the bits of a frequency below
+// 2^-64 of a turn, which a 64-bit increment would drop on every sample.
+// Integers are WidePhase{0, n}, so n * frequency is multiply({0, n}, frequency).
+struct WidePhase {
+    uint64_t high;
+    uint64_t low;
+};
+
+// Full 64 x 64-bit product, without compiler-specific 128-bit types
+inline WidePhase multiplyFull(uint64_t a, uint64_t b) {
+    uint64_t a0 = a & 0xFFFFFFFFULL, a1 = a >> 32;
+    uint64_t b0 = b & 0xFFFFFFFFULL, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t middle = (p00 >> 32) + (p01 & 0xFFFFFFFFULL) + (p10 & 0xFFFFFFFFULL);
+    return {p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32), (middle << 32) | (p00 & 0xFFFFFFFFULL)};
+}
+
+// Products and sums wrap modulo one turn
+inline WidePhase multiply(WidePhase a, WidePhase b) {
+    WidePhase product = multiplyFull(a.low, b.low);
+    product.high += a.high * b.low + a.low * b.high;
+    return product;
+}
+
+inline WidePhase add(WidePhase a, WidePhase b) {
+    uint64_t low = a.low + b.low;
+    return {a.high + b.high + (low < a.low), low};
+}
+
+// The 64-bit phase nearest to a wide one
+inline uint64_t roundPhase(WidePhase phase) {
+    return phase.high + (phase.low >> 63);
+}
+
+// turnsToPhase to 128 bits. Exact for any double that is a multiple of 2^-128.
+inline WidePhase turnsToWidePhase(double turns) {
+    if (turns < 0.0) {
+        WidePhase phase = turnsToWidePhase(-turns);
+        return {~phase.high + (phase.low == 0), 0 - phase.low};
+    }
+    double fraction = turns - std::floor(turns);
+    if (!(fraction < 1.0)) {
+        return {0, 0};
+    }
+    // 32 bits at a time, each step exact
+    uint64_t words[4];
+    for (uint64_t& word : words) {
+        fraction *= 4294967296.0;
+        double whole = std::floor(fraction);
+        word = static_cast<uint64_t>(whole);
+        fraction -= whole;
+    }
+    return {(words[0] << 32) | words[1], (words[2] << 32) | words[3]};
+}
+
+} // namespace FastMath
+
+#endif // FAST_MATH_HPP
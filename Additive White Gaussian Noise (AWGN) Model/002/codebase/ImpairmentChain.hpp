@@ -0,0 +1,275 @@
+#ifndef IMPAIRMENT_CHAIN_HPP
+#define IMPAIRMENT_CHAIN_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <cstddef> // For size_t
+#include "Common.hpp"
+#include "CpuDispatch.hpp"
+#include "FastMath.hpp"
+
+// RF impairment stages for ImpairmentChain. The chain runs a block in chunks
+// of up to CHUNK samples: prepare<Complex>(first, count) sets a stage up for
+// samples [first, first + count) of the block, then apply<Complex>(i, q, k)
+// changes chunk sample k in registers (q is 0 and ignored for real signals).
+// Stages with state carry it from one block to the next.
+
+class GainStage {
+private:
+    double gain_;
+
+public:
+    explicit GainStage(double gain = 1.0) : gain_(gain) {}
+    template <bool Complex>
+    void prepare(size_t, size_t) {}
+    template <bool Complex>
+    void apply(double& i, double& q, size_t) const {
+        i *= gain_;
+        if (Complex) {
+            q *= gain_;
+        }
+    }
+};
+
+// Rotation by a carrier phase that changes every sample. prepare() turns the
+// chunk's phases into a table of phasors in one vectorized pass over L1, so a
+// sample costs a complex multiply. Phases are fixed-point fractions of a turn
+// and wrap exactly, however long the stream.
+class CarrierRotation {
+public:
+    static constexpr size_t CHUNK = 256;
+
+protected:
+    uint64_t phase_[CHUNK];
+    double cosine_[CHUNK];
+    double sine_[CHUNK];
+
+    // A constant phase of 0, for stages that are off
+    void identityTable() {
+        std::fill(cosine_, cosine_ + CHUNK, 1.0);
+        std::fill(sine_, sine_ + CHUNK, 0.0);
+    }
+
+    void computeTable(size_t count) {
+        CpuDispatch::kernels().sinCosTable(phase_, count, cosine_, sine_);
+    }
+
+    template <bool Complex>
+    void rotate(double& i, double& q, size_t k) const {
+        double rotatedI = i * cosine_[k] - q * sine_[k];
+        if (Complex) {
+            q = i * sine_[k] + q * cosine_[k];
+        }
+        i = rotatedI;
+    }
+
+    // Fixed-point phase for a signed fraction of a turn
+    static uint64_t toPhase(double turns) {
+        if (std::fabs(turns) < 0.25) {
+            return static_cast<uint64_t>(static_cast<int64_t>(turns * 18446744073709551616.0));
+        }
+        return FastMath::turnsToPhase(turns);
+    }
+};
+
+// Carrier frequency offset in cycles per sample. Real signals keep the
+// in-phase part of the rotated carrier.
+class FrequencyOffsetStage : public CarrierRotation {
+private:
+    uint64_t carrier_; // Phase of the next sample
+    uint64_t step_;
+
+public:
+    explicit FrequencyOffsetStage(double cyclesPerSample = 0.0) : carrier_(0), step_(toPhase(cyclesPerSample)) {
+        identityTable();
+    }
+    template <bool Complex>
+    void prepare(size_t, size_t count) {
+        if (step_ == 0) {
+            return; // The carrier stays at phase 0
+        }
+        for (size_t k = 0; k < count; ++k) {
+            phase_[k] = carrier_ + k * step_;
+        }
+        carrier_ += count * step_;
+        computeTable(count);
+    }
+    template <bool Complex>
+    void apply(double& i, double& q, size_t k) const {
+        rotate<Complex>(i, q, k);
+    }
+};
+
+// Wiener phase noise: the carrier phase is a random walk with stdDev radians
+// per step, a Lorentzian line of stdDev^2 / (2 pi) cycles per sample. Step s
+// is normal s of the Philox stream under `seed`, so the walk depends only on
+// the seed and the sample index, not on how the stream is cut into blocks.
+class PhaseNoiseStage : public CarrierRotation {
+private:
+    double stdDevTurns_;
+    uint32_t key_;
+    uint64_t sample_; // Index of the next sample
+    uint64_t walk_;   // Phase of the next sample
+    double increments_[CHUNK + 2];
+
+public:
+    explicit PhaseNoiseStage(double stdDevRadians = 0.0, unsigned int seed = 0)
+        : stdDevTurns_(stdDevRadians / (2.0 * Constants::PI)), key_(seed), sample_(0), walk_(0) {
+        identityTable();
+    }
+    template <bool Complex>
+    void prepare(size_t, size_t count) {
+        if (stdDevTurns_ == 0.0) {
+            return; // No walk: no Philox draws, and the phase stays at 0
+        }
+        // Normals come in pairs; an odd start uses the second half of its pair
+        size_t skip = sample_ & 1;
+        CpuDispatch::kernels().philoxNormals(key_, sample_ / 2, (skip + count + 1) / 2, increments_);
+        for (size_t k = 0; k < count; ++k) {
+            phase_[k] = walk_;
+            walk_ += toPhase(stdDevTurns_ * increments_[skip + k]);
+        }
+        sample_ += count;
+        computeTable(count);
+    }
+    template <bool Complex>
+    void apply(double& i, double& q, size_t k) const {
+        rotate<Complex>(i, q, k);
+    }
+};
+
+// Receiver IQ imbalance: gainDb is the I/Q amplitude ratio, split evenly
+// between the branches, and phaseDeg the quadrature error of the Q branch.
+// Real signals only see the I branch gain.
+class IqImbalanceStage {
+private:
+    double gainI_;
+    double crossQ_;  // I leaking into Q, -sin(phase) on the Q branch gain
+    double directQ_; // cos(phase) on the Q branch gain
+
+public:
+    explicit IqImbalanceStage(double gainDb = 0.0, double phaseDeg = 0.0) {
+        double a = std::pow(10.0, gainDb / 40.0);
+        double phi = phaseDeg * Constants::PI / 180.0;
+        gainI_ = a;
+        crossQ_ = -std::sin(phi) / a;
+        directQ_ = std::cos(phi) / a;
+    }
+    template <bool Complex>
+    void prepare(size_t, size_t) {}
+    template <bool Complex>
+    void apply(double& i, double& q, size_t) const {
+        if (Complex) {
+            q = crossQ_ * i + directQ_ * q;
+        }
+        i *= gainI_;
+    }
+};
+
+class DcOffsetStage {
+private:
+    double offsetI_, offsetQ_;
+
+public:
+    explicit DcOffsetStage(double offsetI = 0.0, double offsetQ = 0.0) : offsetI_(offsetI), offsetQ_(offsetQ) {}
+    template <bool Complex>
+    void prepare(size_t, size_t) {}
+    template <bool Complex>
+    void apply(double& i, double& q, size_t) const {
+        i += offsetI_;
+        if (Complex) {
+            q += offsetQ_;
+        }
+    }
+};
+
+// Additive noise from a block drawn by AWGN::drawNoise, one unit value per
+// signal value. Point it at each block's noise before processing the block.
+class NoiseStage {
+private:
+    const double* noise_;
+    const double* chunk_;
+    double stdDev_;
+
+public:
+    NoiseStage() : noise_(nullptr), chunk_(nullptr), stdDev_(0.0) {}
+    void setNoise(const double* unitNoise, double stdDev) {
+        noise_ = unitNoise;
+        stdDev_ = stdDev;
+    }
+    template <bool Complex>
+    void prepare(size_t first, size_t) {
+        chunk_ = noise_ + (Complex ? 2 * first : first);
+    }
+    template <bool Complex>
+    void apply(double& i, double& q, size_t k) const {
+        if (Complex) {
+            i += stdDev_ * chunk_[2 * k];
+            q += stdDev_ * chunk_[2 * k + 1];
+        } else {
+            i += stdDev_ * chunk_[k];
+        }
+    }
+};
+
+// A fixed sequence of stages run as one per-sample loop: every sample is read
+// once, goes through all stages in registers and is written once, so adding
+// an impairment adds arithmetic but no pass over memory. Samples use the
+// FadingChannel layout: stride 1 is real, stride 2 or 4 is I/Q pairs.
+//
+//   auto chain = makeImpairmentChain(GainStage(2.0), FrequencyOffsetStage(1e-3), NoiseStage());
+//   chain.get<NoiseStage>().setNoise(noise, noiseStdDev);
+//   chain.process(signal, numValues, stride, out);
+template <typename... Stages>
+class ImpairmentChain {
+private:
+    std::tuple<Stages...> stages_;
+
+    template <bool Complex, size_t... Index>
+    void run(const double* in, size_t numValues, double* out, std::index_sequence<Index...>) {
+        const size_t width = Complex ? 2 : 1;
+        const size_t n = numValues / width;
+        for (size_t first = 0; first < n; first += CarrierRotation::CHUNK) {
+            const size_t count = std::min(CarrierRotation::CHUNK, n - first);
+            (std::get<Index>(stages_).template prepare<Complex>(first, count), ...);
+            const double* x = in + width * first;
+            double* y = out + width * first;
+            for (size_t k = 0; k < count; ++k) {
+                double i = x[width * k];
+                double q = Complex ? x[width * k + 1] : 0.0;
+                (std::get<Index>(stages_).template apply<Complex>(i, q, k), ...);
+                y[width * k] = i;
+                if (Complex) {
+                    y[width * k + 1] = q;
+                }
+            }
+        }
+    }
+
+public:
+    explicit ImpairmentChain(Stages... stages) : stages_(std::move(stages)...) {}
+
+    // numValues values from `in` to `out` (may alias)
+    void process(const double* in, size_t numValues, size_t stride, double* out) {
+        if (stride > 1) {
+            run<true>(in, numValues, out, std::index_sequence_for<Stages...>());
+        } else {
+            run<false>(in, numValues, out, std::index_sequence_for<Stages...>());
+        }
+    }
+
+    template <typename Stage>
+    Stage& get() {
+        return std::get<Stage>(stages_);
+    }
+};
+
+template <typename... Stages>
+ImpairmentChain<Stages...> makeImpairmentChain(Stages... stages) {
+    return ImpairmentChain<Stages...>(std::move(stages)...);
+}
+
+#endif // IMPAIRMENT_CHAIN_HPP
@@ -0,0 +1,63 @@
+#include "Interleaver.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+Interleaver::Interleaver(InterleaverType type, std::vector<uint32_t> permutation)
+    : type_(type), permutation_(std::move(permutation)) {}
+
+Interleaver Interleaver::qpp(size_t length, size_t f1, size_t f2) {
+    if (length == 0) {
+        throw std::invalid_argument("Interleaver length must be greater than 0");
+    }
+    std::vector<uint32_t> permutation(length);
+    std::vector<char> used(length, 0);
+    for (size_t i = 0; i < length; ++i) {
+        // (f1 i + f2 i^2) mod length without overflow for any block size in use
+        size_t index = (f1 % length * i + f2 % length * (i * i % length)) % length;
+        if (used[index]) {
+            throw std::invalid_argument("QPP coefficients do not give a permutation of this length");
+        }
+        used[index] = 1;
+        permutation[i] = static_cast<uint32_t>(index);
+    }
+    return Interleaver(QPP_INTERLEAVER, std::move(permutation));
+}
+
+Interleaver Interleaver::lte(size_t length) {
+    switch (length) {
+        case 40: return qpp(40, 3, 10);
+        case 64: return qpp(64, 7, 16);
+        case 128: return qpp(128, 15, 32);
+        case 256: return qpp(256, 15, 32);
+        case 512: return qpp(512, 31, 64);
+        case 1024: return qpp(1024, 31, 64);
+        case 6144: return qpp(6144, 263, 480);
+        default: throw std::invalid_argument("No tabulated LTE interleaver for this length");
+    }
+}
+
+Interleaver Interleaver::random(size_t length, unsigned int seed) {
+    if (length == 0) {
+        throw std::invalid_argument("Interleaver length must be greater than 0");
+    }
+    std::vector<uint32_t> permutation(length);
+    std::iota(permutation.begin(), permutation.end(), 0u);
+    std::mt19937 gen(seed);
+    std::shuffle(permutation.begin(), permutation.end(), gen);
+    return Interleaver(RANDOM_INTERLEAVER, std::move(permutation));
+}
+
+size_t Interleaver::getLength() const {
+    return permutation_.size();
+}
+
+InterleaverType Interleaver::getType() const {
+    return type_;
+}
+
+const std::vector<uint32_t>& Interleaver::getPermutation() const {
+    return permutation_;
+}
@@ -0,0 +1,46 @@
+#ifndef INTERLEAVER_HPP
+#define INTERLEAVER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef> // For size_t
+
+enum InterleaverType { QPP_INTERLEAVER, RANDOM_INTERLEAVER };
+
+// Block permutation used by the turbo code: interleave() reads out[i] = in[pi(i)],
+// deinterleave() undoes it. The table is built once, so both are plain index loops.
+class Interleaver {
+private:
+    InterleaverType type_;
+    std::vector<uint32_t> permutation_;
+    Interleaver(InterleaverType type, std::vector<uint32_t> permutation);
+
+public:
+    // Quadratic permutation polynomial pi(i) = (f1 i + f2 i^2) mod length
+    static Interleaver qpp(size_t length, size_t f1, size_t f2);
+    // QPP with the LTE (36.212) coefficients; only a subset of its block sizes is tabulated
+    static Interleaver lte(size_t length);
+    // Uniformly random permutation, reproducible from the seed
+    static Interleaver random(size_t length, unsigned int seed);
+
+    template <typename T>
+    void interleave(const T* in, T* out) const {
+        const uint32_t* pi = permutation_.data();
+        for (size_t i = 0; i < permutation_.size(); ++i) {
+            out[i] = in[pi[i]];
+        }
+    }
+    template <typename T>
+    void deinterleave(const T* in, T* out) const {
+        const uint32_t* pi = permutation_.data();
+        for (size_t i = 0; i < permutation_.size(); ++i) {
+            out[pi[i]] = in[i];
+        }
+    }
+
+    size_t getLength() const;
+    InterleaverType getType() const;
+    const std::vector<uint32_t>& getPermutation() const;
+};
+
+#endif // INTERLEAVER_HPP
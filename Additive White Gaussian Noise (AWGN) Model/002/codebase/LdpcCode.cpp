@@ -0,0 +1,313 @@
+#include "LdpcCode.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    // IEEE 802.11n-2009 Annex R, rate 1/2, Z = 27
+    const int IEEE80211N_R12_Z27[12 * 24] = {
+         0, -1, -1, -1,  0,  0, -1, -1,  0, -1, -1,  0,  1,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        22,  0, -1, -1, 17, -1,  0,  0, 12, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+         6, -1,  0, -1, 10, -1, -1, -1, 24, -1,  0, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1, -1,
+         2, -1, -1,  0, 20, -1, -1, -1, 25,  0, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1, -1,
+        23, -1, -1, -1,  3, -1, -1, -1,  0, -1,  9, 11, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1, -1,
+        24, -1, 23,  1, 17, -1,  3, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1, -1,
+        25, -1, -1, -1,  8, -1, -1, -1,  7, 18, -1, -1,  0, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1, -1,
+        13, 24, -1, -1,  0, -1,  8, -1,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1, -1,
+         7, 20, -1, 16, 22, 10, -1, -1, 23, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1, -1,
+        11, -1, -1, -1, 19, -1, -1, -1, 13, -1,  3, 17, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0, -1,
+        25, -1,  8, -1, 23, 18, -1, 14,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0,
+         3, -1, -1, -1, 16, -1, -1,  2, 25,  5, -1, -1,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0
+    };
+
+    inline int saturate(int value, int limit) {
+        return std::min(std::max(value, -limit), limit);
+    }
+}
+
+LdpcCode::LdpcCode(const std::vector<int>& baseMatrix, size_t rows, size_t cols, size_t baseZ,
+                   size_t liftingSize, size_t maxIterations)
+    : rows_(rows), cols_(cols), z_(liftingSize), maxIterations_(maxIterations), numEdges_(0), maxDegree_(0),
+      lanes_((liftingSize + 31) / 32 * 32) {
+    if (rows < 2 || cols <= rows || baseMatrix.size() != rows * cols) {
+        throw std::invalid_argument("Base matrix size does not match its dimensions");
+    }
+    if (baseZ == 0 || liftingSize == 0 || maxIterations == 0) {
+        throw std::invalid_argument("Lifting sizes and iteration count must be greater than 0");
+    }
+
+    layers_.resize(rows_);
+    parityShifts_.assign(rows_, -1);
+    const size_t first = cols_ - rows_; // Weight-3 parity column
+    for (size_t r = 0; r < rows_; ++r) {
+        for (size_t c = 0; c < cols_; ++c) {
+            int shift = baseMatrix[r * cols_ + c];
+            if (shift < 0) continue;
+            size_t lifted = static_cast<size_t>(shift) * z_ / baseZ % z_;
+            layers_[r].push_back(Edge{c, lifted});
+            if (c == first) {
+                parityShifts_[r] = static_cast<int>(lifted);
+            }
+            ++numEdges_;
+        }
+        maxDegree_ = std::max(maxDegree_, layers_[r].size());
+    }
+
+    // Check the parity layout the encoder relies on
+    bool valid = parityShifts_[0] >= 0 && parityShifts_[0] == parityShifts_[rows_ - 1];
+    size_t middle = 0;
+    for (size_t r = 1; r + 1 < rows_; ++r) {
+        if (parityShifts_[r] == 0) ++middle;
+        else if (parityShifts_[r] > 0) valid = false;
+    }
+    valid = valid && middle == 1;
+    for (size_t j = 0; j + 1 < rows_ && valid; ++j) {
+        for (size_t r = 0; r < rows_; ++r) {
+            int shift = baseMatrix[r * cols_ + first + 1 + j];
+            valid = valid && ((r == j || r == j + 1) ? shift == 0 : shift < 0);
+        }
+    }
+    if (!valid) {
+        throw std::invalid_argument("Base matrix needs the 802.11n dual-diagonal parity structure");
+    }
+}
+
+LdpcCode LdpcCode::ieee80211nRate12(size_t liftingSize, size_t maxIterations) {
+    std::vector<int> base(IEEE80211N_R12_Z27, IEEE80211N_R12_Z27 + 12 * 24);
+    return LdpcCode(base, 12, 24, 27, liftingSize, maxIterations);
+}
+
+void LdpcCode::encodeBlock(const int* info, int* codeword, uint8_t* lambda) const {
+    const size_t Z = z_;
+    const size_t first = cols_ - rows_;
+    std::copy(info, info + first * Z, codeword);
+
+    // lambda_r = sum over the information blocks of row r
+    std::fill(lambda, lambda + rows_ * Z, 0);
+    for (size_t r = 0; r < rows_; ++r) {
+        uint8_t* l = lambda + r * Z;
+        for (const Edge& edge : layers_[r]) {
+            if (edge.column >= first) continue;
+            const int* block = info + edge.column * Z;
+            for (size_t k = 0; k < Z; ++k) {
+                l[k] ^= static_cast<uint8_t>(block[(k + edge.shift) % Z] & 1);
+            }
+        }
+    }
+
+    // The weight-3 column sums to the identity, so its block is the sum of all lambdas
+    int* p0 = codeword + first * Z;
+    std::fill(p0, p0 + Z, 0);
+    for (size_t r = 0; r < rows_; ++r) {
+        for (size_t k = 0; k < Z; ++k) {
+            p0[k] ^= lambda[r * Z + k];
+        }
+    }
+
+    // Then the dual diagonal is solved row by row
+    for (size_t j = 0; j + 1 < rows_; ++j) {
+        int* p = codeword + (first + 1 + j) * Z;
+        const int* previous = j > 0 ? p - Z : nullptr;
+        const uint8_t* l = lambda + j * Z;
+        int shift = parityShifts_[j];
+        for (size_t k = 0; k < Z; ++k) {
+            int bit = l[k];
+            if (previous) bit ^= previous[k];
+            if (shift >= 0) bit ^= p0[(k + shift) % Z];
+            p[k] = bit;
+        }
+    }
+}
+
+size_t LdpcCode::encode(const int* bits, size_t numBits, int* encoded, Arena& scratch) const {
+    const size_t k = getInfoLength();
+    const size_t n = getBlockLength();
+    const size_t blocks = (numBits + k - 1) / k;
+    uint8_t* lambda = scratch.allocate<uint8_t>(rows_ * z_);
+    for (size_t b = 0; b < blocks; ++b) {
+        const int* info = bits + b * k;
+        if ((b + 1) * k > numBits) {
+            int* padded = scratch.allocate<int>(k);
+            size_t remaining = numBits - b * k;
+            std::copy(info, info + remaining, padded);
+            std::fill(padded + remaining, padded + k, 0);
+            info = padded;
+        }
+        encodeBlock(info, encoded + b * n, lambda);
+    }
+    return blocks * n;
+}
+
+bool LdpcCode::checksSatisfied(const int16_t* posterior, uint8_t* parity) const {
+    const size_t Z = z_;
+    for (size_t r = 0; r < rows_; ++r) {
+        std::fill(parity, parity + Z, 0);
+        for (const Edge& edge : layers_[r]) {
+            const int16_t* block = posterior + edge.column * Z;
+            const size_t split = Z - edge.shift;
+            for (size_t k = 0; k < split; ++k) {
+                parity[k] ^= static_cast<uint8_t>(block[k + edge.shift] < 0);
+            }
+            for (size_t k = split; k < Z; ++k) {
+                parity[k] ^= static_cast<uint8_t>(block[k - split] < 0);
+            }
+        }
+        uint8_t any = 0;
+        for (size_t k = 0; k < Z; ++k) {
+            any |= parity[k];
+        }
+        if (any) return false;
+    }
+    return true;
+}
+
+size_t LdpcCode::decodeBlock(const double* llrs, int* bits, const DecoderBuffers& buffers) const {
+    const size_t Z = z_;
+    const size_t lanes = lanes_;
+    const size_t n = getBlockLength();
+    int16_t* posterior = buffers.posterior;
+    int16_t* messages = buffers.messages;
+    int16_t* extrinsic = buffers.extrinsic;
+    int16_t* min1 = buffers.min1;
+    int16_t* min2 = buffers.min2;
+    uint8_t* minIndex = buffers.minIndex;
+    uint8_t* sign = buffers.sign;
+
+    // Min-sum does not care about the scale of the channel values, but the int16
+    // quantization does, so each block is scaled to a mean magnitude of LLR_SCALE
+    // whatever the received level. Internally positive means 0, the usual
+    // min-sum convention.
+    double magnitude = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        magnitude += std::fabs(llrs[i]);
+    }
+    const double scale = magnitude > 0.0 ? LLR_SCALE * n / magnitude : 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double q = std::min(std::max(-llrs[i] * scale, -double(CHANNEL_LIMIT)), double(CHANNEL_LIMIT));
+        posterior[i] = static_cast<int16_t>(std::lround(q));
+    }
+    std::fill(messages, messages + numEdges_ * lanes, 0);
+    std::fill(extrinsic, extrinsic + maxDegree_ * lanes, 0);
+
+    size_t iteration = 0;
+    while (iteration < maxIterations_ && !checksSatisfied(posterior, sign)) {
+        int16_t* r = messages;
+        for (const auto& layer : layers_) {
+            std::fill(min1, min1 + lanes, static_cast<int16_t>(MESSAGE_LIMIT));
+            std::fill(min2, min2 + lanes, static_cast<int16_t>(MESSAGE_LIMIT));
+            std::fill(minIndex, minIndex + lanes, 0);
+            std::fill(sign, sign + lanes, 0);
+
+            // Variable-to-check: posterior minus this layer's old message, rotated into check order
+            for (size_t e = 0; e < layer.size(); ++e) {
+                const int16_t* block = posterior + layer[e].column * Z;
+                const int16_t* old = r + e * lanes;
+                int16_t* t = extrinsic + e * lanes;
+                const size_t shift = layer[e].shift;
+                const size_t split = Z - shift;
+                for (size_t k = 0; k < split; ++k) {
+                    t[k] = static_cast<int16_t>(saturate(block[k + shift] - old[k], MESSAGE_LIMIT));
+                }
+                for (size_t k = split; k < Z; ++k) {
+                    t[k] = static_cast<int16_t>(saturate(block[k - split] - old[k], MESSAGE_LIMIT));
+                }
+                const uint8_t index = static_cast<uint8_t>(e);
+                for (size_t k = 0; k < lanes; ++k) {
+                    int16_t magnitude = static_cast<int16_t>(t[k] < 0 ? -t[k] : t[k]);
+                    bool smaller = magnitude < min1[k];
+                    min2[k] = std::min(min2[k], std::max(min1[k], magnitude));
+                    min1[k] = smaller ? magnitude : min1[k];
+                    minIndex[k] = smaller ? index : minIndex[k];
+                    sign[k] ^= static_cast<uint8_t>(t[k] < 0);
+                }
+            }
+
+            // Check-to-variable with normalization 3/4, then the posterior update
+            for (size_t e = 0; e < layer.size(); ++e) {
+                int16_t* block = posterior + layer[e].column * Z;
+                int16_t* message = r + e * lanes;
+                const int16_t* t = extrinsic + e * lanes;
+                const uint8_t index = static_cast<uint8_t>(e);
+                for (size_t k = 0; k < lanes; ++k) {
+                    int magnitude = ((minIndex[k] == index ? min2[k] : min1[k]) * 3) >> 2;
+                    bool negative = (sign[k] ^ static_cast<uint8_t>(t[k] < 0)) != 0;
+                    message[k] = static_cast<int16_t>(negative ? -magnitude : magnitude);
+                }
+                const size_t shift = layer[e].shift;
+                const size_t split = Z - shift;
+                for (size_t k = 0; k < split; ++k) {
+                    block[k + shift] = static_cast<int16_t>(saturate(t[k] + message[k], MESSAGE_LIMIT));
+                }
+                for (size_t k = split; k < Z; ++k) {
+                    block[k - split] = static_cast<int16_t>(saturate(t[k] + message[k], MESSAGE_LIMIT));
+                }
+            }
+            r += layer.size() * lanes;
+        }
+        ++iteration;
+    }
+
+    const size_t k = getInfoLength();
+    for (size_t i = 0; i < k; ++i) {
+        bits[i] = posterior[i] < 0 ? 1 : 0;
+    }
+    return iteration;
+}
+
+size_t LdpcCode::decode(const double* llrs, size_t numLlrs, int* bits, Arena& scratch) const {
+    const size_t blocks = numLlrs / getBlockLength();
+    DecoderBuffers buffers;
+    buffers.posterior = scratch.allocate<int16_t>(getBlockLength());
+    buffers.messages = scratch.allocate<int16_t>(numEdges_ * lanes_);
+    buffers.extrinsic = scratch.allocate<int16_t>(maxDegree_ * lanes_);
+    buffers.min1 = scratch.allocate<int16_t>(lanes_);
+    buffers.min2 = scratch.allocate<int16_t>(lanes_);
+    buffers.minIndex = scratch.allocate<uint8_t>(lanes_);
+    buffers.sign = scratch.allocate<uint8_t>(lanes_);
+    for (size_t b = 0; b < blocks; ++b) {
+        decodeBlock(llrs + b * getBlockLength(), bits + b * getInfoLength(), buffers);
+    }
+    return blocks * getInfoLength();
+}
+
+size_t LdpcCode::encodedLength(size_t numBits) const {
+    return (numBits + getInfoLength() - 1) / getInfoLength() * getBlockLength();
+}
+
+size_t LdpcCode::decodedLength(size_t numLlrs) const {
+    return numLlrs / getBlockLength() * getInfoLength();
+}
+
+double LdpcCode::getRate() const {
+    return static_cast<double>(cols_ - rows_) / cols_;
+}
+
+bool LdpcCode::isCodeword(const int* codeword) const {
+    const size_t Z = z_;
+    for (size_t r = 0; r < rows_; ++r) {
+        for (size_t k = 0; k < Z; ++k) {
+            int parity = 0;
+            for (const Edge& edge : layers_[r]) {
+                parity ^= codeword[edge.column * Z + (k + edge.shift) % Z] & 1;
+            }
+            if (parity) return false;
+        }
+    }
+    return true;
+}
+
+size_t LdpcCode::getInfoLength() const {
+    return (cols_ - rows_) * z_;
+}
+
+size_t LdpcCode::getBlockLength() const {
+    return cols_ * z_;
+}
+
+size_t LdpcCode::getLiftingSize() const {
+    return z_;
+}
+
+size_t LdpcCode::getMaxIterations() const {
+    return maxIterations_;
+}
@@ -0,0 +1,76 @@
+#ifndef LDPC_CODE_HPP
+#define LDPC_CODE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "ChannelCodec.hpp"
+
+// Quasi-cyclic LDPC code given by a base matrix of circulant shifts (-1 for an
+// all-zero block) lifted by Z. The parity part must have the 802.11n/802.16e
+// layout: one weight-3 column (equal shifts in the first and last row, shift 0
+// in one middle row) followed by a dual diagonal, which gives a linear-time
+// systematic encoder. Information bits are split into blocks of getInfoLength()
+// and the last block is zero-padded.
+//
+// Decoding is layered normalized min-sum over int16 messages. Every base-matrix
+// row is one layer of Z independent checks, so all inner loops run across the
+// lifting size with no data-dependent branches, and iterations stop as soon as
+// the hard decisions satisfy every check.
+class LdpcCode : public ChannelCodec {
+private:
+    struct Edge {
+        size_t column; // Base-matrix column
+        size_t shift;  // Check k of the layer meets variable (k + shift) mod Z
+    };
+    size_t rows_;
+    size_t cols_;
+    size_t z_;
+    size_t maxIterations_;
+    std::vector<std::vector<Edge>> layers_;
+    size_t numEdges_;
+    std::vector<int> parityShifts_; // Per row: shift of the weight-3 parity column, -1 if absent
+    size_t maxDegree_;
+    size_t lanes_; // Z rounded up to whole SIMD registers; the extra lanes are computed and ignored
+
+    struct DecoderBuffers {
+        int16_t* posterior;
+        int16_t* messages;  // One lane vector per edge
+        int16_t* extrinsic; // One lane vector per edge of the current layer
+        int16_t* min1;
+        int16_t* min2;
+        uint8_t* minIndex;
+        uint8_t* sign;
+    };
+
+    void encodeBlock(const int* info, int* codeword, uint8_t* lambda) const;
+    size_t decodeBlock(const double* llrs, int* bits, const DecoderBuffers& buffers) const; // Returns iterations run
+    bool checksSatisfied(const int16_t* posterior, uint8_t* parity) const;
+
+public:
+    static constexpr double LLR_SCALE = 256.0;  // Mean quantized magnitude of a block's channel values
+    static constexpr int CHANNEL_LIMIT = 8191;  // Saturation of the quantized channel values
+    static constexpr int MESSAGE_LIMIT = 32000; // Saturation of posteriors and messages
+
+    // baseMatrix is row-major, rows x cols, shifts defined for lifting size baseZ.
+    // Other lifting sizes scale the shifts as floor(shift * Z / baseZ).
+    LdpcCode(const std::vector<int>& baseMatrix, size_t rows, size_t cols, size_t baseZ,
+             size_t liftingSize, size_t maxIterations = 20);
+    // 802.11n rate 1/2 code; Z = 27 is the standard n = 648 block
+    static LdpcCode ieee80211nRate12(size_t liftingSize = 27, size_t maxIterations = 20);
+
+    size_t encode(const int* bits, size_t numBits, int* encoded, Arena& scratch) const override;
+    size_t decode(const double* llrs, size_t numLlrs, int* bits, Arena& scratch) const override;
+    size_t encodedLength(size_t numBits) const override;
+    size_t decodedLength(size_t numLlrs) const override;
+    double getRate() const override;
+    // Syndrome of hard decisions (positive = 1) for one codeword, used by tests
+    bool isCodeword(const int* codeword) const;
+
+    size_t getInfoLength() const;  // Information bits per block
+    size_t getBlockLength() const; // Coded bits per block
+    size_t getLiftingSize() const;
+    size_t getMaxIterations() const;
+};
+
+#endif // LDPC_CODE_HPP
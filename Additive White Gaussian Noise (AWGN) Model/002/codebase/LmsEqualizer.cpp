@@ -0,0 +1,118 @@
+#include "LmsEqualizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+LmsEqualizer::LmsEqualizer(ModulationType modulation, size_t numTaps, double stepSize, bool normalized)
+    : modulation_(modulation), complex_(modulation != BPSK), numTaps_(numTaps), delay_(numTaps / 2),
+      stepSize_(stepSize), normalized_(normalized), trainingLeft_(0), position_(0) {
+    if (numTaps_ == 0) {
+        throw std::invalid_argument("Equalizer needs at least one tap");
+    }
+    if (!(stepSize_ > 0.0)) {
+        throw std::invalid_argument("Equalizer step size must be greater than 0");
+    }
+    tapI_.resize(numTaps_);
+    tapQ_.resize(numTaps_);
+    lineI_.resize(2 * numTaps_);
+    lineQ_.resize(2 * numTaps_);
+    reset();
+}
+
+double LmsEqualizer::slice(double value) const {
+    switch (modulation_) {
+        case QPSK: {
+            const double level = std::sqrt(2.0) / 2.0;
+            return value >= 0.0 ? level : -level;
+        }
+        case QAM16: {
+            const double scale = std::sqrt(10.0);
+            double level = 2.0 * std::floor(value * scale / 2.0) + 1.0;
+            return std::min(3.0, std::max(-3.0, level)) / scale;
+        }
+        default:
+            return value >= 0.0 ? 1.0 : -1.0;
+    }
+}
+
+void LmsEqualizer::push(double inI, double inQ) {
+    position_ = (position_ == 0 ? numTaps_ : position_) - 1;
+    lineI_[position_] = lineI_[position_ + numTaps_] = inI;
+    lineQ_[position_] = lineQ_[position_ + numTaps_] = inQ;
+}
+
+void LmsEqualizer::process(const double* received, size_t numValues, double* out, const double* reference) {
+    const size_t width = complex_ ? 2 : 1;
+    const size_t n = numValues / width;
+    double* tI = tapI_.data();
+    double* tQ = tapQ_.data();
+    for (size_t t = 0; t < n; ++t) {
+        push(received[width * t], complex_ ? received[width * t + 1] : 0.0);
+        const double* xI = lineI_.data() + position_; // xI[k] is the input k samples back
+        const double* xQ = lineQ_.data() + position_;
+
+        double yI = 0.0, yQ = 0.0, power = 0.0;
+        for (size_t k = 0; k < numTaps_; ++k) {
+            yI += tI[k] * xI[k] - tQ[k] * xQ[k];
+            yQ += tI[k] * xQ[k] + tQ[k] * xI[k];
+            power += xI[k] * xI[k] + xQ[k] * xQ[k];
+        }
+        if (!complex_) {
+            yQ = 0.0;
+        }
+
+        double wantI, wantQ;
+        if (trainingLeft_ > 0 && reference) {
+            --trainingLeft_;
+            wantI = reference[width * t];
+            wantQ = complex_ ? reference[width * t + 1] : 0.0;
+        } else {
+            wantI = slice(yI);
+            wantQ = complex_ ? slice(yQ) : 0.0;
+        }
+
+        // w += mu * e * conj(x)
+        double mu = normalized_ ? stepSize_ / (power + 1e-9) : stepSize_;
+        double eI = mu * (wantI - yI);
+        double eQ = mu * (wantQ - yQ);
+        for (size_t k = 0; k < numTaps_; ++k) {
+            tI[k] += eI * xI[k] + eQ * xQ[k];
+            tQ[k] += eQ * xI[k] - eI * xQ[k];
+        }
+
+        out[width * t] = yI;
+        if (complex_) {
+            out[width * t + 1] = yQ;
+        }
+    }
+}
+
+void LmsEqualizer::setTraining(size_t numSamples) {
+    trainingLeft_ = numSamples;
+}
+
+void LmsEqualizer::reset() {
+    std::fill(tapI_.begin(), tapI_.end(), 0.0);
+    std::fill(tapQ_.begin(), tapQ_.end(), 0.0);
+    tapI_[delay_] = 1.0;
+    std::fill(lineI_.begin(), lineI_.end(), 0.0);
+    std::fill(lineQ_.begin(), lineQ_.end(), 0.0);
+    position_ = 0;
+    trainingLeft_ = 0;
+}
+
+size_t LmsEqualizer::getDelay() const {
+    return delay_;
+}
+
+size_t LmsEqualizer::getNumTaps() const {
+    return numTaps_;
+}
+
+const std::vector<double>& LmsEqualizer::getTapsI() const {
+    return tapI_;
+}
+
+const std::vector<double>& LmsEqualizer::getTapsQ() const {
+    return tapQ_;
+}
@@ -0,0 +1,47 @@
+#ifndef LMS_EQUALIZER_HPP
+#define LMS_EQUALIZER_HPP
+
+#include <vector>
+#include <cstddef> // For size_t
+#include "ChannelModel.hpp"
+
+// Symbol-spaced adaptive transversal equalizer for the ChannelModel layouts:
+// BPSK is real, QPSK and 16-QAM are I/Q pairs. Run it on the received values
+// before the demappers; output t estimates the transmitted sample t - getDelay().
+//
+// While training lasts the taps adapt on the error against a known reference,
+// afterwards against the nearest constellation point (decision directed). NLMS
+// divides the step by the power in the delay line, so the step size does not
+// depend on the received level. Taps and delay line carry over between
+// process() calls, and nothing is allocated after construction.
+class LmsEqualizer {
+private:
+    ModulationType modulation_;
+    bool complex_;
+    size_t numTaps_;
+    size_t delay_;
+    double stepSize_;
+    bool normalized_;
+    size_t trainingLeft_;
+    std::vector<double> tapI_, tapQ_;
+    std::vector<double> lineI_, lineQ_; // Written twice, so the newest numTaps_ inputs are contiguous
+    size_t position_;
+
+    double slice(double value) const; // Nearest constellation level on one axis
+    void push(double inI, double inQ);
+
+public:
+    LmsEqualizer(ModulationType modulation, size_t numTaps = 11, double stepSize = 0.2, bool normalized = true);
+    void setTraining(size_t numSamples); // The next numSamples outputs adapt against the reference
+    // Equalizes numValues received values into out (same layout; may alias). reference
+    // holds the wanted outputs and is only read while training lasts; pass null to
+    // go decision directed.
+    void process(const double* received, size_t numValues, double* out, const double* reference = nullptr);
+    void reset(); // Center tap 1, other taps 0, empty delay line, no training
+    size_t getDelay() const; // Samples, complex samples for QPSK and 16-QAM
+    size_t getNumTaps() const;
+    const std::vector<double>& getTapsI() const;
+    const std::vector<double>& getTapsQ() const;
+};
+
+#endif // LMS_EQUALIZER_HPP
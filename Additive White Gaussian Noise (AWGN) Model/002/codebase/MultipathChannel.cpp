@@ -0,0 +1,230 @@
+#include "MultipathChannel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "CpuDispatch.hpp"
+
+namespace {
+    std::vector<MultipathTap> normalizePower(const std::vector<MultipathTap>& taps) {
+        if (taps.empty()) {
+            throw std::invalid_argument("Multipath profile needs at least one tap");
+        }
+        double power = 0.0;
+        for (const MultipathTap& tap : taps) {
+            power += tap.gainI * tap.gainI + tap.gainQ * tap.gainQ;
+        }
+        if (power <= 0.0) {
+            throw std::invalid_argument("Multipath profile must have non-zero power");
+        }
+        std::vector<MultipathTap> normalized(taps);
+        double scale = 1.0 / std::sqrt(power);
+        for (MultipathTap& tap : normalized) {
+            tap.gainI *= scale;
+            tap.gainQ *= scale;
+        }
+        return normalized;
+    }
+
+    size_t maxDelayOf(const std::vector<MultipathTap>& taps) {
+        size_t delay = 0;
+        for (const MultipathTap& tap : taps) {
+            delay = std::max(delay, tap.delay);
+        }
+        return delay;
+    }
+
+    size_t chooseFftSize(size_t numTaps, size_t maxDelay, double maxDoppler) {
+        // Fading taps change every sample, so only static profiles have a fixed spectrum
+        if (numTaps <= MultipathChannel::DIRECT_MAX_TAPS || maxDoppler > 0.0) {
+            return 1;
+        }
+        return FFT::nextPowerOfTwo(4 * (maxDelay + 1));
+    }
+
+    // Independent fading per tap, and no overlap with the seeds of neighbouring frames
+    unsigned int tapSeed(unsigned int seed, size_t tap) {
+        return seed ^ static_cast<unsigned int>(tap * 0x9E3779B9u);
+    }
+}
+
+MultipathChannel::MultipathChannel(const std::vector<MultipathTap>& taps, double maxDoppler, unsigned int seed)
+    : taps_(normalizePower(taps)), maxDelay_(maxDelayOf(taps_)),
+      fftSize_(chooseFftSize(taps_.size(), maxDelay_, maxDoppler)), fft_(fftSize_) {
+    if (maxDoppler > 0.0) {
+        for (size_t k = 0; k < taps_.size(); ++k) {
+            fading_.emplace_back(maxDoppler, 0.0, 16, tapSeed(seed, k));
+        }
+    }
+    if (fftSize_ > 1) {
+        spectrum_.assign(fftSize_, std::complex<double>(0.0, 0.0));
+        realSpectrum_.assign(fftSize_, std::complex<double>(0.0, 0.0));
+        for (const MultipathTap& tap : taps_) {
+            spectrum_[tap.delay] += std::complex<double>(tap.gainI, tap.gainQ);
+            realSpectrum_[tap.delay] += tap.gainI;
+        }
+        fft_.forward(spectrum_.data());
+        fft_.forward(realSpectrum_.data());
+        tail_.assign(maxDelay_, std::complex<double>(0.0, 0.0));
+    } else {
+        historyI_.assign(maxDelay_, 0.0);
+        historyQ_.assign(maxDelay_, 0.0);
+    }
+}
+
+void MultipathChannel::filterDirect(const double* xI, const double* xQ, size_t n, double* yI, double* yQ,
+                                    Arena& scratch) {
+    // Tap-inner loop over short blocks, as in NoiseShaper: the block stays in L1
+    // while every tap adds its delayed copy
+    const DspKernels& dsp = CpuDispatch::kernels();
+    const size_t BLOCK = FadingChannel::RESYNC_INTERVAL;
+    double* gainI = fading_.empty() ? nullptr : scratch.allocate<double>(BLOCK);
+    double* gainQ = fading_.empty() ? nullptr : scratch.allocate<double>(BLOCK);
+    std::fill(yI, yI + n, 0.0);
+    if (yQ) {
+        std::fill(yQ, yQ + n, 0.0);
+    }
+    for (size_t start = 0; start < n; start += BLOCK) {
+        size_t count = std::min(BLOCK, n - start);
+        for (size_t k = 0; k < taps_.size(); ++k) {
+            const MultipathTap& tap = taps_[k];
+            size_t offset = start + maxDelay_ - tap.delay;
+            const double* inQ = xQ ? xQ + offset : nullptr;
+            double* outQ = yQ ? yQ + start : nullptr;
+            if (fading_.empty()) {
+                dsp.addTap(xI + offset, inQ, tap.gainI, tap.gainQ, count, yI + start, outQ);
+                continue;
+            }
+            fading_[k].advance(count);
+            const double* fadeI = fading_[k].getGainI().data();
+            const double* fadeQ = fading_[k].getGainQ().data();
+            for (size_t i = 0; i < count; ++i) {
+                gainI[i] = tap.gainI * fadeI[i] - tap.gainQ * fadeQ[i];
+                gainQ[i] = tap.gainI * fadeQ[i] + tap.gainQ * fadeI[i];
+            }
+            dsp.addFadingTap(xI + offset, inQ, gainI, gainQ, count, yI + start, outQ);
+        }
+    }
+}
+
+void MultipathChannel::filterOverlapAdd(double* samples, size_t n, bool complex, Arena& scratch) {
+    const size_t N = fftSize_;
+    const size_t L = maxDelay_;
+    const size_t step = N - L;
+    const std::complex<double>* response = complex ? spectrum_.data() : realSpectrum_.data();
+    std::complex<double>* buffer = scratch.allocate<std::complex<double>>(N);
+
+    for (size_t pos = 0; pos < n; pos += step) {
+        size_t count = std::min(step, n - pos);
+        for (size_t j = 0; j < count; ++j) {
+            size_t t = pos + j;
+            buffer[j] = complex ? std::complex<double>(samples[2 * t], samples[2 * t + 1])
+                                : std::complex<double>(samples[t], 0.0);
+        }
+        std::fill(buffer + count, buffer + N, std::complex<double>(0.0, 0.0));
+        fft_.forward(buffer);
+        for (size_t j = 0; j < N; ++j) {
+            buffer[j] *= response[j];
+        }
+        fft_.inverse(buffer);
+
+        // The first `count` outputs are complete once the carried tail is added;
+        // the L after them spill into the next block, or the next call
+        for (size_t j = 0; j < count; ++j) {
+            std::complex<double> y = j < L ? buffer[j] + tail_[j] : buffer[j];
+            size_t t = pos + j;
+            if (complex) {
+                samples[2 * t] = y.real();
+                samples[2 * t + 1] = y.imag();
+            } else {
+                samples[t] = y.real();
+            }
+        }
+        for (size_t k = 0; k < L; ++k) {
+            tail_[k] = count + k < L ? buffer[count + k] + tail_[count + k] : buffer[count + k];
+        }
+    }
+}
+
+void MultipathChannel::apply(double* samples, size_t numValues, size_t stride, Arena& scratch) {
+    if (stride == 0) {
+        throw std::invalid_argument("Stride must be greater than 0");
+    }
+    const bool complex = stride > 1;
+    const size_t n = complex ? numValues / 2 : numValues;
+    if (n == 0) {
+        return;
+    }
+    if (fftSize_ > 1) {
+        filterOverlapAdd(samples, n, complex, scratch);
+        return;
+    }
+
+    // Split I/Q behind the saved delay line, so every tap reads a contiguous window
+    const size_t L = maxDelay_;
+    double* xI = scratch.allocate<double>(L + n);
+    double* xQ = complex ? scratch.allocate<double>(L + n) : nullptr;
+    double* yI = scratch.allocate<double>(n);
+    double* yQ = complex ? scratch.allocate<double>(n) : nullptr;
+    std::copy(historyI_.begin(), historyI_.end(), xI);
+    if (complex) {
+        std::copy(historyQ_.begin(), historyQ_.end(), xQ);
+        for (size_t t = 0; t < n; ++t) {
+            xI[L + t] = samples[2 * t];
+            xQ[L + t] = samples[2 * t + 1];
+        }
+    } else {
+        std::copy(samples, samples + n, xI + L);
+    }
+
+    filterDirect(xI, xQ, n, yI, yQ, scratch);
+
+    std::copy(xI + n, xI + n + L, historyI_.begin());
+    if (complex) {
+        std::copy(xQ + n, xQ + n + L, historyQ_.begin());
+        for (size_t t = 0; t < n; ++t) {
+            samples[2 * t] = yI[t];
+            samples[2 * t + 1] = yQ[t];
+        }
+    } else {
+        std::copy(yI, yI + n, samples);
+    }
+}
+
+std::vector<double> MultipathChannel::apply(const std::vector<double>& signal, size_t stride) {
+    std::vector<double> received(signal);
+    Arena scratch;
+    apply(received.data(), received.size(), stride, scratch);
+    return received;
+}
+
+void MultipathChannel::reset() {
+    std::fill(historyI_.begin(), historyI_.end(), 0.0);
+    std::fill(historyQ_.begin(), historyQ_.end(), 0.0);
+    std::fill(tail_.begin(), tail_.end(), std::complex<double>(0.0, 0.0));
+    for (FadingChannel& fading : fading_) {
+        fading.reset();
+    }
+}
+
+void MultipathChannel::reset(unsigned int seed) {
+    reset();
+    for (size_t k = 0; k < fading_.size(); ++k) {
+        fading_[k].reset(tapSeed(seed, k));
+    }
+}
+
+const std::vector<MultipathTap>& MultipathChannel::getTaps() const {
+    return taps_;
+}
+
+size_t MultipathChannel::getMaxDelay() const {
+    return maxDelay_;
+}
+
+bool MultipathChannel::isTimeVarying() const {
+    return !fading_.empty();
+}
+
+bool MultipathChannel::usesFft() const {
+    return fftSize_ > 1;
+}
@@ -0,0 +1,57 @@
+#ifndef MULTIPATH_CHANNEL_HPP
+#define MULTIPATH_CHANNEL_HPP
+
+#include <vector>
+#include <complex>
+#include <cstddef> // For size_t
+#include "FFT.hpp"
+#include "Arena.hpp"
+#include "FadingChannel.hpp"
+
+struct MultipathTap {
+    size_t delay; // In samples
+    double gainI;
+    double gainQ;
+};
+
+// Tapped-delay-line multipath, y[t] = sum over taps of h(t) * x[t - delay].
+// Apply before AWGN::addNoise. Samples use the FadingChannel layout: stride 1 is
+// real and sees only the in-phase part of each tap, stride 2 or 4 is I/Q pairs.
+// Tap powers are normalized to sum to 1, so the mean received power equals the
+// transmit power.
+//
+// With maxDoppler > 0 every tap also fades on its own (Rayleigh, FadingChannel).
+// Static profiles with more than DIRECT_MAX_TAPS taps run as FFT overlap-add,
+// the rest as a direct FIR. apply() carries the delay line or overlap tail into
+// the next call, so a stream can go through in blocks; work buffers come from
+// the Arena and the members never grow after construction.
+class MultipathChannel {
+private:
+    std::vector<MultipathTap> taps_;
+    size_t maxDelay_;
+    size_t fftSize_; // 1 for the direct form
+    FFT fft_;
+    std::vector<std::complex<double>> spectrum_;     // Tap response for complex signals
+    std::vector<std::complex<double>> realSpectrum_; // In-phase parts only, for real signals
+    std::vector<FadingChannel> fading_;              // One per tap, empty for static taps
+    std::vector<double> historyI_, historyQ_;        // Last maxDelay_ inputs (direct form)
+    std::vector<std::complex<double>> tail_;         // Overlap-add carry (FFT form)
+
+    void filterDirect(const double* xI, const double* xQ, size_t n, double* yI, double* yQ, Arena& scratch);
+    void filterOverlapAdd(double* samples, size_t n, bool complex, Arena& scratch);
+
+public:
+    static constexpr size_t DIRECT_MAX_TAPS = 64;
+
+    explicit MultipathChannel(const std::vector<MultipathTap>& taps, double maxDoppler = 0.0, unsigned int seed = 0);
+    void apply(double* samples, size_t numValues, size_t stride, Arena& scratch); // In place
+    std::vector<double> apply(const std::vector<double>& signal, size_t stride);
+    void reset(); // Empty delay line, fading restarted
+    void reset(unsigned int seed); // As if constructed with `seed`, without reallocating
+    const std::vector<MultipathTap>& getTaps() const; // Normalized
+    size_t getMaxDelay() const;
+    bool isTimeVarying() const;
+    bool usesFft() const;
+};
+
+#endif // MULTIPATH_CHANNEL_HPP
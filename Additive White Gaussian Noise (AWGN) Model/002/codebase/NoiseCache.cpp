@@ -0,0 +1,65 @@
+#include "NoiseCache.hpp"
+
+bool NoiseKey::operator==(const NoiseKey& other) const {
+    return seed == other.seed && length == other.length && layout == other.layout;
+}
+
+size_t NoiseKeyHash::operator()(const NoiseKey& key) const {
+    uint64_t h = key.layout;
+    h ^= (static_cast<uint64_t>(key.seed) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    h ^= (static_cast<uint64_t>(key.length) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    return static_cast<size_t>(h);
+}
+
+NoiseCache::NoiseCache(size_t capacityBytes)
+    : capacityBytes_(capacityBytes), usedBytes_(0), hits_(0), misses_(0) {}
+
+void NoiseCache::evictFor(size_t bytes) {
+    while (!entries_.empty() && usedBytes_ + bytes > capacityBytes_) {
+        const Entry& victim = entries_.back();
+        usedBytes_ -= victim.samples.size() * sizeof(double);
+        index_.erase(victim.key);
+        entries_.pop_back();
+    }
+}
+
+const std::vector<double>& NoiseCache::get(const NoiseKey& key, const std::function<void(double*, size_t)>& generate) {
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->samples;
+    }
+
+    ++misses_;
+    // A block larger than the whole budget is still returned; it simply evicts everything else
+    size_t bytes = key.length * sizeof(double);
+    evictFor(bytes);
+    entries_.push_front(Entry{key, std::vector<double>(key.length)});
+    generate(entries_.front().samples.data(), key.length);
+    index_[key] = entries_.begin();
+    usedBytes_ += bytes;
+    return entries_.front().samples;
+}
+
+void NoiseCache::clear() {
+    entries_.clear();
+    index_.clear();
+    usedBytes_ = 0;
+}
+
+size_t NoiseCache::getUsedBytes() const {
+    return usedBytes_;
+}
+
+size_t NoiseCache::getCapacityBytes() const {
+    return capacityBytes_;
+}
+
+size_t NoiseCache::getHits() const {
+    return hits_;
+}
+
+size_t NoiseCache::getMisses() const {
+    return misses_;
+}
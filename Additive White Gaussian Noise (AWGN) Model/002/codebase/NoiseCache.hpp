@@ -0,0 +1,52 @@
+#ifndef NOISE_CACHE_HPP
+#define NOISE_CACHE_HPP
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <cstddef> // For size_t
+
+// Identifies a block of unit-variance noise: the same key always yields the same samples
+struct NoiseKey {
+    unsigned int seed;
+    size_t length;
+    uint64_t layout; // Generator/shaping fingerprint, 0 for white Box-Muller noise
+    bool operator==(const NoiseKey& other) const;
+};
+
+struct NoiseKeyHash {
+    size_t operator()(const NoiseKey& key) const;
+};
+
+// LRU cache of unit-noise blocks bounded by a byte budget. An SNR sweep with a
+// fixed seed draws the same standard-normal sequence at every point; with the
+// cache only the first point pays for the RNG and later points just rescale.
+class NoiseCache {
+private:
+    struct Entry {
+        NoiseKey key;
+        std::vector<double> samples;
+    };
+    size_t capacityBytes_;
+    size_t usedBytes_;
+    std::list<Entry> entries_; // Most recently used first
+    std::unordered_map<NoiseKey, std::list<Entry>::iterator, NoiseKeyHash> index_;
+    size_t hits_;
+    size_t misses_;
+    void evictFor(size_t bytes);
+
+public:
+    explicit NoiseCache(size_t capacityBytes = size_t(256) << 20);
+    // Returns the block for `key`, calling generate(out, length) to fill it on a miss.
+    // The reference stays valid until the next call to get() or clear().
+    const std::vector<double>& get(const NoiseKey& key, const std::function<void(double*, size_t)>& generate);
+    void clear();
+    size_t getUsedBytes() const;
+    size_t getCapacityBytes() const;
+    size_t getHits() const;
+    size_t getMisses() const;
+};
+
+#endif // NOISE_CACHE_HPP
@@ -0,0 +1,243 @@
+#include "NoisePool.hpp"
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+NoisePool::Lease::Lease() : pool_(nullptr), slab_(0), data_(nullptr) {}
+
+NoisePool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), slab_(other.slab_), data_(other.data_), own_(std::move(other.own_)) {
+    other.pool_ = nullptr;
+    other.data_ = nullptr;
+}
+
+NoisePool::Lease& NoisePool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        slab_ = other.slab_;
+        data_ = other.data_;
+        own_ = std::move(other.own_);
+        other.pool_ = nullptr;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+NoisePool::Lease::~Lease() {
+    release();
+}
+
+const double* NoisePool::Lease::data() const {
+    return data_;
+}
+
+void NoisePool::Lease::release() {
+    if (pool_) {
+        pool_->release(slab_);
+        pool_ = nullptr;
+    }
+    data_ = nullptr;
+    own_.clear();
+}
+
+NoisePool::NoisePool(size_t numSlabs, size_t numThreads)
+    : stopping_(false), clock_(0), hits_(0), waits_(0), misses_(0) {
+    if (numSlabs < 2) {
+        throw std::invalid_argument("Noise pool needs at least 2 slabs");
+    }
+    if (numThreads == 0) {
+        throw std::invalid_argument("Noise pool needs at least 1 thread");
+    }
+    slabs_.resize(numSlabs, Slab{NoiseKey{0, 0, 0}, FREE, nullptr, 0, Generator(), 0});
+    for (size_t t = 0; t < numThreads; ++t) {
+        workers_.emplace_back(&NoisePool::work, this);
+    }
+}
+
+NoisePool::~NoisePool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    for (Slab& slab : slabs_) {
+        ::operator delete(slab.data, std::align_val_t(SLAB_ALIGNMENT));
+    }
+}
+
+void NoisePool::reserve(Slab& slab, size_t length) {
+    if (slab.capacity >= length) {
+        return;
+    }
+    ::operator delete(slab.data, std::align_val_t(SLAB_ALIGNMENT));
+    slab.data = nullptr;
+    slab.capacity = 0;
+    slab.data = static_cast<double*>(::operator new(length * sizeof(double), std::align_val_t(SLAB_ALIGNMENT)));
+    slab.capacity = length;
+}
+
+NoisePool::Slab* NoisePool::find(const NoiseKey& key) {
+    for (Slab& slab : slabs_) {
+        if ((slab.state == QUEUED || slab.state == GENERATING || slab.state == READY) && slab.key == key) {
+            return &slab;
+        }
+    }
+    return nullptr;
+}
+
+NoisePool::Slab* NoisePool::claim(const NoiseKey& current) {
+    Slab* victim = nullptr;
+    for (Slab& slab : slabs_) {
+        if (slab.state == FREE) {
+            return &slab;
+        }
+        // Keep blocks that the caller is about to ask for
+        bool ahead = slab.key.length == current.length && slab.key.layout == current.layout &&
+                     slab.key.seed - current.seed < slabs_.size();
+        if (slab.state == READY && !ahead && (!victim || slab.lastUsed < victim->lastUsed)) {
+            victim = &slab;
+        }
+    }
+    return victim;
+}
+
+void NoisePool::prefetch(const NoiseKey& key, const Generator& generate) {
+    bool queued = false;
+    for (size_t ahead = 1; ahead < slabs_.size(); ++ahead) {
+        NoiseKey next{key.seed + static_cast<unsigned int>(ahead), key.length, key.layout};
+        if (find(next)) {
+            continue;
+        }
+        Slab* slab = claim(key);
+        if (!slab) {
+            break;
+        }
+        slab->key = next;
+        slab->state = QUEUED;
+        slab->generate = generate;
+        queue_.push_back(static_cast<size_t>(slab - slabs_.data()));
+        queued = true;
+    }
+    if (queued) {
+        changed_.notify_all();
+    }
+}
+
+NoisePool::Lease NoisePool::acquire(const NoiseKey& key, const Generator& generate, Arena& scratch) {
+    Lease lease;
+    std::unique_lock<std::mutex> lock(mutex_);
+    Slab* slab = find(key);
+    bool waited = false;
+    while (slab && slab->state == GENERATING) {
+        waited = true;
+        changed_.wait(lock, [&] { return slab->state != GENERATING; });
+        slab = find(key); // It may have failed, or gone to another caller
+    }
+
+    bool generateHere = true;
+    if (slab && slab->state == READY) {
+        ++(waited ? waits_ : hits_);
+        generateHere = false;
+    } else if (slab) {
+        // Still queued: no worker has started it, so it is quicker to do it here
+        queue_.erase(std::find(queue_.begin(), queue_.end(), static_cast<size_t>(slab - slabs_.data())));
+        slab->generate = Generator();
+        ++misses_;
+    } else {
+        slab = claim(key);
+        ++misses_;
+    }
+
+    if (slab) {
+        slab->key = key;
+        slab->state = LEASED;
+        slab->lastUsed = ++clock_;
+        lease.pool_ = this;
+        lease.slab_ = static_cast<size_t>(slab - slabs_.data());
+    }
+    prefetch(key, generate);
+    lock.unlock();
+
+    if (!slab) {
+        lease.own_.resize(key.length);
+        generate(key.seed, lease.own_.data(), key.length, scratch);
+        lease.data_ = lease.own_.data();
+    } else if (generateHere) {
+        try {
+            reserve(*slab, key.length);
+            generate(key.seed, slab->data, key.length, scratch);
+        } catch (...) {
+            std::lock_guard<std::mutex> relock(mutex_);
+            slab->state = FREE;
+            lease.pool_ = nullptr;
+            throw;
+        }
+        lease.data_ = slab->data;
+    } else {
+        lease.data_ = slab->data;
+    }
+    return lease;
+}
+
+void NoisePool::release(size_t slab) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Stays readable until claimed, so a repeated seed is a hit
+    slabs_[slab].state = READY;
+    slabs_[slab].lastUsed = ++clock_;
+}
+
+void NoisePool::work() {
+    Arena scratch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        changed_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        Slab& slab = slabs_[queue_.front()];
+        queue_.pop_front();
+        slab.state = GENERATING;
+        NoiseKey key = slab.key;
+        Generator generate = std::move(slab.generate);
+        slab.generate = Generator();
+        lock.unlock();
+
+        bool ok = true;
+        try {
+            reserve(slab, key.length);
+            scratch.reset();
+            generate(key.seed, slab.data, key.length, scratch);
+        } catch (...) {
+            ok = false; // The caller will generate it itself
+        }
+
+        lock.lock();
+        slab.state = ok ? READY : FREE;
+        slab.lastUsed = ++clock_;
+        changed_.notify_all();
+    }
+}
+
+size_t NoisePool::getNumSlabs() const {
+    return slabs_.size();
+}
+
+size_t NoisePool::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t NoisePool::getWaits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waits_;
+}
+
+size_t NoisePool::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
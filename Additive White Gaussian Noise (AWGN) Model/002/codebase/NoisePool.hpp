@@ -0,0 +1,94 @@
+#ifndef NOISE_POOL_HPP
+#define NOISE_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "Arena.hpp"
+#include "NoiseCache.hpp"
+
+// Generates unit-noise blocks ahead of AWGN::addNoise on background threads.
+// Blocks live in a fixed set of 64-byte aligned slabs, keyed like NoiseCache.
+// Taking the block for seed s queues s + 1, s + 2, ... (same length and
+// layout) into the free slabs, so a caller that walks seeds in order, like the
+// streaming channel with seed + block, finds its next block ready and only
+// scales and adds. With the default two slabs one is read while the other fills.
+//
+// A block is the same whether a worker or the caller generated it, so results
+// do not depend on the pool. Leases must not outlive the pool.
+class NoisePool {
+public:
+    using Generator = std::function<void(unsigned int seed, double* out, size_t n, Arena& scratch)>;
+
+    class Lease {
+    private:
+        NoisePool* pool_;
+        size_t slab_;
+        const double* data_;
+        std::vector<double> own_; // When every slab was taken
+        friend class NoisePool;
+
+    public:
+        Lease();
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+        const double* data() const;
+        void release(); // Hands the slab back; data() is null afterwards
+    };
+
+    explicit NoisePool(size_t numSlabs = 2, size_t numThreads = 1);
+    ~NoisePool();
+    NoisePool(const NoisePool&) = delete;
+    NoisePool& operator=(const NoisePool&) = delete;
+
+    // Block for `key`: ready, waited for, or generated now with `scratch`.
+    // Then queues the following seeds using the same generator.
+    Lease acquire(const NoiseKey& key, const Generator& generate, Arena& scratch);
+
+    size_t getNumSlabs() const;
+    size_t getHits() const;   // Block was ready
+    size_t getWaits() const;  // Block was still being generated
+    size_t getMisses() const; // Generated by the caller
+
+private:
+    static constexpr size_t SLAB_ALIGNMENT = 64;
+
+    enum SlabState { FREE, QUEUED, GENERATING, READY, LEASED };
+
+    struct Slab {
+        NoiseKey key;
+        SlabState state;
+        double* data;
+        size_t capacity;
+        Generator generate; // Set while queued
+        uint64_t lastUsed;
+    };
+
+    std::vector<Slab> slabs_;
+    std::deque<size_t> queue_;
+    std::vector<std::thread> workers_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    bool stopping_;
+    uint64_t clock_;
+    size_t hits_;
+    size_t waits_;
+    size_t misses_;
+
+    static void reserve(Slab& slab, size_t length); // Owner only, without the lock
+    Slab* find(const NoiseKey& key);
+    Slab* claim(const NoiseKey& current);
+    void prefetch(const NoiseKey& key, const Generator& generate);
+    void release(size_t slab);
+    void work();
+};
+
+#endif // NOISE_POOL_HPP
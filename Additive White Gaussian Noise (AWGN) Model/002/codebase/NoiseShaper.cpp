@@ -0,0 +1,175 @@
+#include "NoiseShaper.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include "Common.hpp"
+
+namespace {
+    std::vector<double> normalizeEnergy(const std::vector<double>& taps) {
+        if (taps.empty()) {
+            throw std::invalid_argument("Noise shaping filter must have at least one tap");
+        }
+        double energy = std::accumulate(taps.begin(), taps.end(), 0.0,
+            [](double sum, double x) { return sum + x * x; });
+        if (energy <= 0.0) {
+            throw std::invalid_argument("Noise shaping filter must have non-zero energy");
+        }
+        std::vector<double> normalized(taps);
+        double scale = 1.0 / std::sqrt(energy);
+        for (auto& tap : normalized) {
+            tap *= scale;
+        }
+        return normalized;
+    }
+
+    size_t chooseFftSize(size_t numTaps) {
+        // Direct form needs no transform; otherwise keep at least 3/4 of each block useful
+        return numTaps <= NoiseShaper::DIRECT_MAX_TAPS ? 1 : FFT::nextPowerOfTwo(4 * numTaps);
+    }
+}
+
+NoiseShaper::NoiseShaper(const std::vector<double>& taps)
+    : taps_(normalizeEnergy(taps)), fftSize_(chooseFftSize(taps.size())), fft_(fftSize_) {
+    if (fftSize_ > 1) {
+        tapSpectrum_.assign(fftSize_, std::complex<double>(0.0, 0.0));
+        for (size_t k = 0; k < taps_.size(); ++k) {
+            tapSpectrum_[k] = taps_[k];
+        }
+        fft_.forward(tapSpectrum_.data());
+    }
+}
+
+NoiseShaper NoiseShaper::lowpass(double bandwidth, size_t numTaps) {
+    if (bandwidth <= 0.0) {
+        throw std::invalid_argument("Bandwidth must be greater than 0");
+    }
+    numTaps |= 1; // Odd length keeps the filter linear-phase with an integer delay
+    double fc = std::min(bandwidth, 0.5);
+    double center = (numTaps - 1) / 2.0;
+
+    // Blackman-windowed sinc
+    std::vector<double> taps(numTaps);
+    for (size_t k = 0; k < numTaps; ++k) {
+        double t = k - center;
+        double sinc = (t == 0.0) ? 1.0 : std::sin(2.0 * Constants::PI * fc * t) / (2.0 * Constants::PI * fc * t);
+        double phase = 2.0 * Constants::PI * k / (numTaps > 1 ? numTaps - 1 : 1);
+        double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        taps[k] = 2.0 * fc * sinc * window;
+    }
+    return NoiseShaper(taps);
+}
+
+NoiseShaper NoiseShaper::fromPsdMask(const std::vector<double>& mask, size_t numTaps) {
+    if (mask.size() < 2) {
+        throw std::invalid_argument("PSD mask needs at least two points");
+    }
+    numTaps |= 1;
+
+    // Frequency sampling: zero-phase magnitude sqrt(mask), then window to numTaps
+    size_t n = FFT::nextPowerOfTwo(std::max(4 * numTaps, 2 * (mask.size() - 1)));
+    std::vector<std::complex<double>> spectrum(n);
+    for (size_t b = 0; b <= n / 2; ++b) {
+        double pos = (static_cast<double>(b) / (n / 2)) * (mask.size() - 1);
+        size_t lo = std::min(static_cast<size_t>(pos), mask.size() - 2);
+        double frac = pos - lo;
+        double power = mask[lo] * (1.0 - frac) + mask[lo + 1] * frac;
+        double amplitude = std::sqrt(std::max(power, 0.0));
+        spectrum[b] = amplitude;
+        if (b > 0 && b < n / 2) spectrum[n - b] = amplitude;
+    }
+    FFT(n).inverse(spectrum.data());
+
+    double center = (numTaps - 1) / 2.0;
+    std::vector<double> taps(numTaps);
+    for (size_t k = 0; k < numTaps; ++k) {
+        long offset = static_cast<long>(k) - static_cast<long>(center);
+        size_t index = static_cast<size_t>((offset + static_cast<long>(n)) % static_cast<long>(n));
+        double window = 0.5 - 0.5 * std::cos(2.0 * Constants::PI * (k + 1) / (numTaps + 1)); // Hann
+        taps[k] = spectrum[index].real() * window;
+    }
+    return NoiseShaper(taps);
+}
+
+void NoiseShaper::filterDirect(const double* in, double* out, size_t n) const {
+    // Tap-outer loop over short output blocks: the inner loop is a contiguous
+    // multiply-add the compiler vectorizes, and the block stays in L1.
+    const size_t L = taps_.size();
+    const size_t BLOCK = 1024;
+    for (size_t start = 0; start < n; start += BLOCK) {
+        size_t count = std::min(BLOCK, n - start);
+        double* y = out + start;
+        std::fill(y, y + count, 0.0);
+        for (size_t k = 0; k < L; ++k) {
+            const double c = taps_[k];
+            const double* x = in + start + (L - 1 - k);
+            for (size_t i = 0; i < count; ++i) {
+                y[i] += c * x[i];
+            }
+        }
+    }
+}
+
+void NoiseShaper::filterOverlapSave(const double* in, double* out, size_t n, std::complex<double>* buffer) const {
+    const size_t L = taps_.size();
+    const size_t N = fftSize_;
+    const size_t step = N - L + 1;
+    const size_t inLength = n + L - 1;
+
+    // Two real segments ride in one complex transform: the taps are real, so the
+    // real and imaginary parts of the result are the two filtered segments.
+    for (size_t pos = 0; pos < n; pos += 2 * step) {
+        for (size_t j = 0; j < N; ++j) {
+            size_t a = pos + j;
+            size_t b = pos + step + j;
+            buffer[j] = std::complex<double>(a < inLength ? in[a] : 0.0, b < inLength ? in[b] : 0.0);
+        }
+        fft_.forward(buffer);
+        for (size_t j = 0; j < N; ++j) {
+            buffer[j] *= tapSpectrum_[j];
+        }
+        fft_.inverse(buffer);
+
+        size_t first = std::min(step, n - pos);
+        for (size_t j = 0; j < first; ++j) {
+            out[pos + j] = buffer[L - 1 + j].real();
+        }
+        if (pos + step < n) {
+            size_t second = std::min(step, n - pos - step);
+            for (size_t j = 0; j < second; ++j) {
+                out[pos + step + j] = buffer[L - 1 + j].imag();
+            }
+        }
+    }
+}
+
+void NoiseShaper::apply(const double* in, double* out, size_t n) const {
+    Arena scratch;
+    apply(in, out, n, scratch);
+}
+
+void NoiseShaper::apply(const double* in, double* out, size_t n, Arena& scratch) const {
+    if (fftSize_ > 1) {
+        filterOverlapSave(in, out, n, scratch.allocate<std::complex<double>>(fftSize_));
+    } else {
+        filterDirect(in, out, n);
+    }
+}
+
+std::vector<double> NoiseShaper::apply(const std::vector<double>& noise) const {
+    size_t history = getHistoryLength();
+    if (noise.size() < history) {
+        return std::vector<double>();
+    }
+    std::vector<double> shaped(noise.size() - history);
+    apply(noise.data(), shaped.data(), shaped.size());
+    return shaped;
+}
+
+size_t NoiseShaper::getHistoryLength() const {
+    return taps_.size() - 1;
+}
+
+const std::vector<double>& NoiseShaper::getTaps() const {
+    return taps_;
+}
@@ -0,0 +1,39 @@
+#ifndef NOISE_SHAPER_HPP
+#define NOISE_SHAPER_HPP
+
+#include <vector>
+#include <complex>
+#include <cstddef> // For size_t
+#include "FFT.hpp"
+#include "Arena.hpp"
+
+// Shapes unit-variance white noise with a FIR filter normalized to unit energy,
+// so the noise power set by the SNR controller is preserved inside the band.
+// Short filters run as a direct FIR, long ones as FFT overlap-save.
+class NoiseShaper {
+private:
+    std::vector<double> taps_;
+    size_t fftSize_;
+    std::vector<std::complex<double>> tapSpectrum_;
+    FFT fft_;
+    void filterDirect(const double* in, double* out, size_t n) const;
+    void filterOverlapSave(const double* in, double* out, size_t n, std::complex<double>* buffer) const;
+
+public:
+    static constexpr size_t DIRECT_MAX_TAPS = 64;
+
+    explicit NoiseShaper(const std::vector<double>& taps);
+    // Lowpass to the given bandwidth (cycles per sample, clamped to 0.5)
+    static NoiseShaper lowpass(double bandwidth, size_t numTaps = 63);
+    // Arbitrary PSD mask, linear power sampled uniformly from 0 to 0.5 cycles per sample
+    static NoiseShaper fromPsdMask(const std::vector<double>& mask, size_t numTaps = 255);
+
+    // Filters in[0 .. n + getHistoryLength()) into out[0 .. n) (valid convolution)
+    void apply(const double* in, double* out, size_t n) const;
+    void apply(const double* in, double* out, size_t n, Arena& scratch) const; // FFT work buffer from scratch
+    std::vector<double> apply(const std::vector<double>& noise) const;
+    size_t getHistoryLength() const;
+    const std::vector<double>& getTaps() const;
+};
+
+#endif // NOISE_SHAPER_HPP
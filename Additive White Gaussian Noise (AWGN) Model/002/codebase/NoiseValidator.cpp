@@ -0,0 +1,361 @@
+#include "NoiseValidator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include "CpuDispatch.hpp"
+
+namespace {
+    double normalCdf(double x) {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    // Two-sided p-value of a standard normal z-score
+    double normalPValue(double z) {
+        return std::erfc(std::fabs(z) / std::sqrt(2.0));
+    }
+
+    // Asymptotic Kolmogorov distribution, P(sqrt(n) D > x)
+    double kolmogorovPValue(double x) {
+        if (x < 0.2) {
+            return 1.0;
+        }
+        double p = 0.0;
+        for (int k = 1; k <= 100; ++k) {
+            double term = std::exp(-2.0 * k * k * x * x);
+            p += (k % 2 ? 2.0 : -2.0) * term;
+            if (term < 1e-300) {
+                break;
+            }
+        }
+        return std::min(1.0, std::max(0.0, p));
+    }
+
+    // Asymptotic Anderson-Darling distribution (Marsaglia and Marsaglia, 2004), P(A^2 > z)
+    double andersonDarlingPValue(double z) {
+        if (z <= 0.0) {
+            return 1.0;
+        }
+        double cdf;
+        if (z < 2.0) {
+            cdf = std::exp(-1.2337141 / z) / std::sqrt(z) *
+                  (2.00012 + (0.247105 - (0.0649821 - (0.0347962 - (0.011672 - 0.00168691 * z) * z) * z) * z) * z);
+        } else {
+            cdf = std::exp(-std::exp(1.0776 - (2.30695 - (0.43424 - (0.082433 - (0.008056 - 0.0003146 * z) * z) * z) * z) * z));
+        }
+        return std::min(1.0, std::max(0.0, 1.0 - cdf));
+    }
+
+    double poissonTerm(uint64_t k, double lambda) {
+        double j = static_cast<double>(k);
+        return std::exp(j * std::log(lambda) - lambda - std::lgamma(j + 1.0));
+    }
+
+    // P(X >= k) and P(X <= k) for X ~ Poisson(lambda), summed exactly while the
+    // terms matter; large means use the normal approximation
+    double poissonUpper(uint64_t k, double lambda);
+
+    double poissonLower(uint64_t k, double lambda) {
+        if (lambda > 1000.0) {
+            return normalCdf((static_cast<double>(k) + 0.5 - lambda) / std::sqrt(lambda));
+        }
+        if (static_cast<double>(k) >= lambda) {
+            return 1.0 - poissonUpper(k + 1, lambda);
+        }
+        double sum = 0.0;
+        for (uint64_t j = 0; j <= k; ++j) {
+            sum += poissonTerm(j, lambda);
+        }
+        return std::min(1.0, sum);
+    }
+
+    double poissonUpper(uint64_t k, double lambda) {
+        if (k == 0) {
+            return 1.0;
+        }
+        if (lambda > 1000.0) {
+            return 1.0 - normalCdf((static_cast<double>(k) - 0.5 - lambda) / std::sqrt(lambda));
+        }
+        if (static_cast<double>(k) <= lambda) {
+            return 1.0 - poissonLower(k - 1, lambda);
+        }
+        // Terms only shrink above the mean
+        double sum = 0.0;
+        for (uint64_t j = k;; ++j) {
+            double term = poissonTerm(j, lambda);
+            sum += term;
+            if (term <= sum * 1e-17) {
+                break;
+            }
+        }
+        return std::min(1.0, sum);
+    }
+
+    double poissonPValue(uint64_t observed, double lambda) {
+        return std::min(1.0, 2.0 * std::min(poissonUpper(observed, lambda), poissonLower(observed, lambda)));
+    }
+}
+
+NoiseValidator::NoiseValidator(size_t maxLag) : maxLag_(maxLag) {
+    counts_.resize(4 * numBins());
+    lagSums_.resize(maxLag_);
+    products_.resize(maxLag_);
+    work_.resize(maxLag_ + CHUNK);
+    index_.resize(CHUNK);
+    reset();
+}
+
+size_t NoiseValidator::numBins() {
+    return static_cast<size_t>(2.0 * RANGE) * BINS_PER_SIGMA + 2;
+}
+
+void NoiseValidator::reset() {
+    count_ = 0;
+    std::fill(sums_, sums_ + 4, 0.0L);
+    std::fill(counts_.begin(), counts_.end(), 0);
+    std::fill(lagSums_.begin(), lagSums_.end(), 0.0);
+    lagPairs_ = 0;
+    historyFill_ = 0;
+}
+
+void NoiseValidator::breakStream() {
+    historyFill_ = 0;
+}
+
+void NoiseValidator::add(const double* samples, size_t n) {
+    for (size_t start = 0; start < n; start += CHUNK) {
+        addChunk(samples + start, std::min(CHUNK, n - start));
+    }
+}
+
+void NoiseValidator::addChunk(const double* x, size_t n) {
+    const DspKernels& dsp = CpuDispatch::kernels();
+    double sums[4];
+    dsp.powerSums(x, n, sums);
+    for (size_t p = 0; p < 4; ++p) {
+        sums_[p] += sums[p];
+    }
+    count_ += n;
+
+    // Bin i + 1 holds [-RANGE + i / BINS_PER_SIGMA, -RANGE + (i + 1) / BINS_PER_SIGMA)
+    const uint32_t last = static_cast<uint32_t>(numBins() - 1);
+    const double scale = static_cast<double>(BINS_PER_SIGMA);
+    dsp.binIndices(x, n, scale, RANGE * scale + 1.0, last, index_.data());
+    const size_t stride = numBins();
+    uint64_t* counts = counts_.data();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        ++counts[index_[i]];
+        ++counts[stride + index_[i + 1]];
+        ++counts[2 * stride + index_[i + 2]];
+        ++counts[3 * stride + index_[i + 3]];
+    }
+    for (; i < n; ++i) {
+        ++counts[index_[i]];
+    }
+
+    if (maxLag_ == 0) {
+        return;
+    }
+    // The first maxLag samples of a stream only fill the history
+    size_t skip = 0;
+    if (historyFill_ < maxLag_) {
+        skip = std::min(maxLag_ - historyFill_, n);
+        std::copy(x, x + skip, work_.begin() + historyFill_);
+        historyFill_ += skip;
+    }
+    size_t fresh = n - skip;
+    if (fresh == 0) {
+        return;
+    }
+    std::copy(x + skip, x + n, work_.begin() + maxLag_);
+    dsp.lagProducts(work_.data(), fresh, maxLag_, products_.data());
+    for (size_t lag = 0; lag < maxLag_; ++lag) {
+        lagSums_[lag] += products_[lag];
+    }
+    lagPairs_ += fresh;
+    std::copy(work_.begin() + fresh, work_.begin() + fresh + maxLag_, work_.begin());
+}
+
+void NoiseValidator::merge(const NoiseValidator& other) {
+    if (other.maxLag_ != maxLag_) {
+        throw std::invalid_argument("Noise validators must use the same number of lags");
+    }
+    count_ += other.count_;
+    for (size_t p = 0; p < 4; ++p) {
+        sums_[p] += other.sums_[p];
+    }
+    for (size_t b = 0; b < counts_.size(); ++b) {
+        counts_[b] += other.counts_[b];
+    }
+    for (size_t lag = 0; lag < maxLag_; ++lag) {
+        lagSums_[lag] += other.lagSums_[lag];
+    }
+    lagPairs_ += other.lagPairs_;
+}
+
+NoiseValidationReport NoiseValidator::report(double significance) const {
+    if (count_ < 2) {
+        throw std::logic_error("Noise validation needs at least 2 samples");
+    }
+    if (!(significance > 0.0 && significance < 1.0)) {
+        throw std::invalid_argument("Significance must be between 0 and 1");
+    }
+    NoiseValidationReport report;
+    const double n = static_cast<double>(count_);
+    report.count = count_;
+
+    long double m1 = sums_[0] / n, m2 = sums_[1] / n, m3 = sums_[2] / n, m4 = sums_[3] / n;
+    long double var = m2 - m1 * m1;
+    long double c3 = m3 - 3 * m1 * m2 + 2 * m1 * m1 * m1;
+    long double c4 = m4 - 4 * m1 * m3 + 6 * m1 * m1 * m2 - 3 * m1 * m1 * m1 * m1;
+    report.mean = static_cast<double>(m1);
+    report.variance = static_cast<double>(var);
+    report.skewness = var > 0 ? static_cast<double>(c3 / std::pow(var, 1.5L)) : 0.0;
+    report.excessKurtosis = var > 0 ? static_cast<double>(c4 / (var * var) - 3) : 0.0;
+
+    auto addZ = [&](const std::string& name, double z) {
+        report.tests.push_back(NoiseTest{name, z, normalPValue(z), true});
+    };
+    addZ("mean", report.mean * std::sqrt(n));
+    addZ("variance", (report.variance - 1.0) / std::sqrt(2.0 / n));
+    addZ("skewness", report.skewness / std::sqrt(6.0 / n));
+    addZ("kurtosis", report.excessKurtosis / std::sqrt(24.0 / n));
+
+    // Combined histogram, and Phi at the bin edges
+    const size_t bins = numBins();
+    std::vector<uint64_t> histogram(bins);
+    for (size_t b = 0; b < bins; ++b) {
+        histogram[b] = counts_[b] + counts_[bins + b] + counts_[2 * bins + b] + counts_[3 * bins + b];
+    }
+    const size_t numEdges = bins - 1;
+    std::vector<double> edgeCdf(numEdges), empirical(numEdges);
+    uint64_t below = 0;
+    for (size_t e = 0; e < numEdges; ++e) {
+        below += histogram[e];
+        edgeCdf[e] = normalCdf(-RANGE + static_cast<double>(e) / BINS_PER_SIGMA);
+        empirical[e] = static_cast<double>(below) / n;
+    }
+
+    // KS at the edges. Inside a bin the samples are taken to follow Phi, so
+    // F_n - Phi is linear in Phi there and the largest gap is at an edge.
+    double ks = 0.0;
+    for (size_t e = 0; e < numEdges; ++e) {
+        ks = std::max(ks, std::fabs(empirical[e] - edgeCdf[e]));
+    }
+    double ksScaled = ks * std::sqrt(n);
+    report.tests.push_back(NoiseTest{"Kolmogorov-Smirnov", ksScaled, kolmogorovPValue(ksScaled), true});
+
+    // Anderson-Darling under the same assumption: n times the integral of
+    // d(u)^2 / (u (1 - u)) over u = Phi(x), d linear in u on each bin, by
+    // 3-point Gauss-Legendre
+    const double nodes[3] = {-std::sqrt(0.6), 0.0, std::sqrt(0.6)};
+    const double weights[3] = {5.0 / 9.0, 8.0 / 9.0, 5.0 / 9.0};
+    double integral = 0.0;
+    for (size_t e = 0; e <= numEdges; ++e) {
+        double ua = e == 0 ? 0.0 : edgeCdf[e - 1];
+        double ub = e == numEdges ? 1.0 : edgeCdf[e];
+        double da = e == 0 ? 0.0 : empirical[e - 1] - edgeCdf[e - 1];
+        double db = e == numEdges ? 0.0 : empirical[e] - edgeCdf[e];
+        double half = 0.5 * (ub - ua);
+        if (!(half > 0.0)) {
+            continue;
+        }
+        for (size_t k = 0; k < 3; ++k) {
+            double t = 0.5 * (1.0 + nodes[k]);
+            double u = ua + (ub - ua) * t;
+            double d = da + (db - da) * t;
+            integral += half * weights[k] * d * d / (u * (1.0 - u));
+        }
+    }
+    double ad = n * integral;
+    report.tests.push_back(NoiseTest{"Anderson-Darling", ad, andersonDarlingPValue(ad), true});
+
+    // Two-sided tails; sigma multiples fall on bin edges
+    for (size_t k = 1; k <= static_cast<size_t>(RANGE); ++k) {
+        uint64_t outside = 0;
+        size_t low = (static_cast<size_t>(RANGE) - k) * BINS_PER_SIGMA; // Edge -k is the top of bin `low`
+        size_t high = (static_cast<size_t>(RANGE) + k) * BINS_PER_SIGMA + 1; // First bin at or above +k
+        for (size_t b = 0; b <= low; ++b) {
+            outside += histogram[b];
+        }
+        for (size_t b = high; b < bins; ++b) {
+            outside += histogram[b];
+        }
+        double expected = n * std::erfc(k / std::sqrt(2.0));
+        double z = (static_cast<double>(outside) - expected) / std::sqrt(expected);
+        report.tests.push_back(NoiseTest{"tail " + std::to_string(k) + " sigma", z, poissonPValue(outside, expected), true});
+    }
+
+    if (lagPairs_ > 0 && var > 0) {
+        const double pairs = static_cast<double>(lagPairs_);
+        for (size_t lag = 0; lag < maxLag_; ++lag) {
+            double r = (lagSums_[lag] / pairs - report.mean * report.mean) / report.variance;
+            addZ("lag " + std::to_string(lag + 1), r * std::sqrt(pairs));
+        }
+    }
+
+    report.threshold = significance / report.tests.size();
+    report.passed = true;
+    for (NoiseTest& test : report.tests) {
+        test.passed = test.pValue >= report.threshold;
+        report.passed = report.passed && test.passed;
+    }
+    return report;
+}
+
+uint64_t NoiseValidator::getCount() const {
+    return count_;
+}
+
+size_t NoiseValidator::getMaxLag() const {
+    return maxLag_;
+}
+
+NoiseValidator NoiseValidator::validate(const Generator& generate, uint64_t numSamples, size_t blockLength,
+                                        size_t numThreads, size_t maxLag) {
+    if (blockLength == 0 || numThreads == 0) {
+        throw std::invalid_argument("Block length and thread count must be greater than 0");
+    }
+    const uint64_t numBlocks = (numSamples + blockLength - 1) / blockLength;
+    numThreads = static_cast<size_t>(std::min<uint64_t>(numThreads, std::max<uint64_t>(numBlocks, 1)));
+    std::vector<NoiseValidator> partial(numThreads, NoiseValidator(maxLag));
+    std::vector<std::string> errors(numThreads);
+
+    // Thread t takes blocks t, t + numThreads, ...
+    auto work = [&](size_t t) {
+        try {
+            Arena scratch;
+            std::vector<double> block(blockLength);
+            for (uint64_t b = t; b < numBlocks; b += numThreads) {
+                size_t length = static_cast<size_t>(std::min<uint64_t>(blockLength, numSamples - b * blockLength));
+                scratch.reset();
+                generate(b, block.data(), length, scratch);
+                partial[t].breakStream();
+                partial[t].add(block.data(), length);
+            }
+        } catch (const std::exception& e) {
+            errors[t] = e.what();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < numThreads; ++t) {
+        threads.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+    }
+
+    NoiseValidator merged(maxLag);
+    for (const NoiseValidator& part : partial) {
+        merged.merge(part);
+    }
+    return merged;
+}
@@ -0,0 +1,80 @@
+#ifndef NOISE_VALIDATOR_HPP
+#define NOISE_VALIDATOR_HPP
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "Arena.hpp"
+
+struct NoiseTest {
+    std::string name;
+    double statistic; // z-score, except KS (sqrt(n) D) and Anderson-Darling (A^2)
+    double pValue;
+    bool passed;
+};
+
+struct NoiseValidationReport {
+    uint64_t count;
+    double mean;
+    double variance;
+    double skewness;
+    double excessKurtosis;
+    std::vector<NoiseTest> tests;
+    double threshold; // Each test passes with pValue >= threshold
+    bool passed;
+};
+
+// Checks a stream of samples against unit normal noise, the contract of
+// AWGN's unit noise. add() keeps only running sums, a histogram and the last
+// maxLag samples, so any number of samples fits in a few tens of kilobytes:
+//   - moments: mean, variance, skewness and excess kurtosis as z-scores;
+//   - Kolmogorov-Smirnov and Anderson-Darling against N(0, 1), on a histogram
+//     of BINS_PER_SIGMA bins per unit out to +-RANGE;
+//   - tail counts beyond 1 to 8 sigma, two-sided, against the Poisson expectation.
+//     BER 1e-9 needs the 6 sigma tail right;
+//   - autocorrelation at lags 1 to maxLag, for whiteness.
+// Binning and the sums run on the dispatched kernels. Validators of disjoint
+// samples merge, so a run can be split across threads.
+class NoiseValidator {
+public:
+    using Generator = std::function<void(uint64_t block, double* out, size_t n, Arena& scratch)>;
+
+    static constexpr double RANGE = 8.0;
+    static constexpr size_t BINS_PER_SIGMA = 64;
+    static constexpr size_t CHUNK = 4096; // Samples binned per kernel call
+
+    explicit NoiseValidator(size_t maxLag = 16);
+    void add(const double* samples, size_t n); // Continues the current stream
+    void breakStream(); // The next add() starts an unrelated stream: no lag products across
+    void merge(const NoiseValidator& other); // Same maxLag
+    void reset();
+    // Bonferroni over all tests: the report fails if any p-value is below significance / tests
+    NoiseValidationReport report(double significance = 1e-3) const;
+    uint64_t getCount() const;
+    size_t getMaxLag() const;
+
+    // numSamples in blocks of blockLength, block b from generate(b, ...), spread
+    // over numThreads threads. Each block is its own stream. The result does not
+    // depend on timing, only on numThreads through the order of the sums.
+    static NoiseValidator validate(const Generator& generate, uint64_t numSamples, size_t blockLength = 1 << 16,
+                                   size_t numThreads = 1, size_t maxLag = 16);
+
+private:
+    size_t maxLag_;
+    uint64_t count_;
+    long double sums_[4]; // Of x, x^2, x^3, x^4
+    std::vector<uint64_t> counts_; // 4 interleaved histograms, so increments do not wait on each other
+    std::vector<double> lagSums_;
+    std::vector<double> products_; // One chunk's lag sums
+    uint64_t lagPairs_;   // Samples that had maxLag samples of history
+    size_t historyFill_;
+    std::vector<double> work_; // History, then the chunk being correlated
+    std::vector<uint32_t> index_;
+
+    static size_t numBins(); // Including one bin below -RANGE and one at or above +RANGE (and NaN)
+    void addChunk(const double* x, size_t n);
+};
+
+#endif // NOISE_VALIDATOR_HPP
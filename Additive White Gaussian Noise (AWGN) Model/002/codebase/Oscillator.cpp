@@ -0,0 +1,172 @@
+#include "Oscillator.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include "FastMath.hpp"
+
+namespace {
+
+using FastMath::WidePhase;
+
+// n (n - 1) / 2 as a 128-bit integer, the number of chirp steps accumulated before sample n
+WidePhase triangular(uint64_t n) {
+    WidePhase product = FastMath::multiplyFull(n, n - 1);
+    return {product.high >> 1, (product.low >> 1) | (product.high << 63)};
+}
+
+WidePhase wideCount(uint64_t n) {
+    return {0, n};
+}
+
+inline double sineOfPhase(uint64_t phase) {
+    double sine, cosine;
+    FastMath::sinCosTurn(phase, sine, cosine);
+    return sine;
+}
+
+} // namespace
+
+Oscillator::Oscillator(OscillatorMode mode)
+    : mode_(mode), chirpStep_{0, 0}, sweepLength_(0), sweepAdvance_{0, 0}, sampleIndex_(0) {}
+
+Oscillator Oscillator::tone(double frequency, double amplitude, double phase) {
+    return multiTone({{frequency, amplitude, phase}});
+}
+
+Oscillator Oscillator::multiTone(const std::vector<Tone>& tones) {
+    if (tones.empty()) {
+        throw std::invalid_argument("At least one tone is required");
+    }
+    Oscillator osc(OSCILLATOR_TONES);
+    for (const Tone& t : tones) {
+        osc.tones_.push_back(
+            {FastMath::turnsToWidePhase(t.frequency), FastMath::turnsToWidePhase(t.phase), t.amplitude});
+    }
+    return osc;
+}
+
+Oscillator Oscillator::chirp(double startFrequency, double endFrequency, uint64_t sweepLength, double amplitude) {
+    if (sweepLength == 0) {
+        throw std::invalid_argument("Sweep length must be greater than 0");
+    }
+    Oscillator osc(OSCILLATOR_CHIRP);
+    osc.tones_.push_back({FastMath::turnsToWidePhase(startFrequency), {0, 0}, amplitude});
+    osc.chirpStep_ = FastMath::turnsToWidePhase((endFrequency - startFrequency) / static_cast<double>(sweepLength));
+    osc.sweepLength_ = sweepLength;
+    osc.sweepAdvance_ = FastMath::add(FastMath::multiply(wideCount(sweepLength), osc.tones_[0].increment),
+                                      FastMath::multiply(triangular(sweepLength), osc.chirpStep_));
+    return osc;
+}
+
+Oscillator Oscillator::wavetable(const std::vector<double>& period, double frequency, double amplitude) {
+    if (period.empty()) {
+        throw std::invalid_argument("Wavetable must not be empty");
+    }
+    Oscillator osc(OSCILLATOR_WAVETABLE);
+    osc.tones_.push_back({FastMath::turnsToWidePhase(frequency), {0, 0}, amplitude});
+    osc.table_.reserve(period.size() + 1);
+    for (double v : period) {
+        osc.table_.push_back(amplitude * v);
+    }
+    osc.table_.push_back(osc.table_.front()); // Interpolation past the last entry wraps
+    return osc;
+}
+
+void Oscillator::generateTones(double* block, size_t count) const {
+    for (size_t t = 0; t < tones_.size(); ++t) {
+        const uint64_t increment = FastMath::roundPhase(tones_[t].increment);
+        const double amplitude = tones_[t].amplitude;
+        uint64_t phase = FastMath::roundPhase(
+            FastMath::add(tones_[t].phase, FastMath::multiply(wideCount(sampleIndex_), tones_[t].increment)));
+        if (t == 0) {
+            for (size_t j = 0; j < count; ++j) {
+                block[j] = amplitude * sineOfPhase(phase);
+                phase += increment;
+            }
+        } else {
+            for (size_t j = 0; j < count; ++j) {
+                block[j] += amplitude * sineOfPhase(phase);
+                phase += increment;
+            }
+        }
+    }
+}
+
+void Oscillator::generateChirp(double* block, size_t count) const {
+    const uint64_t sweep = sampleIndex_ / sweepLength_;
+    const uint64_t position = sampleIndex_ % sweepLength_;
+    const uint64_t step = FastMath::roundPhase(chirpStep_);
+    // Phase and increment at the first sample of the block
+    const WidePhase start = tones_[0].increment;
+    const uint64_t increment =
+        FastMath::roundPhase(FastMath::add(start, FastMath::multiply(wideCount(position), chirpStep_)));
+    const uint64_t phase = FastMath::roundPhase(
+        FastMath::add(FastMath::multiply(wideCount(sweep), sweepAdvance_),
+                      FastMath::add(FastMath::multiply(wideCount(position), start),
+                                    FastMath::multiply(triangular(position), chirpStep_))));
+    const double amplitude = tones_[0].amplitude;
+    for (size_t j = 0; j < count; ++j) {
+        uint64_t k = j;
+        block[j] = amplitude * sineOfPhase(phase + k * increment + ((k * (k - 1)) >> 1) * step);
+    }
+}
+
+void Oscillator::generateWavetable(double* block, size_t count) const {
+    const uint64_t increment = FastMath::roundPhase(tones_[0].increment);
+    const uint64_t size = table_.size() - 1;
+    const double* table = table_.data();
+    uint64_t phase = FastMath::roundPhase(FastMath::multiply(wideCount(sampleIndex_), tones_[0].increment));
+    for (size_t j = 0; j < count; ++j) {
+        // Top 32 phase bits scaled to the table: integer part indexes, the rest interpolates
+        uint64_t position = (phase >> 32) * size;
+        uint64_t index = position >> 32;
+        double fraction = static_cast<uint32_t>(position) * (1.0 / 4294967296.0);
+        block[j] = table[index] + fraction * (table[index + 1] - table[index]);
+        phase += increment;
+    }
+}
+
+void Oscillator::generate(double* out, size_t count, size_t stride) {
+    alignas(64) double block[BLOCK];
+    size_t done = 0;
+    while (done < count) {
+        size_t n = std::min(BLOCK, count - done);
+        if (mode_ == OSCILLATOR_CHIRP) {
+            n = static_cast<size_t>(std::min<uint64_t>(n, sweepLength_ - sampleIndex_ % sweepLength_));
+        }
+        double* target = stride == 1 ? out + done : block;
+        switch (mode_) {
+            case OSCILLATOR_TONES: generateTones(target, n); break;
+            case OSCILLATOR_CHIRP: generateChirp(target, n); break;
+            case OSCILLATOR_WAVETABLE: generateWavetable(target, n); break;
+        }
+        if (stride != 1) {
+            for (size_t j = 0; j < n; ++j) {
+                out[(done + j) * stride] = block[j];
+            }
+        }
+        sampleIndex_ += n;
+        done += n;
+    }
+}
+
+std::vector<double> Oscillator::generate(size_t count) {
+    std::vector<double> signal(count);
+    generate(signal.data(), count);
+    return signal;
+}
+
+void Oscillator::seek(uint64_t sampleIndex) {
+    sampleIndex_ = sampleIndex;
+}
+
+void Oscillator::reset() {
+    sampleIndex_ = 0;
+}
+
+OscillatorMode Oscillator::getMode() const {
+    return mode_;
+}
+
+uint64_t Oscillator::getSampleIndex() const {
+    return sampleIndex_;
+}
@@ -0,0 +1,70 @@
+#ifndef OSCILLATOR_HPP
+#define OSCILLATOR_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "FastMath.hpp"
+
+enum OscillatorMode { OSCILLATOR_TONES, OSCILLATOR_CHIRP, OSCILLATOR_WAVETABLE };
+
+// Streaming signal source. Frequencies are in cycles per sample and phases in
+// cycles. Each block's starting phase is a 128-bit fixed-point fraction of a
+// cycle computed in closed form from the sample index, so it wraps exactly and
+// keeps the frequency bits below 2^-64 that a 64-bit increment would drop.
+// Within a block the phase steps in 64 bits, and the sines come from a
+// branch-free polynomial, so the per-block loops vectorize. Against the exact
+// sine of the double frequencies, tones and chirps stay within 2.5e-14 at
+// sample 10^12 as at sample 0.
+//
+// generate() continues where the previous call stopped; seek() jumps to any
+// sample index without generating the samples in between.
+class Oscillator {
+public:
+    struct Tone {
+        double frequency;
+        double amplitude;
+        double phase;
+    };
+
+    // Sum of sinusoids amplitude * sin(2 pi (frequency n + phase))
+    static Oscillator tone(double frequency, double amplitude = 1.0, double phase = 0.0);
+    static Oscillator multiTone(const std::vector<Tone>& tones);
+    // Linear sweep from startFrequency to endFrequency over sweepLength samples,
+    // then again from the start, with continuous phase
+    static Oscillator chirp(double startFrequency, double endFrequency, uint64_t sweepLength,
+                            double amplitude = 1.0);
+    // One period of an arbitrary waveform, read with linear interpolation
+    static Oscillator wavetable(const std::vector<double>& period, double frequency, double amplitude = 1.0);
+
+    void generate(double* out, size_t count, size_t stride = 1);
+    std::vector<double> generate(size_t count);
+    void seek(uint64_t sampleIndex);
+    void reset();
+
+    OscillatorMode getMode() const;
+    uint64_t getSampleIndex() const;
+
+private:
+    static constexpr size_t BLOCK = 256; // Samples per vectorized block
+
+    struct ToneState {
+        FastMath::WidePhase increment; // Phase step per sample
+        FastMath::WidePhase phase;     // Phase at sample 0
+        double amplitude;
+    };
+    OscillatorMode mode_;
+    std::vector<ToneState> tones_;
+    FastMath::WidePhase chirpStep_;    // Increment change per sample
+    uint64_t sweepLength_;
+    FastMath::WidePhase sweepAdvance_; // Phase gained over one whole sweep
+    std::vector<double> table_; // Scaled period plus a copy of its first value
+    uint64_t sampleIndex_;
+
+    explicit Oscillator(OscillatorMode mode);
+    void generateTones(double* block, size_t count) const;
+    void generateChirp(double* block, size_t count) const; // count must stay within one sweep
+    void generateWavetable(double* block, size_t count) const;
+};
+
+#endif // OSCILLATOR_HPP
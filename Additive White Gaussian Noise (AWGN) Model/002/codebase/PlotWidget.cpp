@@ -1,19 +1,465 @@
 #include "PlotWidget.hpp"
 #include "Analyzer.hpp"
+#include "BerSweep.hpp"
+#include "BerTheory.hpp"
 #include <cairo.h>
 #include <algorithm>
 #include <vector>
 #include <random>
+#include <cmath>
+#include <cstdio>
 #include <glib.h>
 
 G_DEFINE_TYPE(PlotWidget, plot_widget, GTK_TYPE_WIDGET)
 
+static void plot_widget_update_derived(PlotWidget *self) {
+    if (self->plot_type == PLOT_TYPE_SIGNAL) {
+        auto original = std::minmax_element(self->original_signal.begin(), self->original_signal.end());
+        auto noisy = std::minmax_element(self->noisy_signal.begin(), self->noisy_signal.end());
+        self->min_value = std::min(*original.first, *noisy.first);
+        self->max_value = std::max(*original.second, *noisy.second);
+    } else if (self->plot_type == PLOT_TYPE_TIME) {
+        auto noisy = std::minmax_element(self->noisy_signal.begin(), self->noisy_signal.end());
+        self->min_value = *noisy.first;
+        self->max_value = *noisy.second;
+        Analyzer analyzer;
+        self->crossing_points = analyzer.computeZeroCrossingPoints(self->noisy_signal);
+    } else if (self->plot_type == PLOT_TYPE_PHASOR) {
+        double noisePower = 0.0;
+        for (size_t i = 0; i < self->noisy_signal.size(); ++i) {
+            double noise = self->noisy_signal[i] - self->original_signal[i];
+            noisePower += noise * noise;
+        }
+        noisePower /= self->noisy_signal.size();
+        self->sigma = std::sqrt(noisePower / 2);
+
+        std::mt19937 rng(self->seed);
+        std::normal_distribution<> dist(0.0, self->sigma);
+        self->phasor_real.resize(self->noisy_signal.size());
+        self->phasor_imag.resize(self->noisy_signal.size());
+        for (size_t i = 0; i < self->noisy_signal.size(); ++i) {
+            self->phasor_real[i] = dist(rng);
+            self->phasor_imag[i] = dist(rng);
+        }
+    }
+    self->derived_valid = true;
+}
+
+static void plot_widget_draw_axes(cairo_t *cr, double width, double height) {
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_set_line_width(cr, 2.0);
+    cairo_move_to(cr, 0, height / 2);
+    cairo_line_to(cr, width, height / 2);
+    cairo_move_to(cr, 0, 0);
+    cairo_line_to(cr, 0, height);
+    cairo_stroke(cr);
+}
+
+static void plot_widget_draw_legend(cairo_t *cr, PlotType plot_type) {
+    if (plot_type == PLOT_TYPE_SIGNAL) {
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+        cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+        cairo_set_font_size(cr, 12);
+        cairo_set_source_rgb(cr, 0.0, 0.0, 1.0);
+        cairo_rectangle(cr, 10, 10, 20, 10);
+        cairo_fill(cr);
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+        cairo_move_to(cr, 40, 20);
+        cairo_show_text(cr, "Original Signal");
+        cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+        cairo_rectangle(cr, 10, 30, 20, 10);
+        cairo_fill(cr);
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+        cairo_move_to(cr, 40, 40);
+        cairo_show_text(cr, "Noisy Signal");
+    } else {
+        cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+        cairo_set_font_size(cr, 12);
+        cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+        cairo_rectangle(cr, 10, 10, 20, 10);
+        cairo_fill(cr);
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+        cairo_move_to(cr, 40, 20);
+        cairo_show_text(cr, "Noisy Signal");
+        cairo_set_source_rgb(cr, 0.0, 1.0, 0.0);
+        cairo_rectangle(cr, 10, 30, 10, 10);
+        cairo_fill(cr);
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+        cairo_move_to(cr, 40, 40);
+        cairo_show_text(cr, "Zero Crossings");
+    }
+}
+
+static double plot_widget_scope_y(const PlotWidget *self, double value, double height) {
+    double range = self->scope_max - self->scope_min;
+    double y = height - ((value - self->scope_min) / range) * height * 0.8 - height * 0.1;
+    return std::min(std::max(y, 0.0), height);
+}
+
+// Draws columns as vertical min-max bars starting at pixel column x0
+static void plot_widget_scope_draw_columns(PlotWidget *self, cairo_t *cr, const ScopeColumn *columns, size_t count, int x0) {
+    double height = self->scope_height;
+    cairo_set_line_width(cr, 1.0);
+    if (self->plot_type == PLOT_TYPE_SIGNAL) {
+        cairo_set_source_rgb(cr, 0.0, 0.0, 1.0);
+        for (size_t i = 0; i < count; ++i) {
+            double x = x0 + i + 0.5;
+            double top = plot_widget_scope_y(self, columns[i].original_max, height);
+            double bottom = plot_widget_scope_y(self, columns[i].original_min, height);
+            cairo_move_to(cr, x, top - 0.5);
+            cairo_line_to(cr, x, bottom + 0.5);
+        }
+        cairo_stroke(cr);
+    }
+    cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+    for (size_t i = 0; i < count; ++i) {
+        double x = x0 + i + 0.5;
+        double top = plot_widget_scope_y(self, columns[i].noisy_max, height);
+        double bottom = plot_widget_scope_y(self, columns[i].noisy_min, height);
+        cairo_move_to(cr, x, top - 0.5);
+        cairo_line_to(cr, x, bottom + 0.5);
+    }
+    cairo_stroke(cr);
+    if (self->plot_type == PLOT_TYPE_TIME) {
+        cairo_set_source_rgb(cr, 0.0, 1.0, 0.0);
+        for (size_t i = 0; i < count; ++i) {
+            if (columns[i].crossing) {
+                cairo_rectangle(cr, x0 + i - 1.0, height / 2 - 2.0, 3.0, 4.0);
+            }
+        }
+        cairo_fill(cr);
+    }
+}
+
+// Scrolls the trace image left by the pending columns and draws only those
+static void plot_widget_scope_update_image(PlotWidget *self, int width, int height) {
+    if (!self->scope_image || width != self->scope_width || height != self->scope_height) {
+        // New size: start from an empty trace, the decimation follows the new width
+        if (self->scope_image) {
+            cairo_surface_destroy(self->scope_image);
+            cairo_surface_destroy(self->scope_scratch);
+        }
+        self->scope_image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        self->scope_scratch = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        self->scope_width = width;
+        self->scope_height = height;
+        self->scope_pending.clear();
+        self->scope_column_count = 0;
+        return;
+    }
+    size_t count = self->scope_pending.size();
+    if (count == 0) {
+        return;
+    }
+    const ScopeColumn *columns = self->scope_pending.data();
+    cairo_t *cr = cairo_create(self->scope_scratch);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    if (count >= (size_t)width) {
+        columns += count - width;
+        count = width;
+        cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.0);
+    } else {
+        cairo_set_source_surface(cr, self->scope_image, -(double)count, 0);
+    }
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    plot_widget_scope_draw_columns(self, cr, columns, count, width - (int)count);
+    cairo_destroy(cr);
+    std::swap(self->scope_image, self->scope_scratch);
+    self->scope_pending.clear();
+}
+
+static void plot_widget_scope_snapshot(PlotWidget *self, GtkSnapshot *snapshot, double width, double height) {
+    plot_widget_scope_update_image(self, (int)width, (int)height);
+    graphene_rect_t rect = GRAPHENE_RECT_INIT(0, 0, (float)width, (float)height);
+    cairo_t *cr = gtk_snapshot_append_cairo(snapshot, &rect);
+    cairo_set_source_rgb(cr, 0.878, 0.878, 0.878); // #E0E0E0
+    cairo_paint(cr);
+    cairo_set_source_surface(cr, self->scope_image, 0, 0);
+    cairo_paint(cr);
+    plot_widget_draw_axes(cr, width, height);
+    plot_widget_draw_legend(cr, self->plot_type);
+    cairo_destroy(cr);
+}
+
+// Log-scaled bin colour, blue through red to yellow; empty bins stay transparent
+static uint32_t plot_widget_diagram_color(uint32_t count, double norm) {
+    if (count == 0) {
+        return 0;
+    }
+    double t = std::log1p((double)count) * norm;
+    double red = std::min(1.0, 2.0 * t);
+    double green = std::max(0.0, 2.0 * t - 1.0);
+    double blue = std::max(0.0, 1.0 - 2.0 * t);
+    return 0xFF000000u | (uint32_t)(red * 255) << 16 | (uint32_t)(green * 255) << 8 | (uint32_t)(blue * 255);
+}
+
+// Recolours the bins changed since the last frame, or all of them when the
+// colour scale had to grow; either way the cost is bounded by the bin count
+static void plot_widget_diagram_update_image(PlotWidget *self) {
+    SymbolDiagram *diagram = self->diagram;
+    const size_t columns = diagram->getColumns();
+    const size_t rows = diagram->getRows();
+    bool full = false;
+    if (!self->diagram_image) {
+        self->diagram_image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)columns, (int)rows);
+        full = true;
+    }
+    while (self->diagram_scale < diagram->getMaxCount()) {
+        self->diagram_scale *= 2;
+        full = true;
+    }
+    size_t column_begin = 0, column_end = columns, row_begin = 0, row_end = rows;
+    if (!full) {
+        diagram->getDirty(column_begin, column_end, row_begin, row_end);
+    }
+    diagram->clearDirty();
+    if (column_begin >= column_end || row_begin >= row_end) {
+        return;
+    }
+    cairo_surface_flush(self->diagram_image);
+    unsigned char *data = cairo_image_surface_get_data(self->diagram_image);
+    int stride = cairo_image_surface_get_stride(self->diagram_image);
+    const uint32_t *counts = diagram->getCounts();
+    double norm = 1.0 / std::log1p((double)self->diagram_scale);
+    for (size_t r = row_begin; r < row_end; ++r) {
+        uint32_t *pixels = (uint32_t *)(data + r * stride);
+        for (size_t c = column_begin; c < column_end; ++c) {
+            pixels[c] = plot_widget_diagram_color(counts[c * rows + r], norm);
+        }
+    }
+    cairo_surface_mark_dirty_rectangle(self->diagram_image, (int)column_begin, (int)row_begin,
+                                       (int)(column_end - column_begin), (int)(row_end - row_begin));
+}
+
+static void plot_widget_diagram_snapshot(PlotWidget *self, GtkSnapshot *snapshot, double width, double height) {
+    plot_widget_diagram_update_image(self);
+    graphene_rect_t rect = GRAPHENE_RECT_INIT(0, 0, (float)width, (float)height);
+    cairo_t *cr = gtk_snapshot_append_cairo(snapshot, &rect);
+    cairo_set_source_rgb(cr, 0.878, 0.878, 0.878); // #E0E0E0
+    cairo_paint(cr);
+
+    // Histogram, one bin per block of pixels
+    cairo_save(cr);
+    cairo_scale(cr, width / self->diagram->getColumns(), height / self->diagram->getRows());
+    cairo_set_source_surface(cr, self->diagram_image, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
+    cairo_paint(cr);
+    cairo_restore(cr);
+
+    // Axes through zero; on the eye the vertical one marks the symbol instant
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_set_line_width(cr, 1.0);
+    cairo_move_to(cr, width / 2, 0);
+    cairo_line_to(cr, width / 2, height);
+    cairo_move_to(cr, 0, height / 2);
+    cairo_line_to(cr, width, height / 2);
+    cairo_stroke(cr);
+
+    // Legend
+    char text[100];
+    unsigned long long symbols = (unsigned long long)self->diagram->getSymbolCount();
+    if (self->plot_type == PLOT_TYPE_CONSTELLATION) {
+        snprintf(text, sizeof(text), "Received Symbols: %llu", symbols);
+    } else {
+        snprintf(text, sizeof(text), "Eye: %llu symbols, +/-1 symbol period", symbols);
+    }
+    cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, 12);
+    cairo_move_to(cr, 10, 20);
+    cairo_show_text(cr, text);
+    cairo_destroy(cr);
+}
+
+// Margins of the BER plot area, leaving room for the axis labels
+static const double BER_LEFT = 60.0;
+static const double BER_RIGHT = 20.0;
+static const double BER_TOP = 20.0;
+static const double BER_BOTTOM = 40.0;
+
+static double plot_widget_ber_x(const PlotWidget *self, double eb_n0, double width) {
+    double span = width - BER_LEFT - BER_RIGHT;
+    return BER_LEFT + (eb_n0 - self->ber_x_min) / (self->ber_x_max - self->ber_x_min) * span;
+}
+
+// Zero and anything below the bottom decade land on the bottom edge
+static double plot_widget_ber_y(const PlotWidget *self, double ber, double height) {
+    double span = height - BER_TOP - BER_BOTTOM;
+    double decades = ber > 0 ? std::log10(ber) : self->ber_min_exponent;
+    decades = std::min(std::max(decades, (double)self->ber_min_exponent), 0.0);
+    return BER_TOP + decades / self->ber_min_exponent * span;
+}
+
+// Pixel rows of a point's estimate and interval at the given plot height
+static void plot_widget_ber_rows(const PlotWidget *self, const BerPlotPoint &point, double height,
+                                 int &estimate, int &low, int &high) {
+    SweepPoint counts{0.0, point.bits, point.errors};
+    double ber_low, ber_high;
+    counts.getConfidenceInterval(ber_low, ber_high);
+    estimate = (int)plot_widget_ber_y(self, counts.getBER(), height);
+    low = (int)plot_widget_ber_y(self, ber_low, height);
+    high = (int)plot_widget_ber_y(self, ber_high, height);
+}
+
+// Grid, decade labels, theory curve and legend, redrawn only on resize
+static void plot_widget_ber_update_background(PlotWidget *self, int width, int height) {
+    if (self->ber_background && width == self->ber_width && height == self->ber_height) {
+        return;
+    }
+    if (self->ber_background) {
+        cairo_surface_destroy(self->ber_background);
+    }
+    self->ber_background = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    self->ber_width = width;
+    self->ber_height = height;
+    for (BerPlotPoint &point : self->ber_points) {
+        point.drawn_estimate = -1; // Rows depend on the size
+    }
+
+    cairo_t *cr = cairo_create(self->ber_background);
+    cairo_set_source_rgb(cr, 0.878, 0.878, 0.878); // #E0E0E0
+    cairo_paint(cr);
+    const double left = BER_LEFT, right = width - BER_RIGHT;
+    const double top = BER_TOP, bottom = height - BER_BOTTOM;
+    char text[32];
+    cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, 12);
+
+    // Decades
+    cairo_set_line_width(cr, 1.0);
+    for (int exponent = 0; exponent >= self->ber_min_exponent; --exponent) {
+        double y = plot_widget_ber_y(self, std::pow(10.0, exponent), height);
+        cairo_set_source_rgb(cr, 0.7, 0.7, 0.7);
+        cairo_move_to(cr, left, y);
+        cairo_line_to(cr, right, y);
+        cairo_stroke(cr);
+        snprintf(text, sizeof(text), "1e%d", exponent);
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+        cairo_move_to(cr, 5, y + 4);
+        cairo_show_text(cr, text);
+    }
+    // Eb/N0, every 1, 2 or 5 dB depending on the span
+    double span = self->ber_x_max - self->ber_x_min;
+    double step = span > 30 ? 5.0 : span > 12 ? 2.0 : 1.0;
+    for (double db = std::ceil(self->ber_x_min / step) * step; db <= self->ber_x_max; db += step) {
+        double x = plot_widget_ber_x(self, db, width);
+        cairo_set_source_rgb(cr, 0.7, 0.7, 0.7);
+        cairo_move_to(cr, x, top);
+        cairo_line_to(cr, x, bottom);
+        cairo_stroke(cr);
+        snprintf(text, sizeof(text), "%g", db);
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+        cairo_move_to(cr, x - 8, bottom + 15);
+        cairo_show_text(cr, text);
+    }
+    cairo_move_to(cr, (left + right) / 2 - 40, height - 8);
+    cairo_show_text(cr, "Eb/N0 (dB)");
+
+    // Theory, one vertex per pixel column, stopping below the bottom decade
+    cairo_save(cr);
+    cairo_rectangle(cr, left, top, right - left, bottom - top);
+    cairo_clip(cr);
+    cairo_set_source_rgb(cr, 0.0, 0.0, 1.0);
+    cairo_set_line_width(cr, 2.0);
+    double floor_ber = std::pow(10.0, self->ber_min_exponent - 1);
+    int columns = (int)right - (int)left + 1;
+    std::vector<double> curve(columns);
+    for (int i = 0; i < columns; ++i) {
+        curve[i] = self->ber_x_min + ((int)left + i - left) / (right - left) * span;
+    }
+    BerTheory::bitErrorRate(self->ber_modulation, curve.data(), curve.size(), curve.data());
+    for (int i = 0; i < columns; ++i) {
+        int x = (int)left + i;
+        double ber = curve[i];
+        if (ber < floor_ber) {
+            break;
+        }
+        double y = BER_TOP + std::log10(ber) / self->ber_min_exponent * (bottom - top);
+        if (i == 0) {
+            cairo_move_to(cr, x, y);
+        } else {
+            cairo_line_to(cr, x, y);
+        }
+    }
+    cairo_stroke(cr);
+    cairo_restore(cr);
+
+    // Frame
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_set_line_width(cr, 2.0);
+    cairo_rectangle(cr, left, top, right - left, bottom - top);
+    cairo_stroke(cr);
+
+    // Legend
+    cairo_set_source_rgb(cr, 0.0, 0.0, 1.0);
+    cairo_rectangle(cr, right - 190, top + 10, 20, 10);
+    cairo_fill(cr);
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_move_to(cr, right - 160, top + 20);
+    cairo_show_text(cr, "Theory (uncoded)");
+    cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+    cairo_rectangle(cr, right - 190, top + 30, 20, 10);
+    cairo_fill(cr);
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_move_to(cr, right - 160, top + 40);
+    cairo_show_text(cr, "Simulated, 95% CI");
+    cairo_destroy(cr);
+    cairo_surface_mark_dirty(self->ber_background);
+}
+
+static void plot_widget_ber_snapshot(PlotWidget *self, GtkSnapshot *snapshot, double width, double height) {
+    plot_widget_ber_update_background(self, (int)width, (int)height);
+    graphene_rect_t rect = GRAPHENE_RECT_INIT(0, 0, (float)width, (float)height);
+    cairo_t *cr = gtk_snapshot_append_cairo(snapshot, &rect);
+    cairo_set_source_surface(cr, self->ber_background, 0, 0);
+    cairo_paint(cr);
+
+    // Interval bars with caps; a marker once there is an error to place it at
+    cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+    cairo_set_line_width(cr, 2.0);
+    for (BerPlotPoint &point : self->ber_points) {
+        if (point.bits == 0) {
+            continue;
+        }
+        plot_widget_ber_rows(self, point, height, point.drawn_estimate, point.drawn_low, point.drawn_high);
+        double x = plot_widget_ber_x(self, point.eb_n0, width);
+        cairo_move_to(cr, x, point.drawn_low);
+        cairo_line_to(cr, x, point.drawn_high);
+        cairo_move_to(cr, x - 4, point.drawn_low);
+        cairo_line_to(cr, x + 4, point.drawn_low);
+        cairo_move_to(cr, x - 4, point.drawn_high);
+        cairo_line_to(cr, x + 4, point.drawn_high);
+        cairo_stroke(cr);
+        if (point.errors > 0) {
+            cairo_arc(cr, x, point.drawn_estimate, 4.0, 0, 2 * G_PI);
+            cairo_fill(cr);
+        }
+    }
+    cairo_destroy(cr);
+}
+
 static void plot_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
     PlotWidget *self = PLOT_WIDGET(widget);
+    if (self->scope_active) {
+        plot_widget_scope_snapshot(self, snapshot, gtk_widget_get_width(widget), gtk_widget_get_height(widget));
+        return;
+    }
+    if (self->diagram) {
+        plot_widget_diagram_snapshot(self, snapshot, gtk_widget_get_width(widget), gtk_widget_get_height(widget));
+        return;
+    }
+    if (self->ber_active) {
+        plot_widget_ber_snapshot(self, snapshot, gtk_widget_get_width(widget), gtk_widget_get_height(widget));
+        return;
+    }
     if (self->original_signal.empty() || self->noisy_signal.empty()) {
         return;
     }
 
+    if (!self->derived_valid) {
+        plot_widget_update_derived(self);
+    }
+
     double width = gtk_widget_get_width(widget);
     double height = gtk_widget_get_height(widget);
     graphene_rect_t rect = GRAPHENE_RECT_INIT(0, 0, (float)width, (float)height);
@@ -25,12 +471,8 @@ static void plot_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
 
     if (self->plot_type == PLOT_TYPE_SIGNAL) {
         // Signal plot
-        double max_val = *std::max_element(self->original_signal.begin(), self->original_signal.end());
-        double min_val = *std::min_element(self->original_signal.begin(), self->original_signal.end());
-        double noisy_max = *std::max_element(self->noisy_signal.begin(), self->noisy_signal.end());
-        double noisy_min = *std::min_element(self->noisy_signal.begin(), self->noisy_signal.end());
-        max_val = std::max(max_val, noisy_max);
-        min_val = std::min(min_val, noisy_min);
+        double max_val = self->max_value;
+        double min_val = self->min_value;
         double range = max_val - min_val;
         if (range == 0) range = 1.0;
 
@@ -61,35 +503,12 @@ static void plot_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
         }
         cairo_stroke(cr);
 
-        // Axes
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-        cairo_set_line_width(cr, 2.0);
-        cairo_move_to(cr, 0, height / 2);
-        cairo_line_to(cr, width, height / 2);
-        cairo_move_to(cr, 0, 0);
-        cairo_line_to(cr, 0, height);
-        cairo_stroke(cr);
-
-        // Legend
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-        cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-        cairo_set_font_size(cr, 12);
-        cairo_set_source_rgb(cr, 0.0, 0.0, 1.0);
-        cairo_rectangle(cr, 10, 10, 20, 10);
-        cairo_fill(cr);
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-        cairo_move_to(cr, 40, 20);
-        cairo_show_text(cr, "Original Signal");
-        cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-        cairo_rectangle(cr, 10, 30, 20, 10);
-        cairo_fill(cr);
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-        cairo_move_to(cr, 40, 40);
-        cairo_show_text(cr, "Noisy Signal");
+        plot_widget_draw_axes(cr, width, height);
+        plot_widget_draw_legend(cr, PLOT_TYPE_SIGNAL);
     } else if (self->plot_type == PLOT_TYPE_TIME) {
         // Time domain plot
-        double max_val = *std::max_element(self->noisy_signal.begin(), self->noisy_signal.end());
-        double min_val = *std::min_element(self->noisy_signal.begin(), self->noisy_signal.end());
+        double max_val = self->max_value;
+        double min_val = self->min_value;
         double range = max_val - min_val;
         if (range == 0) range = 1.0;
 
@@ -108,9 +527,7 @@ static void plot_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
         cairo_stroke(cr);
 
         // Zero crossings
-        Analyzer analyzer;
-        auto crossing_points = analyzer.computeZeroCrossingPoints(self->noisy_signal);
-        for (const auto& idx : crossing_points) {
+        for (const auto& idx : self->crossing_points) {
             double x = (idx * width) / self->noisy_signal.size();
             double y = height / 2; // Zero line
             cairo_set_source_rgb(cr, 0.0, 1.0, 0.0); // Green for crossings
@@ -118,47 +535,13 @@ static void plot_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
             cairo_fill(cr);
         }
 
-        // Axes
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-        cairo_set_line_width(cr, 2.0);
-        cairo_move_to(cr, 0, height / 2);
-        cairo_line_to(cr, width, height / 2);
-        cairo_move_to(cr, 0, 0);
-        cairo_line_to(cr, 0, height);
-        cairo_stroke(cr);
-
-        // Legend
-        cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-        cairo_set_font_size(cr, 12);
-        cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-        cairo_rectangle(cr, 10, 10, 20, 10);
-        cairo_fill(cr);
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-        cairo_move_to(cr, 40, 20);
-        cairo_show_text(cr, "Noisy Signal");
-        cairo_set_source_rgb(cr, 0.0, 1.0, 0.0);
-        cairo_rectangle(cr, 10, 30, 10, 10);
-        cairo_fill(cr);
-        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-        cairo_move_to(cr, 40, 40);
-        cairo_show_text(cr, "Zero Crossings");
+        plot_widget_draw_axes(cr, width, height);
+        plot_widget_draw_legend(cr, PLOT_TYPE_TIME);
     } else if (self->plot_type == PLOT_TYPE_PHASOR) {
         // Phasor plot
-        std::vector<double> noise(self->noisy_signal.size());
-        for (size_t i = 0; i < self->noisy_signal.size(); ++i) {
-            noise[i] = self->noisy_signal[i] - self->original_signal[i];
-        }
-        double noisePower = std::accumulate(noise.begin(), noise.end(), 0.0,
-            [](double sum, double x) { return sum + x * x; }) / noise.size();
-        double sigma = std::sqrt(noisePower / 2);
-
-        std::mt19937 rng(self->seed);
-        std::normal_distribution<> dist(0.0, sigma);
-        std::vector<double> real_parts(noise.size()), imag_parts(noise.size());
-        for (size_t i = 0; i < noise.size(); ++i) {
-            real_parts[i] = dist(rng);
-            imag_parts[i] = dist(rng);
-        }
+        double sigma = self->sigma;
+        const std::vector<double>& real_parts = self->phasor_real;
+        const std::vector<double>& imag_parts = self->phasor_imag;
 
         // Plot distribution
         double max_val = 3 * sigma;
@@ -203,9 +586,17 @@ static void plot_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
     cairo_destroy(cr);
 }
 
+static void plot_widget_dispose(GObject *object) {
+    plot_widget_end_scope(PLOT_WIDGET(object));
+    plot_widget_end_diagram(PLOT_WIDGET(object));
+    plot_widget_end_ber(PLOT_WIDGET(object));
+    G_OBJECT_CLASS(plot_widget_parent_class)->dispose(object);
+}
+
 static void plot_widget_class_init(PlotWidgetClass *klass) {
     GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
     widget_class->snapshot = plot_widget_snapshot;
+    G_OBJECT_CLASS(klass)->dispose = plot_widget_dispose;
 }
 
 static void plot_widget_init(PlotWidget *self) {
@@ -213,6 +604,19 @@ static void plot_widget_init(PlotWidget *self) {
     gtk_widget_set_vexpand(GTK_WIDGET(self), TRUE);
     self->plot_type = PLOT_TYPE_SIGNAL;
     self->seed = 0;
+    self->derived_valid = false;
+    self->scope_active = false;
+    self->scope_image = NULL;
+    self->scope_scratch = NULL;
+    self->scope_width = 0;
+    self->scope_height = 0;
+    self->diagram = NULL;
+    self->diagram_image = NULL;
+    self->diagram_scale = 1;
+    self->ber_active = false;
+    self->ber_background = NULL;
+    self->ber_width = 0;
+    self->ber_height = 0;
 }
 
 PlotWidget* plot_widget_new() {
@@ -220,8 +624,180 @@ PlotWidget* plot_widget_new() {
 }
 
 void plot_widget_set_data(PlotWidget *self, const std::vector<double>& original, const std::vector<double>& noisy, PlotType plot_type, unsigned int seed) {
+    plot_widget_end_scope(self);
+    plot_widget_end_diagram(self);
+    plot_widget_end_ber(self);
     self->original_signal = original;
     self->noisy_signal = noisy;
     self->plot_type = plot_type;
     self->seed = seed;
-}
\ No newline at end of file
+    self->derived_valid = false;
+}
+
+void plot_widget_set_data(PlotWidget *self, const double *original, const double *noisy, size_t length, PlotType plot_type, unsigned int seed) {
+    plot_widget_end_scope(self);
+    plot_widget_end_diagram(self);
+    plot_widget_end_ber(self);
+    self->original_signal.assign(original, original + length);
+    self->noisy_signal.assign(noisy, noisy + length);
+    self->plot_type = plot_type;
+    self->seed = seed;
+    self->derived_valid = false;
+}
+
+void plot_widget_begin_scope(PlotWidget *self, PlotType plot_type, size_t window_samples, double min_value, double max_value) {
+    plot_widget_end_scope(self);
+    plot_widget_end_diagram(self);
+    plot_widget_end_ber(self);
+    self->scope_active = true;
+    self->plot_type = plot_type;
+    self->scope_window = std::max<size_t>(window_samples, 1);
+    self->scope_min = min_value;
+    self->scope_max = max_value > min_value ? max_value : min_value + 1.0;
+    self->scope_column_count = 0;
+    self->scope_has_last = false;
+    self->scope_pending.clear();
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void plot_widget_scope_push(PlotWidget *self, const double *original, const double *noisy, size_t count, size_t stride) {
+    if (!self->scope_active) {
+        return;
+    }
+    // Decimate to the width of the last draw; before the first one, to the default size
+    size_t width = self->scope_width > 0 ? self->scope_width : 600;
+    size_t per_column = std::max<size_t>(1, self->scope_window / width);
+    ScopeColumn &column = self->scope_column;
+    for (size_t i = 0; i < count; ++i) {
+        double o = original[i * stride];
+        double n = noisy[i * stride];
+        if (self->scope_column_count == 0) {
+            // Open the column at the previous sample so the trace stays connected
+            double first_o = self->scope_has_last ? self->scope_last_original : o;
+            double first_n = self->scope_has_last ? self->scope_last_noisy : n;
+            column.original_min = std::min(first_o, o);
+            column.original_max = std::max(first_o, o);
+            column.noisy_min = std::min(first_n, n);
+            column.noisy_max = std::max(first_n, n);
+            column.crossing = false;
+        } else {
+            column.original_min = std::min(column.original_min, o);
+            column.original_max = std::max(column.original_max, o);
+            column.noisy_min = std::min(column.noisy_min, n);
+            column.noisy_max = std::max(column.noisy_max, n);
+        }
+        if (self->scope_has_last && (self->scope_last_noisy < 0) != (n < 0)) {
+            column.crossing = true;
+        }
+        self->scope_last_original = o;
+        self->scope_last_noisy = n;
+        self->scope_has_last = true;
+        if (++self->scope_column_count == per_column) {
+            self->scope_pending.push_back(column);
+            self->scope_column_count = 0;
+        }
+    }
+    // A hidden tab is not drawn; only the newest screenful of columns can still appear
+    if (self->scope_pending.size() > 2 * width) {
+        self->scope_pending.erase(self->scope_pending.begin(), self->scope_pending.end() - width);
+    }
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void plot_widget_end_scope(PlotWidget *self) {
+    self->scope_active = false;
+    self->scope_pending.clear();
+    if (self->scope_image) {
+        cairo_surface_destroy(self->scope_image);
+        cairo_surface_destroy(self->scope_scratch);
+        self->scope_image = NULL;
+        self->scope_scratch = NULL;
+    }
+    self->scope_width = 0;
+    self->scope_height = 0;
+}
+
+void plot_widget_begin_diagram(PlotWidget *self, PlotType plot_type, size_t values_per_symbol, size_t samples_per_symbol, double range) {
+    plot_widget_end_scope(self);
+    plot_widget_end_diagram(self);
+    plot_widget_end_ber(self);
+    DiagramType type = plot_type == PLOT_TYPE_EYE ? DIAGRAM_EYE : DIAGRAM_CONSTELLATION;
+    self->diagram = new SymbolDiagram(type, values_per_symbol, samples_per_symbol, range);
+    self->plot_type = plot_type;
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void plot_widget_diagram_add(PlotWidget *self, const double *values, size_t count, bool restart) {
+    if (!self->diagram) {
+        return;
+    }
+    if (restart) {
+        self->diagram->breakTrace();
+    }
+    self->diagram->add(values, count);
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void plot_widget_end_diagram(PlotWidget *self) {
+    delete self->diagram;
+    self->diagram = NULL;
+    if (self->diagram_image) {
+        cairo_surface_destroy(self->diagram_image);
+        self->diagram_image = NULL;
+    }
+    self->diagram_scale = 1;
+}
+
+void plot_widget_begin_ber(PlotWidget *self, ModulationType modulation, const std::vector<double>& eb_n0_db, double min_ber) {
+    plot_widget_end_scope(self);
+    plot_widget_end_diagram(self);
+    plot_widget_end_ber(self);
+    self->ber_active = true;
+    self->plot_type = PLOT_TYPE_BER;
+    self->ber_modulation = modulation;
+    self->ber_points.clear();
+    double low = 0.0, high = 0.0;
+    for (size_t i = 0; i < eb_n0_db.size(); ++i) {
+        self->ber_points.push_back(BerPlotPoint{eb_n0_db[i], 0, 0, -1, -1, -1});
+        low = i == 0 ? eb_n0_db[i] : std::min(low, eb_n0_db[i]);
+        high = i == 0 ? eb_n0_db[i] : std::max(high, eb_n0_db[i]);
+    }
+    // Whole decibels with a margin, so the end points are not on the frame
+    self->ber_x_min = std::floor(low) - 1.0;
+    self->ber_x_max = std::ceil(high) + 1.0;
+    min_ber = std::min(std::max(min_ber, 1e-15), 0.1);
+    self->ber_min_exponent = (int)std::floor(std::log10(min_ber));
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void plot_widget_ber_update(PlotWidget *self, size_t index, size_t bits, size_t errors) {
+    if (!self->ber_active || index >= self->ber_points.size()) {
+        return;
+    }
+    BerPlotPoint &point = self->ber_points[index];
+    if (point.bits == bits && point.errors == errors) {
+        return;
+    }
+    point.bits = bits;
+    point.errors = errors;
+    if (point.drawn_estimate < 0 || self->ber_height == 0) {
+        gtk_widget_queue_draw(GTK_WIDGET(self));
+        return;
+    }
+    int estimate, low, high;
+    plot_widget_ber_rows(self, point, self->ber_height, estimate, low, high);
+    if (estimate != point.drawn_estimate || low != point.drawn_low || high != point.drawn_high) {
+        gtk_widget_queue_draw(GTK_WIDGET(self));
+    }
+}
+
+void plot_widget_end_ber(PlotWidget *self) {
+    self->ber_active = false;
+    self->ber_points.clear();
+    if (self->ber_background) {
+        cairo_surface_destroy(self->ber_background);
+        self->ber_background = NULL;
+    }
+    self->ber_width = 0;
+    self->ber_height = 0;
+}
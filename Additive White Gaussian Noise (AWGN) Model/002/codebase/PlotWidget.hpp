@@ -3,18 +3,80 @@
 
 #include <gtk/gtk.h>
 #include <vector>
+#include <cstdint>
+#include "SymbolDiagram.hpp"
+#include "ChannelModel.hpp"
 
-enum PlotType { PLOT_TYPE_SIGNAL, PLOT_TYPE_TIME, PLOT_TYPE_PHASOR };
+enum PlotType { PLOT_TYPE_SIGNAL, PLOT_TYPE_TIME, PLOT_TYPE_PHASOR, PLOT_TYPE_CONSTELLATION, PLOT_TYPE_EYE, PLOT_TYPE_BER };
 
 #define PLOT_WIDGET_TYPE (plot_widget_get_type())
 G_DECLARE_FINAL_TYPE(PlotWidget, plot_widget, PLOT, WIDGET, GtkWidget)
 
+// Extremes of the streamed samples that fell into one pixel column of the scope
+struct ScopeColumn {
+    double original_min;
+    double original_max;
+    double noisy_min;
+    double noisy_max;
+    bool crossing; // Noisy signal changed sign within the column
+};
+
+// One Eb/N0 point of the BER plot, with the pixel rows it was last drawn at
+struct BerPlotPoint {
+    double eb_n0;
+    size_t bits;
+    size_t errors;
+    int drawn_estimate; // -1 until drawn
+    int drawn_low;
+    int drawn_high;
+};
+
 struct _PlotWidget {
     GtkWidget parent_instance;
     std::vector<double> original_signal;
     std::vector<double> noisy_signal;
     PlotType plot_type;
     unsigned int seed;
+    // Derived by the first draw after set_data and reused by later redraws (tab switches, resizes)
+    bool derived_valid;
+    double min_value;
+    double max_value;
+    std::vector<size_t> crossing_points;
+    double sigma;
+    std::vector<double> phasor_real;
+    std::vector<double> phasor_imag;
+    // Scope mode: streamed samples are decimated into one column per pixel as they
+    // arrive, and each frame draws only the new columns into a scrolling image
+    bool scope_active;
+    size_t scope_window; // Samples across the full width
+    double scope_min;
+    double scope_max;
+    int scope_width;     // Size of the images, 0 until the first draw
+    int scope_height;
+    cairo_surface_t *scope_image;
+    cairo_surface_t *scope_scratch; // Target of the scroll copy, then swapped with scope_image
+    ScopeColumn scope_column;       // Column being filled
+    size_t scope_column_count;      // Samples in it so far
+    bool scope_has_last;
+    double scope_last_original;     // Previous sample, so adjacent columns join up
+    double scope_last_noisy;
+    std::vector<ScopeColumn> scope_pending; // Complete columns not drawn yet
+    // Diagram mode: received values are binned into a persistent histogram as they
+    // arrive, and each frame recolours only the bins that changed
+    SymbolDiagram *diagram;          // Null unless a diagram is shown
+    cairo_surface_t *diagram_image;  // One pixel per bin, scaled to the widget when drawn
+    uint32_t diagram_scale;          // Count drawn at full intensity, doubled as the maximum grows
+    // BER mode: the grid, labels and theory curve are cached in one image per
+    // size, so a frame only draws the points over it
+    bool ber_active;
+    ModulationType ber_modulation;
+    double ber_x_min;        // Eb/N0 (dB) at the edges of the plot area
+    double ber_x_max;
+    int ber_min_exponent;    // Bottom of the plot is 10^ber_min_exponent
+    std::vector<BerPlotPoint> ber_points;
+    int ber_width;           // Size of ber_background, 0 until the first draw
+    int ber_height;
+    cairo_surface_t *ber_background;
 };
 
 struct _PlotWidgetClass {
@@ -23,5 +85,32 @@ struct _PlotWidgetClass {
 
 PlotWidget* plot_widget_new();
 void plot_widget_set_data(PlotWidget *self, const std::vector<double>& original, const std::vector<double>& noisy, PlotType plot_type, unsigned int seed);
+// Copies into the widget's existing storage, so repeated calls of the same size do not allocate
+void plot_widget_set_data(PlotWidget *self, const double *original, const double *noisy, size_t length, PlotType plot_type, unsigned int seed);
+
+// Scrolling oscilloscope view of PLOT_TYPE_SIGNAL or PLOT_TYPE_TIME, with
+// window_samples across the width and a fixed vertical range. set_data ends it.
+void plot_widget_begin_scope(PlotWidget *self, PlotType plot_type, size_t window_samples, double min_value, double max_value);
+// Appends streamed samples (strides in doubles); the next frame draws the new columns
+void plot_widget_scope_push(PlotWidget *self, const double *original, const double *noisy, size_t count, size_t stride);
+void plot_widget_end_scope(PlotWidget *self);
+
+// Constellation (PLOT_TYPE_CONSTELLATION) or eye diagram (PLOT_TYPE_EYE) of
+// receive-filtered values (ChannelModel::receiveWaveform), spanning [-range, range].
+// Every plot_widget_diagram_add call accumulates into the same histogram until the
+// diagram is begun again or ended; set_data, begin_scope and begin_ber end it.
+void plot_widget_begin_diagram(PlotWidget *self, PlotType plot_type, size_t values_per_symbol, size_t samples_per_symbol, double range);
+// restart marks values that do not continue the previous call (a new block, or a skipped backlog)
+void plot_widget_diagram_add(PlotWidget *self, const double *values, size_t count, bool restart);
+void plot_widget_end_diagram(PlotWidget *self);
+
+// BER against Eb/N0 on a log scale (PLOT_TYPE_BER), with the closed-form uncoded
+// curve of the modulation overlaid and one point per eb_n0_db entry. min_ber sets
+// the bottom decade. set_data, begin_scope and begin_diagram end it.
+void plot_widget_begin_ber(PlotWidget *self, ModulationType modulation, const std::vector<double>& eb_n0_db, double min_ber);
+// Sets the accumulated counts of point index; the widget is redrawn only when
+// the estimate or its 95% interval moves by at least a pixel
+void plot_widget_ber_update(PlotWidget *self, size_t index, size_t bits, size_t errors);
+void plot_widget_end_ber(PlotWidget *self);
 
 #endif // PLOT_WIDGET_HPP
\ No newline at end of file
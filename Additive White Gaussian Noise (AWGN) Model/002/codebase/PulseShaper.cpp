@@ -0,0 +1,159 @@
+#include "PulseShaper.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include "Common.hpp"
+
+PulseShaper::PulseShaper(double rolloff, size_t samplesPerSymbol, size_t spanSymbols)
+    : rolloff_(rolloff), samplesPerSymbol_(samplesPerSymbol), spanSymbols_(spanSymbols) {
+    if (rolloff_ < 0.0 || rolloff_ > 1.0) {
+        throw std::invalid_argument("Roll-off must be between 0 and 1");
+    }
+    if (samplesPerSymbol_ == 0 || spanSymbols_ == 0) {
+        throw std::invalid_argument("Samples per symbol and filter span must be greater than 0");
+    }
+    taps_ = rootRaisedCosine(rolloff_, samplesPerSymbol_, spanSymbols_);
+
+    // Branch p holds taps p, p + sps, p + 2*sps, ... scaled so each output sample
+    // carries the symbol power (the zero-stuffed inputs are never multiplied)
+    const double gain = std::sqrt(static_cast<double>(samplesPerSymbol_));
+    txPhases_.resize(samplesPerSymbol_);
+    for (size_t k = 0; k < taps_.size(); ++k) {
+        txPhases_[k % samplesPerSymbol_].push_back(taps_[k] * gain);
+    }
+}
+
+std::vector<double> PulseShaper::rootRaisedCosine(double rolloff, size_t samplesPerSymbol, size_t spanSymbols) {
+    const size_t numTaps = spanSymbols * samplesPerSymbol + 1;
+    const double center = (numTaps - 1) / 2.0;
+    const double beta = rolloff;
+    std::vector<double> taps(numTaps);
+    for (size_t k = 0; k < numTaps; ++k) {
+        double t = (k - center) / samplesPerSymbol; // In symbol periods
+        double value;
+        if (std::abs(t) < 1e-12) {
+            value = 1.0 - beta + 4.0 * beta / Constants::PI;
+        } else if (beta > 0.0 && std::abs(std::abs(t) - 1.0 / (4.0 * beta)) < 1e-12) {
+            value = beta / std::sqrt(2.0) *
+                ((1.0 + 2.0 / Constants::PI) * std::sin(Constants::PI / (4.0 * beta)) +
+                 (1.0 - 2.0 / Constants::PI) * std::cos(Constants::PI / (4.0 * beta)));
+        } else {
+            value = (std::sin(Constants::PI * t * (1.0 - beta)) +
+                     4.0 * beta * t * std::cos(Constants::PI * t * (1.0 + beta))) /
+                    (Constants::PI * t * (1.0 - (4.0 * beta * t) * (4.0 * beta * t)));
+        }
+        taps[k] = value;
+    }
+
+    // Unit energy, so the cascade of transmit and matched filter peaks at 1
+    double energy = std::accumulate(taps.begin(), taps.end(), 0.0,
+        [](double sum, double x) { return sum + x * x; });
+    double scale = 1.0 / std::sqrt(energy);
+    for (auto& tap : taps) {
+        tap *= scale;
+    }
+    return taps;
+}
+
+std::vector<double> PulseShaper::shape(const std::vector<double>& symbols, size_t stride) const {
+    const size_t numSymbols = symbols.size() / stride;
+    std::vector<double> samples(shapedLength(numSymbols) * stride);
+    shape(symbols.data(), numSymbols, stride, samples.data());
+    return samples;
+}
+
+void PulseShaper::shape(const double* symbols, size_t numSymbols, size_t stride, double* samples) const {
+    const size_t sps = samplesPerSymbol_;
+    const size_t numOutputs = numSymbols + spanSymbols_; // Output symbol periods incl. filter tail
+
+    for (size_t c = 0; c < stride; ++c) {
+        for (size_t q = 0; q < numOutputs; ++q) {
+            for (size_t p = 0; p < sps; ++p) {
+                const std::vector<double>& branch = txPhases_[p];
+                double acc = 0.0;
+                // Only symbols q - i with 0 <= q - i < numSymbols contribute
+                size_t first = (q >= numSymbols) ? q - numSymbols + 1 : 0;
+                size_t last = std::min(branch.size(), q + 1);
+                for (size_t i = first; i < last; ++i) {
+                    acc += branch[i] * symbols[(q - i) * stride + c];
+                }
+                samples[(q * sps + p) * stride + c] = acc;
+            }
+        }
+    }
+}
+
+std::vector<double> PulseShaper::matchedFilter(const std::vector<double>& samples, size_t stride) const {
+    std::vector<double> symbols(matchedLength(samples.size(), stride));
+    matchedFilter(samples.data(), samples.size(), stride, symbols.data());
+    return symbols;
+}
+
+size_t PulseShaper::matchedFilter(const double* samples, size_t numSamples, size_t stride, double* symbols) const {
+    const size_t sps = samplesPerSymbol_;
+    const size_t numSymbols = matchedLength(numSamples, stride) / stride;
+    const size_t numTaps = taps_.size();
+    const double gain = 1.0 / std::sqrt(static_cast<double>(sps));
+
+    for (size_t c = 0; c < stride; ++c) {
+        for (size_t n = 0; n < numSymbols; ++n) {
+            // Peak of the transmit/receive cascade sits at n * sps + (numTaps - 1)
+            size_t m = n * sps + numTaps - 1;
+            double acc = 0.0;
+            for (size_t k = 0; k < numTaps; ++k) {
+                acc += taps_[k] * samples[(m - k) * stride + c];
+            }
+            symbols[n * stride + c] = acc * gain;
+        }
+    }
+    return numSymbols * stride;
+}
+
+size_t PulseShaper::matchedWaveform(const double* samples, size_t numSamples, size_t stride, double* out) const {
+    const size_t numOutputs = matchedWaveformLength(numSamples, stride) / stride;
+    const size_t numTaps = taps_.size();
+    const double gain = 1.0 / std::sqrt(static_cast<double>(samplesPerSymbol_));
+
+    for (size_t c = 0; c < stride; ++c) {
+        for (size_t j = 0; j < numOutputs; ++j) {
+            // Same alignment as matchedFilter: output n * sps is symbol n
+            size_t m = j + numTaps - 1;
+            double acc = 0.0;
+            for (size_t k = 0; k < numTaps; ++k) {
+                acc += taps_[k] * samples[(m - k) * stride + c];
+            }
+            out[j * stride + c] = acc * gain;
+        }
+    }
+    return numOutputs * stride;
+}
+
+size_t PulseShaper::shapedLength(size_t numSymbols) const {
+    return (numSymbols + spanSymbols_) * samplesPerSymbol_;
+}
+
+size_t PulseShaper::matchedLength(size_t numSamples, size_t stride) const {
+    const size_t numPeriods = numSamples / stride / samplesPerSymbol_;
+    return numPeriods > spanSymbols_ ? (numPeriods - spanSymbols_) * stride : 0;
+}
+
+size_t PulseShaper::matchedWaveformLength(size_t numSamples, size_t stride) const {
+    return matchedLength(numSamples, stride) * samplesPerSymbol_;
+}
+
+double PulseShaper::getRolloff() const {
+    return rolloff_;
+}
+
+size_t PulseShaper::getSamplesPerSymbol() const {
+    return samplesPerSymbol_;
+}
+
+size_t PulseShaper::getSpanSymbols() const {
+    return spanSymbols_;
+}
+
+const std::vector<double>& PulseShaper::getTaps() const {
+    return taps_;
+}
@@ -0,0 +1,40 @@
+#ifndef PULSE_SHAPER_HPP
+#define PULSE_SHAPER_HPP
+
+#include <vector>
+#include <cstddef> // For size_t
+
+// Root-raised-cosine transmit/receive filtering.
+// Symbols are stored as `stride` interleaved real streams (1 for BPSK, 2 for QPSK I/Q,
+// 4 for the 16-QAM layout); each stream is filtered independently.
+class PulseShaper {
+private:
+    double rolloff_;
+    size_t samplesPerSymbol_;
+    size_t spanSymbols_;
+    std::vector<double> taps_; // Unit-energy RRC, span * sps + 1 taps
+    std::vector<std::vector<double>> txPhases_; // Polyphase branches of the transmit filter
+
+public:
+    PulseShaper(double rolloff, size_t samplesPerSymbol, size_t spanSymbols = 8);
+    static std::vector<double> rootRaisedCosine(double rolloff, size_t samplesPerSymbol, size_t spanSymbols);
+
+    // Polyphase interpolation: numSymbols in, (numSymbols + span) * sps samples out per stream
+    std::vector<double> shape(const std::vector<double>& symbols, size_t stride) const;
+    void shape(const double* symbols, size_t numSymbols, size_t stride, double* out) const;
+    // Matched filter evaluated only at the symbol instants (polyphase decimation)
+    std::vector<double> matchedFilter(const std::vector<double>& samples, size_t stride) const;
+    size_t matchedFilter(const double* samples, size_t numSamples, size_t stride, double* out) const;
+    // Matched filter at every sample, for eye diagrams; symbol n peaks at output n * sps
+    size_t matchedWaveform(const double* samples, size_t numSamples, size_t stride, double* out) const;
+
+    size_t shapedLength(size_t numSymbols) const;
+    size_t matchedLength(size_t numSamples, size_t stride) const; // Values written by matchedFilter
+    size_t matchedWaveformLength(size_t numSamples, size_t stride) const;
+    double getRolloff() const;
+    size_t getSamplesPerSymbol() const;
+    size_t getSpanSymbols() const;
+    const std::vector<double>& getTaps() const;
+};
+
+#endif // PULSE_SHAPER_HPP
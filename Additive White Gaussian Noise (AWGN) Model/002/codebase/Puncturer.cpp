@@ -0,0 +1,88 @@
+#include "Puncturer.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+Puncturer::Puncturer(const std::vector<int>& pattern) : period_(pattern.size()) {
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern[i]) {
+            keep_.push_back(i);
+        }
+    }
+    if (keep_.empty()) {
+        throw std::invalid_argument("Puncturing pattern must keep at least one bit");
+    }
+}
+
+Puncturer Puncturer::forRate(CodeRate rate) {
+    // Emission order is (g0, g1) per input step
+    switch (rate) {
+        case RATE_1_2: return Puncturer({1, 1});
+        case RATE_2_3: return Puncturer({1, 1, 1, 0});
+        case RATE_3_4: return Puncturer({1, 1, 1, 0, 0, 1});
+        case RATE_5_6: return Puncturer({1, 1, 1, 0, 0, 1, 1, 0, 0, 1});
+        default: throw std::invalid_argument("Unsupported code rate");
+    }
+}
+
+size_t Puncturer::keptBefore(size_t position) const {
+    return static_cast<size_t>(std::lower_bound(keep_.begin(), keep_.end(), position) - keep_.begin());
+}
+
+size_t Puncturer::puncture(const int* coded, size_t numCoded, int* punctured) const {
+    const size_t kept = keep_.size();
+    const size_t periods = numCoded / period_;
+    const size_t* keep = keep_.data();
+    for (size_t p = 0; p < periods; ++p) {
+        const int* in = coded + p * period_;
+        int* out = punctured + p * kept;
+        for (size_t i = 0; i < kept; ++i) {
+            out[i] = in[keep[i]];
+        }
+    }
+    // Partial last period: its kept positions are a prefix of the table
+    const size_t tail = keptBefore(numCoded - periods * period_);
+    const int* in = coded + periods * period_;
+    int* out = punctured + periods * kept;
+    for (size_t i = 0; i < tail; ++i) {
+        out[i] = in[keep[i]];
+    }
+    return periods * kept + tail;
+}
+
+size_t Puncturer::depuncture(const double* llrs, size_t numLlrs, double* coded) const {
+    const size_t kept = keep_.size();
+    const size_t length = depuncturedLength(numLlrs);
+    const size_t periods = numLlrs / kept;
+    const size_t* keep = keep_.data();
+    std::fill(coded, coded + length, 0.0);
+    for (size_t p = 0; p < periods; ++p) {
+        const double* in = llrs + p * kept;
+        double* out = coded + p * period_;
+        for (size_t i = 0; i < kept; ++i) {
+            out[keep[i]] = in[i];
+        }
+    }
+    const size_t tail = numLlrs - periods * kept;
+    const double* in = llrs + periods * kept;
+    double* out = coded + periods * period_;
+    for (size_t i = 0; i < tail; ++i) {
+        out[keep[i]] = in[i];
+    }
+    return length;
+}
+
+size_t Puncturer::puncturedLength(size_t numCoded) const {
+    return numCoded / period_ * keep_.size() + keptBefore(numCoded % period_);
+}
+
+size_t Puncturer::depuncturedLength(size_t numLlrs) const {
+    return (numLlrs + keep_.size() - 1) / keep_.size() * period_;
+}
+
+size_t Puncturer::getPeriod() const {
+    return period_;
+}
+
+size_t Puncturer::getKeptPerPeriod() const {
+    return keep_.size();
+}
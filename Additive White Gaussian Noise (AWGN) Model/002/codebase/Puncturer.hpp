@@ -0,0 +1,35 @@
+#ifndef PUNCTURER_HPP
+#define PUNCTURER_HPP
+
+#include <vector>
+#include <cstddef> // For size_t
+
+// Rates reachable by puncturing a rate 1/2 mother code
+enum CodeRate { RATE_1_2, RATE_2_3, RATE_3_4, RATE_5_6 };
+
+// Periodic puncturing of a coded bit stream. The pattern lists, in emission
+// order, which coded bits of one period are sent (1) or deleted (0). It is
+// turned into a gather table of kept positions, so puncture() and
+// depuncture() are plain index loops with no per-bit tests.
+class Puncturer {
+private:
+    size_t period_;
+    std::vector<size_t> keep_; // Positions within a period that are transmitted
+    size_t keptBefore(size_t position) const; // Kept positions in [0, position)
+
+public:
+    explicit Puncturer(const std::vector<int>& pattern);
+    // Standard 802.11/DVB patterns for the (171, 133) family
+    static Puncturer forRate(CodeRate rate);
+
+    size_t puncture(const int* coded, size_t numCoded, int* punctured) const;
+    // Scatters received soft values back to their positions; deleted bits become 0 (erasures)
+    size_t depuncture(const double* llrs, size_t numLlrs, double* coded) const;
+    size_t puncturedLength(size_t numCoded) const;
+    // Rounded up to whole periods; the extra erasures read as trailing zero-tail steps
+    size_t depuncturedLength(size_t numLlrs) const;
+    size_t getPeriod() const;
+    size_t getKeptPerPeriod() const;
+};
+
+#endif // PUNCTURER_HPP
@@ -0,0 +1,94 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <vector>
+#include <cstddef> // For size_t
+#include <algorithm>
+#include <stdexcept>
+
+// Lock-free ring for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to a power of two. Each side owns one index on its own
+// cache line and keeps a cached copy of the other side's index, so the shared
+// lines are only touched when the cached view runs out. Writes and reads are
+// partial when the ring is full or empty; neither side ever blocks.
+template <typename T>
+class RingBuffer {
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::vector<T> slots_;
+    size_t mask_;
+    alignas(CACHE_LINE) std::atomic<size_t> head_; // Next slot to write, owned by the producer
+    size_t cachedTail_;
+    alignas(CACHE_LINE) std::atomic<size_t> tail_; // Next slot to read, owned by the consumer
+    size_t cachedHead_;
+
+public:
+    explicit RingBuffer(size_t capacity)
+        : head_(0), cachedTail_(0), tail_(0), cachedHead_(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Ring buffer capacity must be greater than 0");
+        }
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Producer side: copies up to count items and returns how many fit
+    size_t write(const T* items, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t free = slots_.size() - (head - cachedTail_);
+        if (free < count) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            free = slots_.size() - (head - cachedTail_);
+        }
+        count = std::min(count, free);
+        size_t first = std::min(count, slots_.size() - (head & mask_));
+        std::copy(items, items + first, slots_.data() + (head & mask_));
+        std::copy(items + first, items + count, slots_.data());
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side: copies up to count items and returns how many were available
+    size_t read(T* items, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t ready = cachedHead_ - tail;
+        if (ready < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            ready = cachedHead_ - tail;
+        }
+        count = std::min(count, ready);
+        size_t first = std::min(count, slots_.size() - (tail & mask_));
+        std::copy(slots_.data() + (tail & mask_), slots_.data() + (tail & mask_) + first, items);
+        std::copy(slots_.data(), slots_.data() + (count - first), items + first);
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side: drops up to count of the oldest items without copying them
+    size_t discard(size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        count = std::min(count, cachedHead_ - tail);
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Items waiting to be read; may grow concurrently while the producer writes
+    size_t available() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return slots_.size();
+    }
+};
+
+#endif // RING_BUFFER_HPP
@@ -0,0 +1,196 @@
+#include "ScenarioMatrix.hpp"
+#include "SweepCommand.hpp"
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    // Named settings map to the enum value they set; numbers pass through
+    struct Field {
+        const char* key;
+        double (*parseName)(const std::string& name); // Null for numeric keys
+        void (*set)(SimulationParams& params, double value);
+        double minimum;
+        bool integral;
+    };
+
+    double parseModulation(const std::string& name) {
+        if (name == "bpsk") return BPSK;
+        if (name == "qpsk") return QPSK;
+        if (name == "qam16") return QAM16;
+        throw std::invalid_argument("Unknown modulation " + name);
+    }
+
+    double parseCoding(const std::string& name) {
+        if (name == "none") return NONE;
+        if (name == "conv") return CONVOLUTIONAL;
+        if (name == "conv7") return CONVOLUTIONAL_K7;
+        if (name == "ldpc") return LDPC;
+        if (name == "turbo") return TURBO;
+        throw std::invalid_argument("Unknown coding " + name);
+    }
+
+    double parseRate(const std::string& name) {
+        if (name == "1/2") return RATE_1_2;
+        if (name == "2/3") return RATE_2_3;
+        if (name == "3/4") return RATE_3_4;
+        if (name == "5/6") return RATE_5_6;
+        throw std::invalid_argument("Unknown code rate " + name);
+    }
+
+    double parseSwitch(const std::string& name) {
+        if (name == "off") return 0.0;
+        if (name == "on") return 1.0;
+        throw std::invalid_argument("Expected on or off, got " + name);
+    }
+
+    const double ANY = -std::numeric_limits<double>::infinity();
+
+    // In nesting order: the last key varies fastest
+    const Field FIELDS[] = {
+        {"bits", nullptr, [](SimulationParams& p, double v) { p.numBits = static_cast<size_t>(v); }, 1, true},
+        {"modulation", parseModulation,
+         [](SimulationParams& p, double v) { p.modulation = static_cast<ModulationType>(v); }, 0, true},
+        {"coding", parseCoding, [](SimulationParams& p, double v) { p.coding = static_cast<CodingType>(v); }, 0, true},
+        {"rate", parseRate, [](SimulationParams& p, double v) { p.codeRate = static_cast<CodeRate>(v); }, 0, true},
+        {"sps", nullptr, [](SimulationParams& p, double v) { p.samplesPerSymbol = static_cast<size_t>(v); }, 1, true},
+        {"rolloff", nullptr, [](SimulationParams& p, double v) { p.rolloff = v; }, 0, false},
+        {"amplitude", nullptr, [](SimulationParams& p, double v) { p.amplitude = v; }, ANY, false},
+        {"bitrate", nullptr, [](SimulationParams& p, double v) { p.bitRate = v; }, 0, false},
+        {"bandwidth", nullptr, [](SimulationParams& p, double v) { p.bandwidth = v; }, 0, false},
+        {"bandlimited", parseSwitch, [](SimulationParams& p, double v) { p.bandlimitedNoise = v != 0.0; }, 0, true},
+        {"doppler", nullptr, [](SimulationParams& p, double v) { p.doppler = v; }, 0, false},
+        {"k", nullptr, [](SimulationParams& p, double v) { p.kFactor = v; }, 0, false},
+        {"cfo", nullptr, [](SimulationParams& p, double v) { p.frequencyOffset = v; }, ANY, false},
+        {"phase-noise", nullptr, [](SimulationParams& p, double v) { p.phaseNoise = v; }, 0, false},
+        {"iq-gain", nullptr, [](SimulationParams& p, double v) { p.iqGainDb = v; }, ANY, false},
+        {"iq-phase", nullptr, [](SimulationParams& p, double v) { p.iqPhaseDeg = v; }, ANY, false},
+        {"dc", nullptr, [](SimulationParams& p, double v) { p.dcOffset = v; }, ANY, false},
+        {"seed", nullptr, [](SimulationParams& p, double v) { p.seed = static_cast<unsigned int>(v); }, 0, true},
+        {"snr", nullptr, [](SimulationParams& p, double v) { p.snrDb = v; }, ANY, false},
+    };
+    const size_t NUM_FIELDS = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+    struct Section {
+        std::string name;
+        std::vector<std::vector<double>> lists; // Per field; empty keeps the default
+    };
+
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return "";
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    std::vector<double> parseList(const Field& field, const std::string& value) {
+        std::vector<double> values;
+        if (field.parseName) {
+            size_t begin = 0;
+            while (begin <= value.size()) {
+                size_t comma = value.find(',', begin);
+                values.push_back(field.parseName(trim(value.substr(begin, comma - begin))));
+                if (comma == std::string::npos) break;
+                begin = comma + 1;
+            }
+            return values;
+        }
+        values = SweepCommand::parseSnrList(value);
+        for (double v : values) {
+            if (!(v >= field.minimum) || (field.integral && (v != std::floor(v) || v > 4294967295.0))) {
+                throw std::invalid_argument(std::string("Bad value for ") + field.key + ": " + value);
+            }
+        }
+        return values;
+    }
+
+    // Every combination of the section's lists, defaults where it has none
+    void expand(const Section& defaults, const Section& section, std::vector<ScenarioCell>& cells) {
+        std::vector<const std::vector<double>*> lists(NUM_FIELDS, nullptr);
+        for (size_t f = 0; f < NUM_FIELDS; ++f) {
+            if (!section.lists[f].empty()) lists[f] = &section.lists[f];
+            else if (!defaults.lists[f].empty()) lists[f] = &defaults.lists[f];
+        }
+        std::vector<size_t> index(NUM_FIELDS, 0);
+        while (true) {
+            ScenarioCell cell{section.name, SimulationParams()};
+            for (size_t f = 0; f < NUM_FIELDS; ++f) {
+                if (lists[f]) FIELDS[f].set(cell.params, (*lists[f])[index[f]]);
+            }
+            cells.push_back(cell);
+            size_t f = NUM_FIELDS;
+            while (f > 0) {
+                --f;
+                if (lists[f] && ++index[f] < lists[f]->size()) break;
+                index[f] = 0;
+                if (f == 0) return;
+            }
+        }
+    }
+}
+
+ScenarioMatrix ScenarioMatrix::parse(std::istream& in) {
+    Section defaults{"default", std::vector<std::vector<double>>(NUM_FIELDS)};
+    std::vector<Section> sections;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        try {
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) continue;
+            if (line.front() == '[') {
+                if (line.back() != ']' || trim(line.substr(1, line.size() - 2)).empty()) {
+                    throw std::invalid_argument("Section headers look like [name]");
+                }
+                sections.push_back(Section{trim(line.substr(1, line.size() - 2)),
+                                           std::vector<std::vector<double>>(NUM_FIELDS)});
+                continue;
+            }
+            size_t equals = line.find('=');
+            if (equals == std::string::npos) {
+                throw std::invalid_argument("Expected key = value");
+            }
+            std::string key = trim(line.substr(0, equals));
+            std::string value = trim(line.substr(equals + 1));
+            size_t f = 0;
+            while (f < NUM_FIELDS && key != FIELDS[f].key) ++f;
+            if (f == NUM_FIELDS) {
+                throw std::invalid_argument("Unknown key " + key);
+            }
+            Section& target = sections.empty() ? defaults : sections.back();
+            if (!target.lists[f].empty()) {
+                throw std::invalid_argument("Duplicate key " + key);
+            }
+            target.lists[f] = parseList(FIELDS[f], value);
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Line " + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+
+    ScenarioMatrix matrix;
+    if (sections.empty()) {
+        expand(defaults, defaults, matrix.cells_);
+    }
+    for (const Section& section : sections) {
+        expand(defaults, section, matrix.cells_);
+    }
+    return matrix;
+}
+
+ScenarioMatrix ScenarioMatrix::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::invalid_argument("Cannot open scenario file " + path);
+    }
+    return parse(in);
+}
+
+const std::vector<ScenarioCell>& ScenarioMatrix::getCells() const {
+    return cells_;
+}
+
+size_t ScenarioMatrix::size() const {
+    return cells_.size();
+}
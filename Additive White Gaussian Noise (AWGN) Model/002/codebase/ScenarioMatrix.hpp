@@ -0,0 +1,44 @@
+#ifndef SCENARIO_MATRIX_HPP
+#define SCENARIO_MATRIX_HPP
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <cstddef> // For size_t
+#include "SimulationGraph.hpp"
+
+// One configuration of a test plan
+struct ScenarioCell {
+    std::string scenario; // Section it came from
+    SimulationParams params;
+};
+
+// A test plan read from a scenario file: "key = value" lines, where a value may
+// list several settings. Each [section] is a grid with one cell per combination
+// of its lists. Keys above the first section are defaults for every section; a
+// file without sections is a single grid named "default".
+//
+//   bits = 100000
+//   [uncoded]
+//   modulation = bpsk, qpsk, qam16
+//   seed = 1, 2, 3
+//   snr = 0:2:10
+//
+// Keys: bits, modulation (bpsk|qpsk|qam16), coding (none|conv|conv7|ldpc|turbo),
+// rate (1/2|2/3|3/4|5/6), sps, rolloff, amplitude, bitrate, bandwidth, bandlimited
+// (off|on), doppler, k, cfo, phase-noise, iq-gain, iq-phase, dc, seed and snr.
+// Numbers take "A,B,C" or "START:STEP:STOP" like --snr. Cells are listed with the
+// keys nested in that order, so snr varies fastest. '#' starts a comment.
+class ScenarioMatrix {
+private:
+    std::vector<ScenarioCell> cells_;
+
+public:
+    // Throws std::invalid_argument naming the offending line
+    static ScenarioMatrix parse(std::istream& in);
+    static ScenarioMatrix load(const std::string& path);
+    const std::vector<ScenarioCell>& getCells() const;
+    size_t size() const;
+};
+
+#endif // SCENARIO_MATRIX_HPP
@@ -0,0 +1,297 @@
+#include "ScenarioRunner.hpp"
+#include "AWGN.hpp"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+bool ScenarioRunner::Ready::operator<(const Ready& other) const {
+    // priority_queue pops the largest
+    if (rank != other.rank) return rank < other.rank;
+    if (order != other.order) return order < other.order;
+    return node > other.node;
+}
+
+ScenarioRunner::ScenarioRunner(size_t numThreads, size_t memoryBudget)
+    : numThreads_(numThreads), memoryBudget_(memoryBudget), cells_(nullptr), readyCount_(0), running_(0),
+      finished_(0), liveBytes_(0) {
+    if (numThreads == 0) {
+        throw std::invalid_argument("Scenario runner needs at least 1 thread");
+    }
+}
+
+size_t ScenarioRunner::addNode(NodeKind kind, size_t cell, const ChannelModel* channel, std::vector<size_t> inputs,
+                               size_t bytes) {
+    size_t id = nodes_.size();
+    for (size_t input : inputs) {
+        nodes_[input].consumers.push_back(id);
+        ++nodes_[input].remaining;
+    }
+    Node node{kind, cell, channel, std::move(inputs), {}, 0, 0, bytes, {}, nullptr};
+    node.waiting = node.inputs.size();
+    nodes_.push_back(std::move(node));
+    return id;
+}
+
+void ScenarioRunner::build() {
+    std::map<std::tuple<int, int, int, size_t, double>, const ChannelModel*> channelKeys;
+    std::map<std::tuple<size_t, unsigned int>, size_t> bitsKeys;                 // numBits, seed
+    std::map<std::tuple<size_t, int, int, size_t>, size_t> encodedKeys;          // bits, coding, rate, bits per symbol
+    std::map<std::tuple<size_t, int, size_t, double>, size_t> mappedKeys;        // input, modulation, sps, rolloff
+    std::map<std::tuple<size_t, double>, size_t> scaledKeys;                     // mapped, amplitude
+    std::map<std::tuple<unsigned int, size_t, bool, double>, size_t> noiseKeys;  // seed, length, bandlimited, bandwidth
+
+    for (size_t c = 0; c < cells_->size(); ++c) {
+        const SimulationParams& params = (*cells_)[c].params;
+        if (params.numBits == 0) {
+            throw std::invalid_argument("Number of bits must be greater than 0");
+        }
+        // Settings the stages ignore are left out of their keys, as in SimulationGraph
+        const bool coded = params.coding != NONE;
+        const bool shaped = params.samplesPerSymbol > 1;
+        const double rolloff = shaped ? params.rolloff : 0.0;
+        std::tuple<int, int, int, size_t, double> channelKey(params.modulation, params.coding, params.codeRate,
+                                                             params.samplesPerSymbol, rolloff);
+        const ChannelModel*& channel = channelKeys[channelKey];
+        if (!channel) {
+            std::unique_ptr<ChannelModel> model(new ChannelModel(params.modulation, params.coding));
+            if (model->supportsPuncturing()) {
+                model->setCodeRate(params.codeRate);
+            }
+            if (shaped) {
+                model->setPulseShaping(params.rolloff, params.samplesPerSymbol);
+            }
+            channel = model.get();
+            channels_.push_back(std::move(model));
+        }
+        const int rate = channel->supportsPuncturing() ? params.codeRate : RATE_1_2;
+
+        auto bits = bitsKeys.emplace(std::make_tuple(params.numBits, params.seed), nodes_.size());
+        if (bits.second) {
+            addNode(BITS_NODE, c, channel, {}, params.numBits * sizeof(int));
+        }
+        size_t upstream = bits.first->second; // What the mapper reads
+        size_t codedLength = params.numBits;
+        if (coded) {
+            codedLength = channel->encodedLength(params.numBits);
+            auto encoded = encodedKeys.emplace(
+                std::make_tuple(upstream, static_cast<int>(params.coding), rate, channel->getBitsPerSymbol()),
+                nodes_.size());
+            if (encoded.second) {
+                addNode(ENCODED_NODE, c, channel, {upstream}, codedLength * sizeof(int));
+            }
+            upstream = encoded.first->second;
+        }
+
+        const size_t length = channel->mapLength(codedLength);
+        auto mapped = mappedKeys.emplace(
+            std::make_tuple(upstream, static_cast<int>(params.modulation), params.samplesPerSymbol, rolloff),
+            nodes_.size());
+        if (mapped.second) {
+            addNode(MAPPED_NODE, c, channel, {upstream}, length * sizeof(double));
+        }
+        size_t signal = mapped.first->second;
+        if (params.amplitude != 1.0) {
+            auto scaled = scaledKeys.emplace(std::make_tuple(signal, params.amplitude), nodes_.size());
+            if (scaled.second) {
+                addNode(SCALED_NODE, c, channel, {signal}, length * sizeof(double));
+            }
+            signal = scaled.first->second;
+        }
+
+        const double shaping = params.bandlimitedNoise ? params.bandwidth : 0.0;
+        auto noise = noiseKeys.emplace(std::make_tuple(params.seed, length, params.bandlimitedNoise, shaping),
+                                       nodes_.size());
+        if (noise.second) {
+            // Noise reads no input, but waits for the first signal it is added to, so
+            // it is made right before that cell instead of being held from the start
+            addNode(NOISE_NODE, c, channel, {signal}, length * sizeof(double));
+        }
+
+        addNode(CELL_NODE, c, channel, {bits.first->second, signal, noise.first->second}, 0);
+        stats_.stagesUnshared += 4 + coded + (params.amplitude != 1.0);
+    }
+}
+
+void ScenarioRunner::push(size_t node) {
+    switch (nodes_[node].kind) {
+        case BITS_NODE: ready_.push(Ready{0, -static_cast<int64_t>(nodes_[node].cell), node}); break;
+        case ENCODED_NODE: ready_.push(Ready{1, readyCount_++, node}); break;
+        case MAPPED_NODE: ready_.push(Ready{2, readyCount_++, node}); break;
+        case SCALED_NODE: ready_.push(Ready{3, readyCount_++, node}); break;
+        case NOISE_NODE:
+        case CELL_NODE: ready_.push(Ready{4, readyCount_++, node}); break;
+    }
+}
+
+bool ScenarioRunner::canStart() const {
+    if (ready_.empty()) {
+        return false;
+    }
+    const Node& node = nodes_[ready_.top().node];
+    return node.bytes == 0 || running_ == 0 || liveBytes_ + node.bytes <= memoryBudget_;
+}
+
+void ScenarioRunner::execute(size_t id, SimulationContext& context, std::vector<double>& noisy,
+                             std::vector<double>& received, std::vector<int>& decoded) {
+    Node& node = nodes_[id];
+    const SimulationParams& params = (*cells_)[node.cell].params;
+    const ChannelModel& channel = *node.channel;
+    context.beginRun();
+    Arena& scratch = context.getArena();
+
+    switch (node.kind) {
+        case BITS_NODE:
+            node.bits.resize(params.numBits);
+            SimulationGraph::generateBits(params.numBits, params.seed, node.bits.data());
+            break;
+        case ENCODED_NODE: {
+            const std::vector<int>& bits = nodes_[node.inputs[0]].bits;
+            node.bits.resize(channel.encodedLength(bits.size()));
+            node.bits.resize(channel.encode(bits.data(), bits.size(), node.bits.data(), scratch));
+            break;
+        }
+        case MAPPED_NODE: {
+            const std::vector<int>& encoded = nodes_[node.inputs[0]].bits;
+            node.samples = std::make_shared<std::vector<double>>(channel.mapLength(encoded.size()));
+            node.samples->resize(channel.map(encoded.data(), encoded.size(), node.samples->data(), scratch));
+            break;
+        }
+        case SCALED_NODE: {
+            const std::vector<double>& modulated = *nodes_[node.inputs[0]].samples;
+            node.samples = std::make_shared<std::vector<double>>(modulated.size());
+            for (size_t i = 0; i < modulated.size(); ++i) {
+                (*node.samples)[i] = modulated[i] * params.amplitude;
+            }
+            break;
+        }
+        case NOISE_NODE: {
+            // What AWGN::drawNoise would generate for this seed and shaping
+            AWGN awgn(params.snrDb, params.bitRate, params.bandwidth, params.modulation, NONE, params.seed);
+            if (params.bandlimitedNoise) {
+                awgn.enableBandlimitedNoise();
+            }
+            node.samples = std::make_shared<std::vector<double>>(node.bytes / sizeof(double));
+            AWGN::generateShapedNoise(awgn.getNoiseShaper(), params.seed, node.samples->data(), node.samples->size(),
+                                      scratch);
+            break;
+        }
+        case CELL_NODE: {
+            const std::vector<int>& bits = nodes_[node.inputs[0]].bits;
+            const std::vector<double>& scaled = *nodes_[node.inputs[1]].samples;
+            const size_t length = scaled.size();
+            AWGN awgn(params.snrDb, params.bitRate, params.bandwidth, params.modulation, NONE, params.seed);
+            awgn.setUnitNoise(nodes_[node.inputs[2]].samples);
+            noisy.resize(length);
+            received.resize(length);
+            SimulationGraph::applyChannel(params, channel.getBitsPerSymbol(), scaled.data(), length, awgn,
+                                          noisy.data(), received.data(), scratch);
+            decoded.resize(channel.demodulatedLength(length));
+            decoded.resize(channel.demodulate(received.data(), length, decoded.data(), scratch));
+            double ebN0;
+            size_t errors = SimulationGraph::measure(params, bits.data(), bits.size(), decoded.data(), decoded.size(),
+                                                     scaled.data(), length, ebN0);
+            results_[node.cell] = ScenarioResult{bits.size(), errors, static_cast<double>(errors) / bits.size(), ebN0};
+            break;
+        }
+    }
+}
+
+void ScenarioRunner::finish(size_t id) {
+    Node& node = nodes_[id];
+    --running_;
+    ++finished_;
+    for (size_t input : node.inputs) {
+        Node& source = nodes_[input];
+        if (--source.remaining == 0) {
+            liveBytes_ -= source.bytes;
+            std::vector<int>().swap(source.bits);
+            source.samples.reset();
+        }
+    }
+    for (size_t consumer : node.consumers) {
+        if (--nodes_[consumer].waiting == 0) {
+            push(consumer);
+        }
+    }
+    if (node.consumers.empty()) {
+        liveBytes_ -= node.bytes;
+    }
+}
+
+void ScenarioRunner::work() {
+    SimulationContext context;
+    std::vector<double> noisy, received; // Per cell, reused across cells
+    std::vector<int> decoded;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        changed_.wait(lock, [this] { return error_ || finished_ == nodes_.size() || canStart(); });
+        if (error_ || finished_ == nodes_.size()) {
+            return;
+        }
+        size_t id = ready_.top().node;
+        ready_.pop();
+        ++running_;
+        liveBytes_ += nodes_[id].bytes;
+        stats_.peakBytes = std::max(stats_.peakBytes, liveBytes_);
+        lock.unlock();
+        try {
+            execute(id, context, noisy, received, decoded);
+        } catch (...) {
+            lock.lock();
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            changed_.notify_all();
+            return;
+        }
+        lock.lock();
+        finish(id);
+        changed_.notify_all();
+    }
+}
+
+std::vector<ScenarioResult> ScenarioRunner::run(const std::vector<ScenarioCell>& cells) {
+    auto start = std::chrono::steady_clock::now();
+    cells_ = &cells;
+    stats_ = ScenarioRunStats();
+    channels_.clear();
+    nodes_.clear();
+    results_.assign(cells.size(), ScenarioResult{0, 0, 0.0, 0.0});
+    ready_ = std::priority_queue<Ready>();
+    readyCount_ = 0;
+    running_ = 0;
+    finished_ = 0;
+    liveBytes_ = 0;
+    error_ = nullptr;
+
+    build();
+    for (size_t id = 0; id < nodes_.size(); ++id) {
+        if (nodes_[id].waiting == 0) {
+            push(id);
+        }
+    }
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < numThreads_; ++t) {
+        workers.emplace_back(&ScenarioRunner::work, this);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    cells_ = nullptr;
+    stats_.cells = cells.size();
+    stats_.stagesRun = nodes_.size();
+    nodes_.clear();
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return std::move(results_);
+}
+
+const ScenarioRunStats& ScenarioRunner::getStats() const {
+    return stats_;
+}
@@ -0,0 +1,102 @@
+#ifndef SCENARIO_RUNNER_HPP
+#define SCENARIO_RUNNER_HPP
+
+#include <vector>
+#include <memory>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "ScenarioMatrix.hpp"
+
+struct ScenarioResult {
+    size_t bits;
+    size_t errors;
+    double ber;
+    double ebN0;
+};
+
+struct ScenarioRunStats {
+    size_t cells = 0;
+    size_t stagesRun = 0;      // Nodes computed, cells included
+    size_t stagesUnshared = 0; // Nodes the cells would compute each on their own
+    size_t peakBytes = 0;      // Most memory held by stage outputs at once
+    double seconds = 0.0;
+};
+
+// Runs the cells of a test plan as one DAG of SimulationGraph stages:
+//   bits -> encoded -> mapped -> scaled -> cell (channel, decode, metrics)
+//                                           unit noise -^
+// A stage is keyed like the SimulationGraph node it stands for, so cells that
+// agree on everything upstream share one computation: the bits of a seed feed
+// every modulation and coding, one mapping feeds every SNR, and one unit-noise
+// block serves every cell with its seed and length. Uncoded cells map the bits
+// directly, and unit amplitude skips the scaling.
+//
+// Worker threads run ready stages deepest first, newest first among equals, so
+// a finished stage's consumers run before new work starts upstream and its
+// output is freed as soon as its last consumer is done. Unit noise waits for
+// the signal of the first cell it serves, so it is not held while that cell's
+// upstream stages run. Bits, which start a subtree, go in grid order. A stage
+// with an output only starts while the outputs fit the memory budget (or when
+// nothing else is running). Results match SimulationGraph::run on each cell
+// and do not depend on the schedule.
+class ScenarioRunner {
+public:
+    explicit ScenarioRunner(size_t numThreads = 1, size_t memoryBudget = size_t(1) << 30);
+    std::vector<ScenarioResult> run(const std::vector<ScenarioCell>& cells); // In cell order
+    const ScenarioRunStats& getStats() const; // Of the last run()
+
+private:
+    enum NodeKind { BITS_NODE, ENCODED_NODE, MAPPED_NODE, SCALED_NODE, NOISE_NODE, CELL_NODE };
+
+    struct Node {
+        NodeKind kind;
+        size_t cell;            // Cell whose parameters configure the stage: the first to need it
+        const ChannelModel* channel;
+        std::vector<size_t> inputs;
+        std::vector<size_t> consumers;
+        size_t waiting;         // Inputs not computed yet
+        size_t remaining;       // Consumers not done; the output is freed at 0
+        size_t bytes;           // Output size
+        std::vector<int> bits;  // Bits and encoded outputs
+        std::shared_ptr<std::vector<double>> samples; // Mapped, scaled and noise outputs
+    };
+
+    struct Ready {
+        int rank;        // Stage depth, 0 for bits
+        int64_t order;   // Newest first above rank 0, grid order at rank 0
+        size_t node;
+        bool operator<(const Ready& other) const;
+    };
+
+    size_t numThreads_;
+    size_t memoryBudget_;
+    ScenarioRunStats stats_;
+    const std::vector<ScenarioCell>* cells_;
+    std::vector<std::unique_ptr<ChannelModel>> channels_;
+    std::vector<Node> nodes_;
+    std::vector<ScenarioResult> results_;
+
+    std::mutex mutex_; // Guards the scheduling state below
+    std::condition_variable changed_;
+    std::priority_queue<Ready> ready_;
+    int64_t readyCount_;
+    size_t running_;
+    size_t finished_;
+    size_t liveBytes_;
+    std::exception_ptr error_;
+
+    void build(); // The DAG of cells_
+    size_t addNode(NodeKind kind, size_t cell, const ChannelModel* channel, std::vector<size_t> inputs, size_t bytes);
+    void push(size_t node);
+    bool canStart() const;
+    void execute(size_t node, SimulationContext& context, std::vector<double>& noisy, std::vector<double>& received,
+                 std::vector<int>& decoded);
+    void finish(size_t node);
+    void work();
+};
+
+#endif // SCENARIO_RUNNER_HPP
@@ -1,12 +1,16 @@
 #include "SignalGenerator.hpp"
+#include "Oscillator.hpp"
 
 SignalGenerator::SignalGenerator(size_t numSamples, double amplitude, double frequency)
     : numSamples_(numSamples), amplitude_(amplitude), frequency_(frequency) {}
 
 std::vector<double> SignalGenerator::generateSineWave() {
     std::vector<double> signal(numSamples_);
-    for (size_t i = 0; i < numSamples_; ++i) {
-        signal[i] = amplitude_ * std::sin(2.0 * Constants::PI * frequency_ * i);
-    }
+    generateSineWave(signal.data(), 1);
     return signal;
+}
+
+void SignalGenerator::generateSineWave(double* out, size_t stride) {
+    // Exact fixed-point phase, so long signals do not lose precision as i grows
+    Oscillator::tone(frequency_, amplitude_).generate(out, numSamples_, stride);
 }
\ No newline at end of file
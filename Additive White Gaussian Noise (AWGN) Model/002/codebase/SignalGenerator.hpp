@@ -8,6 +8,7 @@ class SignalGenerator {
 public:
     SignalGenerator(size_t numSamples, double amplitude, double frequency);
     std::vector<double> generateSineWave();
+    void generateSineWave(double* out, size_t stride); // Writes numSamples values, `stride` apart
 
 private:
     size_t numSamples_;
@@ -1,15 +1,29 @@
 #include "SignalToNoiseRatio.hpp"
 #include <cmath>
-#include <numeric>
 #include "Common.hpp"
+#include "CpuDispatch.hpp"
 
 SignalToNoiseRatio::SignalToNoiseRatio(double targetSNRdB, double bitRate, double bandwidth)
     : targetSNRdB_(targetSNRdB), bitRate_(bitRate), bandwidth_(bandwidth) {}
 
 double SignalToNoiseRatio::calculateEbN0(const std::vector<double>& signal) const {
+    return calculateEbN0(signal.data(), signal.size());
+}
+
+double SignalToNoiseRatio::meanPower(const double* signal, size_t numSamples, size_t stride) {
+    if (stride == 1) {
+        return CpuDispatch::kernels().sumSquares(signal, numSamples) / numSamples;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < numSamples; ++i) {
+        sum += signal[i * stride] * signal[i * stride];
+    }
+    return sum / numSamples;
+}
+
+double SignalToNoiseRatio::calculateEbN0(const double* signal, size_t numSamples, size_t stride) const {
     // Calculate signal power
-    double signalPower = std::accumulate(signal.begin(), signal.end(), 0.0,
-        [](double sum, double x) { return sum + x * x; }) / signal.size();
+    double signalPower = meanPower(signal, numSamples, stride);
     
     // Calculate noise power from SNR
     double noisePower = calculateNoisePower(signalPower, targetSNRdB_);
@@ -27,9 +41,12 @@ double SignalToNoiseRatio::calculateNoisePower(double signalPower, double snr_dB
 }
 
 void SignalToNoiseRatio::adjustNoisePower(std::vector<double>& signal, double& noisePower) const {
+    adjustNoisePower(signal.data(), signal.size(), noisePower);
+}
+
+void SignalToNoiseRatio::adjustNoisePower(const double* signal, size_t numSamples, double& noisePower, size_t stride) const {
     // Calculate current signal power
-    double signalPower = std::accumulate(signal.begin(), signal.end(), 0.0,
-        [](double sum, double x) { return sum + x * x; }) / signal.size();
+    double signalPower = meanPower(signal, numSamples, stride);
     
     // Adjust noise power to achieve target SNR
     noisePower = calculateNoisePower(signalPower, targetSNRdB_);
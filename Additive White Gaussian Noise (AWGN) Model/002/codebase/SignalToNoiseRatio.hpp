@@ -2,6 +2,7 @@
 #define SIGNAL_TO_NOISE_RATIO_HPP
 
 #include <vector>
+#include <cstddef> // For size_t
 
 class SignalToNoiseRatio {
 private:
@@ -9,11 +10,14 @@ private:
     double bitRate_;
     double bandwidth_;
     double calculateNoisePower(double signalPower, double snr_dB) const;
+    static double meanPower(const double* signal, size_t numSamples, size_t stride);
 
 public:
     SignalToNoiseRatio(double targetSNRdB, double bitRate, double bandwidth);
     double calculateEbN0(const std::vector<double>& signal) const;
+    double calculateEbN0(const double* signal, size_t numSamples, size_t stride = 1) const;
     void adjustNoisePower(std::vector<double>& signal, double& noisePower) const;
+    void adjustNoisePower(const double* signal, size_t numSamples, double& noisePower, size_t stride = 1) const;
     double getTargetSNRdB() const;
     void setTargetSNRdB(double snr_dB);
     double getBitRate() const;
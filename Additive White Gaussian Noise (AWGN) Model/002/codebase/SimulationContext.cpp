@@ -0,0 +1,17 @@
+#include "SimulationContext.hpp"
+
+SimulationContext::SimulationContext(size_t initialBytes, bool useHugePages)
+    : arena_(initialBytes, useHugePages), runs_(0) {}
+
+void SimulationContext::beginRun() {
+    arena_.reset();
+    ++runs_;
+}
+
+Arena& SimulationContext::getArena() {
+    return arena_;
+}
+
+size_t SimulationContext::getRunCount() const {
+    return runs_;
+}
@@ -0,0 +1,27 @@
+#ifndef SIMULATION_CONTEXT_HPP
+#define SIMULATION_CONTEXT_HPP
+
+#include <cstddef> // For size_t
+#include "Arena.hpp"
+
+// Owns the scratch memory of a simulation run. Create one per GUI session or
+// sweep, call beginRun() before each run or sweep point, and take every
+// intermediate buffer (bits, symbols, noise, decoded bits) from it. After the
+// first run has sized the arena, later runs of the same size allocate nothing.
+class SimulationContext {
+private:
+    Arena arena_;
+    size_t runs_;
+
+public:
+    explicit SimulationContext(size_t initialBytes = size_t(1) << 20, bool useHugePages = false);
+    void beginRun();
+    template <typename T>
+    T* allocate(size_t count) {
+        return arena_.allocate<T>(count);
+    }
+    Arena& getArena();
+    size_t getRunCount() const;
+};
+
+#endif // SIMULATION_CONTEXT_HPP
@@ -0,0 +1,217 @@
+#include "SimulationGraph.hpp"
+#include "AWGN.hpp"
+#include "FadingChannel.hpp"
+#include "ImpairmentChain.hpp"
+#include "SignalToNoiseRatio.hpp"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+SimulationGraph::SimulationGraph(std::shared_ptr<NoiseCache> cache)
+    : channelKey_(-1, -1, -1, 0, 0.0), noiseCache_(std::move(cache)), ber_(0.0), ebN0_(0.0) {}
+
+const ChannelModel& SimulationGraph::channelFor(const SimulationParams& params) {
+    std::tuple<int, int, int, size_t, double> key(params.modulation, params.coding, params.codeRate,
+                                                  params.samplesPerSymbol, params.rolloff);
+    if (!channel_ || !(key == channelKey_)) {
+        std::unique_ptr<ChannelModel> channel(new ChannelModel(params.modulation, params.coding));
+        if (channel->supportsPuncturing()) {
+            channel->setCodeRate(params.codeRate);
+        }
+        if (params.samplesPerSymbol > 1) {
+            channel->setPulseShaping(params.rolloff, params.samplesPerSymbol);
+        }
+        channel_ = std::move(channel);
+        channelKey_ = key;
+    }
+    return *channel_;
+}
+
+unsigned int SimulationGraph::run(const SimulationParams& params) {
+    if (params.numBits == 0) {
+        throw std::invalid_argument("Number of bits must be greater than 0");
+    }
+    const ChannelModel& channel = channelFor(params);
+    context_.beginRun();
+    Arena& scratch = context_.getArena();
+    unsigned int recomputed = 0;
+
+    auto bitsKey = std::make_tuple(params.numBits, params.seed);
+    if (bitsNode_.isStale(bitsKey)) {
+        bits_.resize(params.numBits);
+        generateBits(params.numBits, params.seed, bits_.data());
+        bitsNode_.store(bitsKey);
+        recomputed |= STAGE_BITS;
+    }
+
+    // Codewords are padded to whole symbols, so the modulation's symbol size is part of the key
+    auto encodedKey = std::make_tuple(bitsNode_.version, static_cast<int>(params.coding), static_cast<int>(params.codeRate),
+                                      channel.getBitsPerSymbol());
+    if (encodedNode_.isStale(encodedKey)) {
+        encoded_.resize(channel.encodedLength(bits_.size()));
+        encoded_.resize(channel.encode(bits_.data(), bits_.size(), encoded_.data(), scratch));
+        encodedNode_.store(encodedKey);
+        recomputed |= STAGE_ENCODED;
+    }
+
+    auto modulatedKey = std::make_tuple(encodedNode_.version, static_cast<int>(params.modulation),
+                                        params.samplesPerSymbol, params.rolloff);
+    if (modulatedNode_.isStale(modulatedKey)) {
+        modulated_.resize(channel.mapLength(encoded_.size()));
+        modulated_.resize(channel.map(encoded_.data(), encoded_.size(), modulated_.data(), scratch));
+        modulatedNode_.store(modulatedKey);
+        recomputed |= STAGE_MODULATED;
+    }
+
+    auto scaledKey = std::make_tuple(modulatedNode_.version, params.amplitude);
+    if (scaledNode_.isStale(scaledKey)) {
+        scaled_.resize(modulated_.size());
+        for (size_t i = 0; i < modulated_.size(); ++i) {
+            scaled_[i] = modulated_[i] * params.amplitude;
+        }
+        scaledNode_.store(scaledKey);
+        recomputed |= STAGE_SCALED;
+    }
+
+    auto noisyKey = std::make_tuple(scaledNode_.version, params.snrDb, params.bandwidth, params.bandlimitedNoise,
+                                    params.seed, params.doppler, params.kFactor,
+                                    ImpairmentKey(params.frequencyOffset, params.phaseNoise, params.iqGainDb,
+                                                  params.iqPhaseDeg, params.dcOffset));
+    if (noisyNode_.isStale(noisyKey)) {
+        // The unit noise comes from the cache, so an SNR-only change is a rescale
+        AWGN awgn(params.snrDb, params.bitRate, params.bandwidth, params.modulation, params.coding, params.seed);
+        if (params.bandlimitedNoise) {
+            awgn.enableBandlimitedNoise();
+        }
+        awgn.setNoiseCache(noiseCache_);
+
+        const size_t length = scaled_.size();
+        noisy_.resize(length);
+        received_.resize(length);
+        applyChannel(params, channel.getBitsPerSymbol(), scaled_.data(), length, awgn, noisy_.data(),
+                     received_.data(), scratch);
+        noisyNode_.store(noisyKey);
+        recomputed |= STAGE_NOISY;
+    }
+
+    auto decodedKey = std::make_tuple(noisyNode_.version);
+    if (decodedNode_.isStale(decodedKey)) {
+        decoded_.resize(channel.demodulatedLength(received_.size()));
+        decoded_.resize(channel.demodulate(received_.data(), received_.size(), decoded_.data(), scratch));
+        decodedNode_.store(decodedKey);
+        recomputed |= STAGE_DECODED;
+    }
+
+    auto metricsKey = std::make_tuple(decodedNode_.version, scaledNode_.version, params.snrDb,
+                                      params.bitRate, params.bandwidth);
+    if (metricsNode_.isStale(metricsKey)) {
+        size_t errors = measure(params, bits_.data(), bits_.size(), decoded_.data(), decoded_.size(), scaled_.data(),
+                                scaled_.size(), ebN0_);
+        ber_ = static_cast<double>(errors) / bits_.size();
+        metricsNode_.store(metricsKey);
+        recomputed |= STAGE_METRICS;
+    }
+    return recomputed;
+}
+
+void SimulationGraph::invalidate() {
+    bitsNode_.valid = false;
+    encodedNode_.valid = false;
+    modulatedNode_.valid = false;
+    scaledNode_.valid = false;
+    noisyNode_.valid = false;
+    decodedNode_.valid = false;
+    metricsNode_.valid = false;
+}
+
+bool SimulationGraph::hasResults() const {
+    return metricsNode_.valid;
+}
+
+const std::vector<int>& SimulationGraph::getBits() const {
+    return bits_;
+}
+
+const std::vector<double>& SimulationGraph::getSignal() const {
+    return scaled_;
+}
+
+const std::vector<double>& SimulationGraph::getNoisySignal() const {
+    return noisy_;
+}
+
+const std::vector<double>& SimulationGraph::getReceivedSignal() const {
+    return received_;
+}
+
+const ChannelModel& SimulationGraph::getChannel() const {
+    if (!channel_) {
+        throw std::logic_error("No channel before the first run");
+    }
+    return *channel_;
+}
+
+const std::vector<int>& SimulationGraph::getDecodedBits() const {
+    return decoded_;
+}
+
+double SimulationGraph::getBER() const {
+    return ber_;
+}
+
+double SimulationGraph::getEbN0() const {
+    return ebN0_;
+}
+
+void SimulationGraph::generateBits(size_t numBits, unsigned int seed, int* bits) {
+    // Same bit sequence as the original Generate handler
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> bitDist(0, 1);
+    for (size_t i = 0; i < numBits; ++i) {
+        bits[i] = bitDist(gen);
+    }
+}
+
+void SimulationGraph::applyChannel(const SimulationParams& params, size_t stride, const double* scaled, size_t length,
+                                   AWGN& awgn, double* noisy, double* received, Arena& scratch) {
+    std::unique_ptr<FadingChannel> fading;
+    const double* faded = scaled;
+    if (params.doppler > 0) {
+        // Flat fading ahead of the noise; the receiver removes the known gains
+        fading.reset(new FadingChannel(params.doppler, params.kFactor, 16, params.seed));
+        std::copy(scaled, scaled + length, received);
+        fading->apply(received, length, stride);
+        faded = received;
+    }
+    if (params.hasImpairments()) {
+        // Transmitter CFO and phase noise, channel noise, then the receiver's IQ
+        // imbalance and DC offset, all in one pass
+        auto chain = makeImpairmentChain(FrequencyOffsetStage(params.frequencyOffset),
+                                         PhaseNoiseStage(params.phaseNoise, params.seed), NoiseStage(),
+                                         IqImbalanceStage(params.iqGainDb, params.iqPhaseDeg),
+                                         DcOffsetStage(params.dcOffset, params.dcOffset));
+        double noiseStdDev;
+        NoisePool::Lease lease;
+        const double* noise = awgn.drawNoise(faded, 1, length, noiseStdDev, lease, scratch);
+        chain.get<NoiseStage>().setNoise(noise, noiseStdDev);
+        chain.process(faded, length, stride, noisy);
+    } else {
+        awgn.addNoise(faded, length, noisy, scratch);
+    }
+    std::copy(noisy, noisy + length, received);
+    if (fading) {
+        fading->compensate(received, length, stride);
+    }
+}
+
+size_t SimulationGraph::measure(const SimulationParams& params, const int* bits, size_t numBits, const int* decoded,
+                                size_t numDecoded, const double* scaled, size_t length, double& ebN0) {
+    size_t errors = 0;
+    for (size_t i = 0; i < numBits && i < numDecoded; ++i) {
+        if (bits[i] != decoded[i]) errors++;
+    }
+    SignalToNoiseRatio snrController(params.snrDb, params.bitRate, params.bandwidth);
+    ebN0 = snrController.calculateEbN0(scaled, length);
+    return errors;
+}
@@ -0,0 +1,130 @@
+#ifndef SIMULATION_GRAPH_HPP
+#define SIMULATION_GRAPH_HPP
+
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "ChannelModel.hpp"
+#include "NoiseCache.hpp"
+#include "SimulationContext.hpp"
+
+class AWGN;
+
+// Everything the Generate pipeline reads from the GUI
+struct SimulationParams {
+    size_t numBits = 1000;
+    unsigned int seed = 0;
+    ModulationType modulation = BPSK;
+    CodingType coding = NONE;
+    CodeRate codeRate = RATE_1_2; // Convolutional codes only
+    size_t samplesPerSymbol = 1; // 1 disables pulse shaping
+    double rolloff = 0.35;
+    double amplitude = 1.0;
+    double snrDb = 10.0;
+    double bitRate = 1000.0;
+    double bandwidth = 0.1;
+    bool bandlimitedNoise = false;
+    double doppler = 0.0; // 0 disables fading
+    double kFactor = 0.0;
+    double frequencyOffset = 0.0; // Cycles per sample
+    double phaseNoise = 0.0;      // Wiener phase noise, radians per sample
+    double iqGainDb = 0.0;        // I/Q amplitude imbalance
+    double iqPhaseDeg = 0.0;      // Quadrature error
+    double dcOffset = 0.0;        // Added to I and Q
+
+    bool hasImpairments() const {
+        return frequencyOffset != 0.0 || phaseNoise > 0.0 || iqGainDb != 0.0 || iqPhaseDeg != 0.0 ||
+               dcOffset != 0.0;
+    }
+};
+
+// Stage bits returned by SimulationGraph::run()
+enum SimulationStage : unsigned int {
+    STAGE_BITS = 1u << 0,
+    STAGE_ENCODED = 1u << 1,
+    STAGE_MODULATED = 1u << 2,
+    STAGE_SCALED = 1u << 3,
+    STAGE_NOISY = 1u << 4,
+    STAGE_DECODED = 1u << 5,
+    STAGE_METRICS = 1u << 6
+};
+
+// Dependency-tracked Generate pipeline:
+//   bits -> encoded -> modulated -> scaled -> noisy -> decoded -> metrics
+// The noisy node adds the RF impairments and the noise in one fused pass.
+// Each node keeps its output and the key it was computed from (its own
+// parameters plus the versions of its inputs). run() recomputes a node only
+// when that key changed, so a new SNR redoes noise and below, and the SNR
+// change itself only rescales the cached unit noise.
+class SimulationGraph {
+private:
+    template <typename Key>
+    struct Node {
+        Key key;
+        bool valid = false;
+        uint64_t version = 0; // Bumped on every recompute; downstream keys include it
+        bool isStale(const Key& k) const { return !valid || !(key == k); }
+        void store(const Key& k) {
+            key = k;
+            valid = true;
+            ++version;
+        }
+    };
+
+    Node<std::tuple<size_t, unsigned int>> bitsNode_;                     // numBits, seed
+    Node<std::tuple<uint64_t, int, int, size_t>> encodedNode_;            // bits, coding, code rate, bits per symbol
+    Node<std::tuple<uint64_t, int, size_t, double>> modulatedNode_;       // encoded, modulation, sps, rolloff
+    Node<std::tuple<uint64_t, double>> scaledNode_;                       // modulated, amplitude
+    using ImpairmentKey = std::tuple<double, double, double, double, double>; // CFO, phase noise, IQ gain, IQ phase, DC
+    Node<std::tuple<uint64_t, double, double, bool, unsigned int, double, double, ImpairmentKey>> noisyNode_; // scaled, SNR, bandwidth, bandlimited, seed, doppler, K, impairments
+    Node<std::tuple<uint64_t>> decodedNode_;                              // noisy
+    Node<std::tuple<uint64_t, uint64_t, double, double, double>> metricsNode_; // decoded, scaled, SNR, bit rate, bandwidth
+
+    std::unique_ptr<ChannelModel> channel_;
+    std::tuple<int, int, int, size_t, double> channelKey_; // Configuration channel_ was built with
+    std::shared_ptr<NoiseCache> noiseCache_;
+    SimulationContext context_;
+
+    std::vector<int> bits_;
+    std::vector<int> encoded_;
+    std::vector<double> modulated_;
+    std::vector<double> scaled_;
+    std::vector<double> noisy_;    // After fading and noise, as plotted
+    std::vector<double> received_; // noisy_ with the fading gains removed
+    std::vector<int> decoded_;
+    double ber_;
+    double ebN0_;
+
+    const ChannelModel& channelFor(const SimulationParams& params);
+
+public:
+    explicit SimulationGraph(std::shared_ptr<NoiseCache> cache = std::make_shared<NoiseCache>(size_t(32) << 20));
+    // Brings every node up to date with `params`; returns the SimulationStage bits recomputed
+    unsigned int run(const SimulationParams& params);
+    void invalidate(); // Forces the next run() to recompute everything
+    bool hasResults() const;
+
+    const std::vector<int>& getBits() const;
+    const std::vector<double>& getSignal() const; // Scaled transmit signal
+    const std::vector<double>& getNoisySignal() const;
+    const std::vector<double>& getReceivedSignal() const; // Noisy signal with the fading gains removed
+    const ChannelModel& getChannel() const; // Configured by the last run()
+    const std::vector<int>& getDecodedBits() const;
+    double getBER() const;
+    double getEbN0() const;
+
+    // The node computations of run(), for callers that schedule and share them
+    // across configurations themselves, like ScenarioRunner
+    static void generateBits(size_t numBits, unsigned int seed, int* bits);
+    // Noisy node: fading, impairments and the noise of `awgn` on `length` scaled
+    // values. received is noisy with the fading gains removed.
+    static void applyChannel(const SimulationParams& params, size_t stride, const double* scaled, size_t length,
+                             AWGN& awgn, double* noisy, double* received, Arena& scratch);
+    // Metrics node: bit errors against the decoded bits, and Eb/N0 of the scaled signal
+    static size_t measure(const SimulationParams& params, const int* bits, size_t numBits, const int* decoded,
+                          size_t numDecoded, const double* scaled, size_t length, double& ebN0);
+};
+
+#endif // SIMULATION_GRAPH_HPP
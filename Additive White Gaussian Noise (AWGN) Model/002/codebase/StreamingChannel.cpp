@@ -0,0 +1,170 @@
+#include "StreamingChannel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "AWGN.hpp"
+#include "ImpairmentChain.hpp"
+
+StreamingChannel::StreamingChannel(size_t capacity)
+    : ring_(capacity), received_(capacity), running_(false), produced_(0), dropped_(0) {}
+
+StreamingChannel::~StreamingChannel() {
+    stop();
+}
+
+void StreamingChannel::start(const SimulationParams& params, double sampleRate) {
+    if (!(sampleRate > 0)) {
+        throw std::invalid_argument("Sample rate must be greater than 0");
+    }
+    stop();
+    // Leftovers of the previous run may not match the new parameters
+    ring_.discard(ring_.capacity());
+    received_.discard(received_.capacity());
+    produced_ = 0;
+    dropped_ = 0;
+    running_ = true;
+    thread_ = std::thread(&StreamingChannel::produce, this, params, sampleRate);
+}
+
+void StreamingChannel::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool StreamingChannel::isRunning() const {
+    return running_;
+}
+
+void StreamingChannel::produce(SimulationParams params, double sampleRate) {
+    try {
+        produceBlocks(params, sampleRate);
+    } catch (const std::exception&) {
+        // Nothing can be reported from this thread; the reader sees the stream stop
+    }
+    running_ = false;
+}
+
+void StreamingChannel::produceBlocks(const SimulationParams& params, double sampleRate) {
+    using Clock = std::chrono::steady_clock;
+
+    AWGN awgn(params.snrDb, params.bitRate, params.bandwidth, params.modulation, NONE, params.seed);
+    if (params.bandlimitedNoise) {
+        awgn.enableBandlimitedNoise();
+    }
+    // Block b + 1's noise is generated while block b is mapped, filtered and paced
+    awgn.setNoisePool(std::make_shared<NoisePool>());
+    ChannelModel& channel = awgn.getChannelModel();
+    if (params.samplesPerSymbol > 1) {
+        channel.setPulseShaping(params.rolloff, params.samplesPerSymbol);
+    }
+
+    // About 2 ms of samples per block, in whole symbols
+    const size_t samplesPerBit = std::max<size_t>(1, params.samplesPerSymbol);
+    size_t numBits = static_cast<size_t>(sampleRate * 0.002) / samplesPerBit;
+    numBits = std::min<size_t>(std::max<size_t>(numBits, 64), 1 << 16);
+    numBits = numBits / channel.getBitsPerSymbol() * channel.getBitsPerSymbol();
+
+    std::mt19937 gen(params.seed);
+    std::vector<int> bits(numBits);
+    std::vector<double> signal(channel.mapLength(numBits));
+    std::vector<double> noisy(signal.size());
+    std::vector<StreamSample> samples(signal.size());
+    std::vector<double> waveform(channel.receivedWaveformLength(signal.size()));
+    Arena scratch;
+    const size_t stride = channel.getBitsPerSymbol();
+
+    // Gain, impairments and noise in a single pass per block; the stateful stages
+    // carry their phase from block to block
+    auto run = [&](auto& chain) {
+        Clock::time_point epoch = Clock::now();
+        uint64_t paced = 0; // Samples produced since epoch
+        for (uint64_t block = 0; running_; ++block) {
+            for (int& bit : bits) {
+                bit = gen() & 1;
+            }
+            scratch.reset();
+            size_t length = channel.map(bits.data(), numBits, signal.data(), scratch);
+            // The SNR is set against the transmitted power, amplitude^2 times the mapped power
+            awgn.setSeed(static_cast<unsigned int>(params.seed + block));
+            double noiseStdDev;
+            NoisePool::Lease lease;
+            const double* noise = awgn.drawNoise(signal.data(), 1, length, noiseStdDev, lease, scratch);
+            chain.template get<NoiseStage>().setNoise(noise, std::fabs(params.amplitude) * noiseStdDev);
+            chain.process(signal.data(), length, stride, noisy.data());
+            lease.release();
+            for (size_t i = 0; i < length; ++i) {
+                samples[i] = {params.amplitude * signal[i], noisy[i]};
+            }
+
+            size_t written = ring_.write(samples.data(), length);
+            produced_ += length;
+            dropped_ += length - written;
+            size_t filtered = channel.receiveWaveform(noisy.data(), length, waveform.data());
+            if (received_.capacity() - received_.available() >= filtered) {
+                received_.write(waveform.data(), filtered);
+            }
+
+            // Sleep until this block is due; after a long stall, restart the pacing
+            // instead of bursting to catch up
+            paced += length;
+            Clock::time_point due = epoch + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(paced / sampleRate));
+            Clock::time_point now = Clock::now();
+            if (now - due > std::chrono::milliseconds(100)) {
+                epoch = now;
+                paced = 0;
+            } else if (due > now) {
+                std::this_thread::sleep_until(due);
+            }
+        }
+    };
+    // The rotation stages cost a phasor table per chunk, so they only run when set
+    if (params.hasImpairments()) {
+        auto chain = makeImpairmentChain(GainStage(params.amplitude), FrequencyOffsetStage(params.frequencyOffset),
+                                         PhaseNoiseStage(params.phaseNoise, params.seed), NoiseStage(),
+                                         IqImbalanceStage(params.iqGainDb, params.iqPhaseDeg),
+                                         DcOffsetStage(params.dcOffset, params.dcOffset));
+        run(chain);
+    } else {
+        auto chain = makeImpairmentChain(GainStage(params.amplitude), NoiseStage());
+        run(chain);
+    }
+}
+
+size_t StreamingChannel::read(StreamSample* out, size_t count) {
+    return ring_.read(out, count);
+}
+
+size_t StreamingChannel::discard(size_t count) {
+    return ring_.discard(count);
+}
+
+size_t StreamingChannel::available() const {
+    return ring_.available();
+}
+
+size_t StreamingChannel::readReceived(double* out, size_t count) {
+    return received_.read(out, count);
+}
+
+size_t StreamingChannel::discardReceived(size_t count) {
+    return received_.discard(count);
+}
+
+size_t StreamingChannel::availableReceived() const {
+    return received_.available();
+}
+
+uint64_t StreamingChannel::getProducedSamples() const {
+    return produced_;
+}
+
+uint64_t StreamingChannel::getDroppedSamples() const {
+    return dropped_;
+}
@@ -0,0 +1,66 @@
+#ifndef STREAMING_CHANNEL_HPP
+#define STREAMING_CHANNEL_HPP
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "RingBuffer.hpp"
+#include "SimulationGraph.hpp"
+
+struct StreamSample {
+    double original; // Scaled transmit sample
+    double noisy;
+};
+
+// Runs the uncoded transmit chain (bits -> map and pulse shaping -> scale ->
+// AWGN) on a background thread and writes the samples into a RingBuffer at a
+// fixed sample rate, for the GUI's oscilloscope mode. Coding and fading
+// parameters are ignored; they do not change what the waveform looks like.
+//
+// Samples are produced in blocks of about 2 ms, each with noise seed
+// seed + block index; a NoisePool thread generates each block's noise while
+// the previous block is processed. If the reader falls behind, the ring fills
+// up and new samples are dropped and counted rather than blocking the producer.
+//
+// A second ring carries each block's receive-filtered noisy samples
+// (ChannelModel::receiveWaveform) for the constellation and eye plots. Blocks
+// are whole symbol periods and go in whole or not at all, so the reader stays
+// aligned to symbols as long as it reads and discards in whole symbol periods.
+class StreamingChannel {
+private:
+    RingBuffer<StreamSample> ring_;
+    RingBuffer<double> received_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> produced_;
+    std::atomic<uint64_t> dropped_;
+
+    void produce(SimulationParams params, double sampleRate); // Thread body
+    void produceBlocks(const SimulationParams& params, double sampleRate);
+
+public:
+    explicit StreamingChannel(size_t capacity = 1 << 20);
+    ~StreamingChannel();
+    StreamingChannel(const StreamingChannel&) = delete;
+    StreamingChannel& operator=(const StreamingChannel&) = delete;
+
+    // numBits, coding, codeRate, doppler and kFactor of params are not used.
+    // Samples left from a previous run are discarded; call from the consumer thread.
+    void start(const SimulationParams& params, double sampleRate);
+    void stop(); // Joins the producer; samples already in the ring can still be read
+    bool isRunning() const;
+
+    // Consumer side, from one thread only
+    size_t read(StreamSample* out, size_t count);
+    size_t discard(size_t count);
+    size_t available() const;
+    size_t readReceived(double* out, size_t count);
+    size_t discardReceived(size_t count);
+    size_t availableReceived() const;
+
+    uint64_t getProducedSamples() const; // Since the last start()
+    uint64_t getDroppedSamples() const;
+};
+
+#endif // STREAMING_CHANNEL_HPP
@@ -0,0 +1,207 @@
+#include "SweepCheckpoint.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[8] = {'A', 'W', 'G', 'N', 'C', 'K', 'P', 'T'};
+    const uint64_t FORMAT_VERSION = 1;
+
+    void putU64(std::vector<uint8_t>& out, uint64_t value) {
+        for (size_t i = 0; i < 8; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    uint64_t fnv1a(const uint8_t* data, size_t length) {
+        uint64_t h = 1469598103934665603ULL;
+        for (size_t i = 0; i < length; ++i) {
+            h = (h ^ data[i]) * 1099511628211ULL;
+        }
+        return h;
+    }
+
+    class Reader {
+    private:
+        const std::vector<uint8_t>& data_;
+        size_t position_;
+
+    public:
+        explicit Reader(const std::vector<uint8_t>& data) : data_(data), position_(0) {}
+
+        const uint8_t* bytes(size_t count) {
+            if (count > data_.size() - position_) {
+                throw std::runtime_error("Truncated sweep checkpoint");
+            }
+            const uint8_t* p = data_.data() + position_;
+            position_ += count;
+            return p;
+        }
+
+        uint64_t u64() {
+            const uint8_t* p = bytes(8);
+            uint64_t value = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                value |= static_cast<uint64_t>(p[i]) << (8 * i);
+            }
+            return value;
+        }
+
+        size_t position() const {
+            return position_;
+        }
+    };
+
+    std::runtime_error systemError(const std::string& what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    std::string directoryOf(const std::string& path) {
+        size_t slash = path.find_last_of('/');
+        if (slash == std::string::npos) return ".";
+        return slash == 0 ? "/" : path.substr(0, slash);
+    }
+}
+
+SweepCheckpoint::SweepCheckpoint(const std::string& path) : path_(path) {
+    if (path_.empty()) {
+        throw std::invalid_argument("Checkpoint path must not be empty");
+    }
+    // Left by a save() that crashed before its rename; the checkpoint itself is intact
+    ::unlink((path_ + ".tmp").c_str());
+}
+
+void SweepCheckpoint::save(const SweepCheckpointState& state) const {
+    if (state.points.empty()) {
+        throw std::invalid_argument("Checkpoint needs at least one point");
+    }
+    // Layout: magic, version, job, shard size, per-point counts, completion bitmap, FNV-1a of all of it
+    std::vector<uint8_t> data(MAGIC, MAGIC + sizeof(MAGIC));
+    putU64(data, FORMAT_VERSION);
+    putU64(data, state.job.size());
+    data.insert(data.end(), state.job.begin(), state.job.end());
+    putU64(data, state.framesPerShard);
+    putU64(data, state.points.size());
+    for (const SweepPoint& point : state.points) {
+        putU64(data, point.bits);
+        putU64(data, point.errors);
+    }
+    putU64(data, state.completed.size());
+    std::vector<uint8_t> bitmap((state.completed.size() + 7) / 8, 0);
+    for (size_t i = 0; i < state.completed.size(); ++i) {
+        if (state.completed[i]) bitmap[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+    }
+    data.insert(data.end(), bitmap.begin(), bitmap.end());
+    putU64(data, fnv1a(data.data(), data.size()));
+
+    const std::string temporary = path_ + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw systemError("Cannot create " + temporary);
+    }
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int saved = errno;
+            ::close(fd);
+            errno = saved;
+            throw systemError("Cannot write " + temporary);
+        }
+        done += static_cast<size_t>(n);
+    }
+    // The data must be on disk before the rename makes it the checkpoint
+    if (::fsync(fd) < 0) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        throw systemError("Cannot sync " + temporary);
+    }
+    ::close(fd);
+    if (::rename(temporary.c_str(), path_.c_str()) < 0) {
+        throw systemError("Cannot replace " + path_);
+    }
+    // The rename is only durable once the directory entry is on disk too
+    const std::string directory = directoryOf(path_);
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd < 0) {
+        throw systemError("Cannot open " + directory);
+    }
+    if (::fsync(dirFd) < 0) {
+        int saved = errno;
+        ::close(dirFd);
+        errno = saved;
+        throw systemError("Cannot sync " + directory);
+    }
+    ::close(dirFd);
+}
+
+bool SweepCheckpoint::load(SweepCheckpointState& state) const {
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) return false;
+        throw systemError("Cannot open " + path_);
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[65536];
+    for (;;) {
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int saved = errno;
+            ::close(fd);
+            errno = saved;
+            throw systemError("Cannot read " + path_);
+        }
+        if (n == 0) break;
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    ::close(fd);
+
+    if (data.size() < sizeof(MAGIC) + 8 || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error(path_ + " is not a sweep checkpoint");
+    }
+    Reader in(data);
+    in.bytes(sizeof(MAGIC));
+    if (in.u64() != FORMAT_VERSION) {
+        throw std::runtime_error(path_ + " has an unsupported checkpoint version");
+    }
+    uint64_t jobLength = in.u64();
+    const uint8_t* job = in.bytes(jobLength);
+    state.job.assign(job, job + jobLength);
+    state.framesPerShard = in.u64();
+    uint64_t numPoints = in.u64();
+    if (numPoints > (data.size() - in.position()) / 16) {
+        throw std::runtime_error("Truncated sweep checkpoint");
+    }
+    state.points.assign(numPoints, SweepPoint{0.0, 0, 0});
+    for (SweepPoint& point : state.points) {
+        point.bits = in.u64();
+        point.errors = in.u64();
+    }
+    uint64_t numShards = in.u64();
+    if (numShards / 8 > data.size()) {
+        throw std::runtime_error("Truncated sweep checkpoint");
+    }
+    const uint8_t* bitmap = in.bytes((numShards + 7) / 8);
+    state.completed.resize(numShards);
+    for (size_t i = 0; i < numShards; ++i) {
+        state.completed[i] = (bitmap[i >> 3] >> (i & 7)) & 1;
+    }
+    const size_t covered = in.position();
+    if (in.u64() != fnv1a(data.data(), covered) || in.position() != data.size()) {
+        throw std::runtime_error(path_ + " is corrupt (checksum mismatch)");
+    }
+    return true;
+}
+
+void SweepCheckpoint::remove() const {
+    ::unlink(path_.c_str());
+}
+
+const std::string& SweepCheckpoint::getPath() const {
+    return path_;
+}
@@ -0,0 +1,37 @@
+#ifndef SWEEP_CHECKPOINT_HPP
+#define SWEEP_CHECKPOINT_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "BerSweep.hpp"
+
+// Everything needed to continue a sharded sweep. Frame f of a point always
+// uses seed + f, so the completed shards are also the RNG stream positions:
+// redoing exactly the missing shards gives the counts of an uninterrupted run.
+struct SweepCheckpointState {
+    std::vector<uint8_t> job;       // Encoded SweepProtocol job; a resume must match it byte for byte
+    size_t framesPerShard = 0;
+    std::vector<SweepPoint> points; // Counts of the completed shards
+    std::vector<uint8_t> completed; // One flag per shard, in SweepCoordinator plan order
+};
+
+// Compact binary checkpoint file. save() writes a temporary file next to the
+// target, syncs it, renames it over the target and syncs the directory, so a
+// crash at any moment leaves either the previous or the new checkpoint, never
+// a torn one. The constructor removes a temporary file left by such a crash.
+class SweepCheckpoint {
+private:
+    std::string path_;
+
+public:
+    explicit SweepCheckpoint(const std::string& path);
+    void save(const SweepCheckpointState& state) const;
+    // False if there is no checkpoint yet; throws std::runtime_error if it is corrupt
+    bool load(SweepCheckpointState& state) const;
+    void remove() const;
+    const std::string& getPath() const;
+};
+
+#endif // SWEEP_CHECKPOINT_HPP
@@ -0,0 +1,487 @@
+#include "SweepCommand.hpp"
+#include "SweepCoordinator.hpp"
+#include "SweepWorker.hpp"
+#include "BerTheory.hpp"
+#include "CpuDispatch.hpp"
+#include "AWGN.hpp"
+#include "NoiseValidator.hpp"
+#include "ScenarioRunner.hpp"
+#include "Common.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+    const size_t NOISE_BLOCK = size_t(1) << 16; // Samples per generated block in --validate-noise
+
+    enum AnalyticMode {
+        ANALYTIC_OFF,   // Always simulate
+        ANALYTIC_ON,    // Print the closed form instead of simulating when there is one
+        ANALYTIC_CHECK  // Simulate, and compare each point with the closed form
+    };
+
+    struct SweepOptions {
+        SweepConfig config;
+        std::vector<double> snrPoints{0.0, 2.0, 4.0, 6.0, 8.0, 10.0};
+        size_t framesPerShard = 8;
+        std::string checkpointPath; // Empty: no checkpointing
+        double checkpointInterval = 60.0;
+        AnalyticMode analytic = ANALYTIC_OFF;
+        bool forceIsa = false; // Otherwise AWGN_ISA or the best the CPU supports
+        IsaLevel isa = ISA_BASELINE;
+    };
+
+    size_t parseCount(const char* text) {
+        // strtoull would wrap "-1" to a huge count
+        const char* digits = text;
+        while (std::isspace(static_cast<unsigned char>(*digits))) ++digits;
+        if (*digits == '-') {
+            throw std::invalid_argument(std::string("Expected a non-negative number, got ") + text);
+        }
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long value = std::strtoull(text, &end, 10);
+        if (end == text || *end != '\0') {
+            throw std::invalid_argument(std::string("Expected a number, got ") + text);
+        }
+        if (errno == ERANGE || value > std::numeric_limits<size_t>::max()) {
+            throw std::invalid_argument(std::string("Number out of range: ") + text);
+        }
+        return static_cast<size_t>(value);
+    }
+
+    SweepOptions parseOptions(int argc, char* argv[], int first) {
+        SweepOptions options;
+        options.config.framesPerPoint = 100;
+        for (int i = first; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            const char* value = argv[++i];
+            if (flag == "--snr") {
+                options.snrPoints = SweepCommand::parseSnrList(value);
+            } else if (flag == "--frames") {
+                options.config.framesPerPoint = parseCount(value);
+            } else if (flag == "--bits") {
+                options.config.bitsPerFrame = parseCount(value);
+            } else if (flag == "--shard") {
+                options.framesPerShard = parseCount(value);
+            } else if (flag == "--checkpoint") {
+                options.checkpointPath = value;
+            } else if (flag == "--checkpoint-interval") {
+                options.checkpointInterval = std::stod(value);
+            } else if (flag == "--seed") {
+                options.config.seed = static_cast<unsigned int>(parseCount(value));
+            } else if (flag == "--analytic") {
+                std::string a = value;
+                if (a == "off") options.analytic = ANALYTIC_OFF;
+                else if (a == "on") options.analytic = ANALYTIC_ON;
+                else if (a == "check") options.analytic = ANALYTIC_CHECK;
+                else throw std::invalid_argument("Unknown analytic mode " + a);
+            } else if (flag == "--isa") {
+                options.isa = CpuDispatch::parseIsaLevel(value);
+                options.forceIsa = true;
+            } else if (flag == "--multipath") {
+                options.config.multipath = SweepCommand::parseMultipathProfile(value);
+            } else if (flag == "--multipath-doppler") {
+                options.config.multipathDoppler = std::stod(value);
+            } else if (flag == "--equalizer") {
+                options.config.equalizerTaps = parseCount(value);
+            } else if (flag == "--eq-step") {
+                options.config.equalizerStep = std::stod(value);
+            } else if (flag == "--eq-training") {
+                options.config.trainingSymbols = parseCount(value);
+            } else if (flag == "--eq-mode") {
+                std::string e = value;
+                if (e == "lms") options.config.normalizedLms = false;
+                else if (e == "nlms") options.config.normalizedLms = true;
+                else throw std::invalid_argument("Unknown equalizer mode " + e);
+            } else if (flag == "--modulation") {
+                std::string m = value;
+                if (m == "bpsk") options.config.modulation = BPSK;
+                else if (m == "qpsk") options.config.modulation = QPSK;
+                else if (m == "qam16") options.config.modulation = QAM16;
+                else throw std::invalid_argument("Unknown modulation " + m);
+            } else if (flag == "--coding") {
+                std::string c = value;
+                if (c == "none") options.config.coding = NONE;
+                else if (c == "conv") options.config.coding = CONVOLUTIONAL;
+                else if (c == "conv7") options.config.coding = CONVOLUTIONAL_K7;
+                else if (c == "ldpc") options.config.coding = LDPC;
+                else if (c == "turbo") options.config.coding = TURBO;
+                else throw std::invalid_argument("Unknown coding " + c);
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+        return options;
+    }
+
+    int runCoordinator(const SweepOptions& options, const SweepSocket& listener) {
+        SweepCoordinator coordinator(options.config, options.snrPoints, options.framesPerShard);
+        if (!options.checkpointPath.empty()) {
+            coordinator.setCheckpoint(options.checkpointPath, options.checkpointInterval);
+        }
+        const size_t total = coordinator.getShardCount();
+        coordinator.setResultCallback([&](const SweepShardResult&) {
+            // Counts shards restored from a checkpoint too
+            std::fprintf(stderr, "\rShards merged: %zu/%zu", coordinator.getCompletedShardCount(), total);
+        });
+        std::vector<SweepPoint> points = coordinator.run(listener);
+        std::fprintf(stderr, "\n");
+        if (options.analytic != ANALYTIC_CHECK || !BerSweep::hasClosedForm(options.config)) {
+            if (options.analytic == ANALYTIC_CHECK) {
+                std::fprintf(stderr, "No closed form for this setup; nothing to check\n");
+            }
+            std::printf("%10s %14s %12s %12s\n", "SNR (dB)", "Bits", "Errors", "BER");
+            for (const SweepPoint& point : points) {
+                std::printf("%10.2f %14zu %12zu %12.4e\n", point.snrDb, point.bits, point.errors, point.getBER());
+            }
+            return 0;
+        }
+
+        // The closed form as an oracle: it should fall inside about 95% of the intervals
+        std::vector<double> theory = BerSweep::theoryBer(options.config, options.snrPoints);
+        size_t outside = 0;
+        std::printf("%10s %14s %12s %12s %12s %8s\n", "SNR (dB)", "Bits", "Errors", "BER", "Theory", "95% CI");
+        for (size_t i = 0; i < points.size(); ++i) {
+            const SweepPoint& point = points[i];
+            double low, high;
+            point.getConfidenceInterval(low, high);
+            bool inside = theory[i] >= low && theory[i] <= high;
+            outside += !inside;
+            std::printf("%10.2f %14zu %12zu %12.4e %12.4e %8s\n", point.snrDb, point.bits, point.errors,
+                        point.getBER(), theory[i], inside ? "ok" : "OUTSIDE");
+        }
+        std::fprintf(stderr, "Theory outside the 95%% interval at %zu of %zu points\n", outside, points.size());
+        return 0;
+    }
+
+    struct NoiseOptions {
+        uint64_t samples = 100000000;
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        unsigned int seed = 0;
+        size_t lags = 16;
+        double significance = 1e-3;
+    };
+
+    // Unit-noise sources under test, block b of each seeded like frame b of a run
+    NoiseValidator::Generator noiseGenerator(const std::string& name, unsigned int seed) {
+        if (name == "box-muller") {
+            return [seed](uint64_t block, double* out, size_t n, Arena&) {
+                AWGN::generateUnitNoise(seed + static_cast<unsigned int>(block), out, n);
+            };
+        }
+        if (name == "philox") {
+            return [seed](uint64_t block, double* out, size_t n, Arena&) {
+                const uint64_t pairs = NOISE_BLOCK / 2;
+                CpuDispatch::kernels().philoxNormals(seed, block * pairs, n / 2, out);
+                if (n % 2) {
+                    double last[2];
+                    CpuDispatch::kernels().philoxNormals(seed, block * pairs + n / 2, 1, last);
+                    out[n - 1] = last[0];
+                }
+            };
+        }
+        if (name == "bandlimited") {
+            // Colored on purpose: the whiteness tests should flag it
+            auto shaper = std::make_shared<NoiseShaper>(NoiseShaper::lowpass(0.1));
+            return [seed, shaper](uint64_t block, double* out, size_t n, Arena& scratch) {
+                AWGN::generateShapedNoise(shaper.get(), seed + static_cast<unsigned int>(block), out, n, scratch);
+            };
+        }
+        throw std::invalid_argument("Unknown noise generator " + name);
+    }
+
+    int runNoiseValidation(int argc, char* argv[]) {
+        NoiseOptions options;
+        for (int i = 3; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            const char* value = argv[++i];
+            if (flag == "--samples") {
+                options.samples = parseCount(value);
+            } else if (flag == "--threads") {
+                options.threads = parseCount(value);
+            } else if (flag == "--seed") {
+                options.seed = static_cast<unsigned int>(parseCount(value));
+            } else if (flag == "--lags") {
+                options.lags = parseCount(value);
+            } else if (flag == "--significance") {
+                options.significance = std::stod(value);
+            } else if (flag == "--isa") {
+                CpuDispatch::setIsaLevel(CpuDispatch::parseIsaLevel(value));
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+        if (options.samples < 2) {
+            throw std::invalid_argument("--samples must be at least 2");
+        }
+
+        std::vector<std::string> names;
+        if (std::strcmp(argv[2], "all") == 0) {
+            names = {"box-muller", "philox"};
+        } else {
+            names = {argv[2]};
+        }
+        bool allPassed = true;
+        for (const std::string& name : names) {
+            NoiseValidator::Generator generate = noiseGenerator(name, options.seed);
+            auto start = std::chrono::steady_clock::now();
+            NoiseValidator validator = NoiseValidator::validate(generate, options.samples, NOISE_BLOCK, options.threads,
+                                                                options.lags);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            NoiseValidationReport report = validator.report(options.significance);
+
+            std::printf("%s: %llu samples in %.2f s, mean %.3e, variance %.6f, skewness %.3e, excess kurtosis %.3e\n",
+                        name.c_str(), static_cast<unsigned long long>(report.count), seconds, report.mean,
+                        report.variance, report.skewness, report.excessKurtosis);
+            std::printf("%22s %12s %12s\n", "Test", "Statistic", "p-value");
+            for (const NoiseTest& test : report.tests) {
+                std::printf("%22s %12.4f %12.3e%s\n", test.name.c_str(), test.statistic, test.pValue,
+                            test.passed ? "" : "  FLAGGED");
+            }
+            std::printf("%s: %s (each test at p >= %.1e)\n\n", name.c_str(), report.passed ? "passed" : "FLAGGED",
+                        report.threshold);
+            allPassed = allPassed && report.passed;
+        }
+        return allPassed ? 0 : 1;
+    }
+
+    const char* modulationName(ModulationType modulation) {
+        switch (modulation) {
+            case BPSK: return "bpsk";
+            case QPSK: return "qpsk";
+            case QAM16: return "qam16";
+        }
+        return "?";
+    }
+
+    const char* codingName(CodingType coding) {
+        switch (coding) {
+            case NONE: return "none";
+            case CONVOLUTIONAL: return "conv";
+            case CONVOLUTIONAL_K7: return "conv7";
+            case LDPC: return "ldpc";
+            case TURBO: return "turbo";
+        }
+        return "?";
+    }
+
+    int runScenario(int argc, char* argv[]) {
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t memoryMb = 1024;
+        for (int i = 3; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + flag);
+            }
+            const char* value = argv[++i];
+            if (flag == "--threads") {
+                threads = parseCount(value);
+            } else if (flag == "--memory") {
+                memoryMb = parseCount(value);
+            } else if (flag == "--isa") {
+                CpuDispatch::setIsaLevel(CpuDispatch::parseIsaLevel(value));
+            } else {
+                throw std::invalid_argument("Unknown option " + flag);
+            }
+        }
+        ScenarioMatrix matrix = ScenarioMatrix::load(argv[2]);
+        ScenarioRunner runner(threads, memoryMb << 20);
+        std::vector<ScenarioResult> results = runner.run(matrix.getCells());
+
+        std::printf("%-16s %-10s %-6s %10s %10s %12s %12s %12s %12s\n", "Scenario", "Modulation", "Coding", "SNR (dB)",
+                    "Seed", "Bits", "Errors", "BER", "Eb/N0 (dB)");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const SimulationParams& params = matrix.getCells()[i].params;
+            const ScenarioResult& result = results[i];
+            std::printf("%-16s %-10s %-6s %10.2f %10u %12zu %12zu %12.4e %12.2f\n",
+                        matrix.getCells()[i].scenario.c_str(), modulationName(params.modulation),
+                        codingName(params.coding), params.snrDb, params.seed, result.bits, result.errors, result.ber,
+                        result.ebN0);
+        }
+        const ScenarioRunStats& stats = runner.getStats();
+        std::fprintf(stderr, "%zu cells in %.2f s: %zu stages run instead of %zu, peak %.1f MB of stage outputs\n",
+                     stats.cells, stats.seconds, stats.stagesRun, stats.stagesUnshared, stats.peakBytes / 1048576.0);
+        return 0;
+    }
+
+    int printTheory(const SweepOptions& options) {
+        std::vector<double> theory = BerSweep::theoryBer(options.config, options.snrPoints);
+        std::printf("%10s %12s %12s\n", "SNR (dB)", "Eb/N0 (dB)", "BER");
+        for (size_t i = 0; i < theory.size(); ++i) {
+            double snr = options.snrPoints[i];
+            std::printf("%10.2f %12.2f %12.4e\n", snr, BerTheory::ebN0FromSnr(snr, options.config.modulation), theory[i]);
+        }
+        return 0;
+    }
+}
+
+std::vector<double> SweepCommand::parseSnrList(const std::string& text) {
+    std::vector<double> points;
+    size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        // START:STEP:STOP, inclusive of STOP up to rounding
+        size_t second = text.find(':', colon + 1);
+        if (second == std::string::npos) {
+            throw std::invalid_argument("SNR range must be START:STEP:STOP");
+        }
+        double start = std::stod(text.substr(0, colon));
+        double step = std::stod(text.substr(colon + 1, second - colon - 1));
+        double stop = std::stod(text.substr(second + 1));
+        if (step <= 0 || stop < start) {
+            throw std::invalid_argument("SNR range needs a positive step and STOP >= START");
+        }
+        for (size_t i = 0; start + i * step <= stop + step * 1e-9; ++i) {
+            points.push_back(start + i * step);
+        }
+        return points;
+    }
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t comma = text.find(',', begin);
+        points.push_back(std::stod(text.substr(begin, comma - begin)));
+        if (comma == std::string::npos) break;
+        begin = comma + 1;
+    }
+    return points;
+}
+
+std::vector<MultipathTap> SweepCommand::parseMultipathProfile(const std::string& text) {
+    std::vector<MultipathTap> taps;
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t comma = text.find(',', begin);
+        std::string item = text.substr(begin, comma - begin);
+        size_t colon = item.find(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("Multipath taps must be DELAY:GAIN[:PHASE]");
+        }
+        size_t second = item.find(':', colon + 1);
+        size_t delay = parseCount(item.substr(0, colon).c_str());
+        double gain = std::stod(item.substr(colon + 1, second - colon - 1));
+        double phase = second == std::string::npos ? 0.0 : std::stod(item.substr(second + 1)) * Constants::PI / 180.0;
+        taps.push_back(MultipathTap{delay, gain * std::cos(phase), gain * std::sin(phase)});
+        if (comma == std::string::npos) break;
+        begin = comma + 1;
+    }
+    return taps;
+}
+
+bool SweepCommand::matches(int argc, char* argv[]) {
+    if (argc < 2) return false;
+    return std::strcmp(argv[1], "--coordinator") == 0 || std::strcmp(argv[1], "--worker") == 0 ||
+           std::strcmp(argv[1], "--sweep-local") == 0 || std::strcmp(argv[1], "--validate-noise") == 0 ||
+           std::strcmp(argv[1], "--scenario") == 0;
+}
+
+int SweepCommand::run(int argc, char* argv[]) {
+    try {
+        if (argc < 3) {
+            throw std::invalid_argument(std::string(argv[1]) + " needs an argument");
+        }
+        std::string mode = argv[1];
+        if (mode == "--validate-noise") {
+            return runNoiseValidation(argc, argv);
+        }
+        if (mode == "--scenario") {
+            return runScenario(argc, argv);
+        }
+        if (mode == "--worker") {
+            SweepWorker worker(argv[2]);
+            size_t shards = worker.run();
+            std::fprintf(stderr, "Worker processed %zu shards\n", shards);
+            return 0;
+        }
+        SweepOptions options = parseOptions(argc, argv, 3);
+        // Bind before forking, so local workers inherit the level and a bad AWGN_ISA fails here
+        if (options.forceIsa) {
+            IsaLevel bound = CpuDispatch::setIsaLevel(options.isa);
+            if (bound != options.isa) {
+                std::fprintf(stderr, "This CPU only supports %s; using that\n", CpuDispatch::isaName(bound));
+            }
+        }
+        CpuDispatch::kernels();
+        // Workers would each throw on a bad setup while the coordinator waits for them
+        BerSweep(options.config, nullptr);
+        if (options.analytic == ANALYTIC_ON) {
+            if (BerSweep::hasClosedForm(options.config)) {
+                return printTheory(options); // Nothing is simulated, so no socket or workers
+            }
+            std::fprintf(stderr, "No closed form for this setup; simulating\n");
+        }
+        if (mode == "--coordinator") {
+            SweepSocket listener = SweepSocket::listenOn(argv[2]);
+            return runCoordinator(options, listener);
+        }
+
+        // --sweep-local: listen first so no forked worker can race ahead of the socket
+        size_t numWorkers = parseCount(argv[2]);
+        if (numWorkers == 0) {
+            throw std::invalid_argument("--sweep-local needs at least one worker");
+        }
+        std::string path = "/tmp/awgn-sweep-" + std::to_string(getpid()) + ".sock";
+        std::string address = "unix:" + path;
+        SweepSocket listener = SweepSocket::listenOn(address);
+        std::vector<pid_t> children;
+        for (size_t i = 0; i < numWorkers; ++i) {
+            pid_t pid = fork();
+            if (pid < 0) {
+                throw std::runtime_error("fork failed");
+            }
+            if (pid == 0) {
+                listener.close();
+                int status = 0;
+                try {
+                    SweepWorker(address).run();
+                } catch (const std::exception& e) {
+                    std::fprintf(stderr, "Worker %zu: %s\n", i, e.what());
+                    status = 1;
+                }
+                _exit(status);
+            }
+            children.push_back(pid);
+        }
+        int status = 1;
+        try {
+            status = runCoordinator(options, listener);
+        } catch (...) {
+            for (pid_t pid : children) {
+                kill(pid, SIGTERM);
+            }
+            for (pid_t pid : children) {
+                waitpid(pid, nullptr, 0);
+            }
+            unlink(path.c_str());
+            throw;
+        }
+        listener.close(); // Workers still waiting to be accepted see the close and exit
+        for (pid_t pid : children) {
+            waitpid(pid, nullptr, 0);
+        }
+        unlink(path.c_str());
+        return status;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef SWEEP_COMMAND_HPP
+#define SWEEP_COMMAND_HPP
+
+#include <string>
+#include <vector>
+#include "MultipathChannel.hpp"
+
+// Headless modes of the simulator binary, selected before the GUI starts:
+//   --coordinator ADDRESS [options]  serve sweep shards and print the merged BER table
+//   --worker ADDRESS                 run shards for a coordinator until it is done
+//   --sweep-local N [options]        coordinator plus N forked workers on a private Unix socket
+//   --validate-noise GENERATOR [--samples N] [--threads T] [--seed S] [--lags L] [--significance A] [--isa LEVEL]
+//                                    check a unit-noise generator (box-muller, philox, bandlimited or all)
+//                                    against N(0, 1); exits 1 if any test flags it
+//   --scenario FILE [--threads T] [--memory MB] [--isa LEVEL]
+//                                    run every cell of a ScenarioMatrix file, sharing common stages,
+//                                    and print one BER row per cell
+// Options: --snr A,B,C or START:STEP:STOP (dB), --frames F, --bits B, --shard S,
+//          --seed S, --modulation bpsk|qpsk|qam16, --coding none|conv|conv7|ldpc|turbo,
+//          --checkpoint FILE (resume from FILE if present), --checkpoint-interval SECONDS,
+//          --analytic off|on|check (closed-form BER instead of, or next to, the simulation),
+//          --isa baseline|sse4.2|avx2|avx512 (kernel level; --worker reads AWGN_ISA instead),
+//          --multipath DELAY:GAIN[:PHASE],... (samples, linear amplitude, degrees),
+//          --multipath-doppler D, --equalizer TAPS, --eq-step MU, --eq-training N, --eq-mode lms|nlms
+// ADDRESS is unix:/path or tcp:host:port.
+class SweepCommand {
+public:
+    static bool matches(int argc, char* argv[]);
+    static int run(int argc, char* argv[]); // Process exit status
+    // SNR points from "A,B,C" or "START:STEP:STOP" (inclusive), as taken by --snr
+    static std::vector<double> parseSnrList(const std::string& text);
+    // Taps from "DELAY:GAIN[:PHASE],...", as taken by --multipath
+    static std::vector<MultipathTap> parseMultipathProfile(const std::string& text);
+};
+
+#endif // SWEEP_COMMAND_HPP
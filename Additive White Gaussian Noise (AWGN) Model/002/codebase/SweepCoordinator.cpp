@@ -0,0 +1,214 @@
+#include "SweepCoordinator.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <poll.h>
+
+SweepCoordinator::SweepCoordinator(const SweepConfig& config, const std::vector<double>& snrPoints, size_t framesPerShard)
+    : config_(config), snrPoints_(snrPoints), framesPerShard_(framesPerShard), remainingShards_(0),
+      checkpointInterval_(std::chrono::seconds(60)) {
+    if (snrPoints_.empty()) {
+        throw std::invalid_argument("Sweep needs at least one SNR point");
+    }
+    if (framesPerShard_ == 0) {
+        throw std::invalid_argument("Shards must hold at least one frame");
+    }
+    planShards();
+}
+
+void SweepCoordinator::planShards() {
+    points_.clear();
+    for (double snr : snrPoints_) {
+        points_.push_back(SweepPoint{snr, 0, 0});
+    }
+    // Frame range outermost: consecutive shards of one worker often share frames,
+    // so its noise cache turns the next SNR point into a rescale
+    pending_.clear();
+    for (size_t first = 0; first < config_.framesPerPoint; first += framesPerShard_) {
+        size_t count = std::min(framesPerShard_, config_.framesPerPoint - first);
+        for (size_t p = 0; p < snrPoints_.size(); ++p) {
+            pending_.push_back(SweepShard{static_cast<uint32_t>(p), first, count});
+        }
+    }
+    completed_.assign(pending_.size(), 0);
+    remainingShards_ = pending_.size();
+}
+
+size_t SweepCoordinator::shardIndex(const SweepShard& shard) const {
+    return shard.firstFrame / framesPerShard_ * snrPoints_.size() + shard.point;
+}
+
+void SweepCoordinator::resume() {
+    SweepCheckpointState state;
+    if (!checkpoint_->load(state)) {
+        return;
+    }
+    if (state.job != SweepProtocol::encodeJob(config_, snrPoints_) || state.framesPerShard != framesPerShard_ ||
+        state.points.size() != points_.size() || state.completed.size() != completed_.size()) {
+        throw std::runtime_error(checkpoint_->getPath() + " belongs to a different sweep");
+    }
+    for (size_t p = 0; p < points_.size(); ++p) {
+        points_[p].bits = state.points[p].bits;
+        points_[p].errors = state.points[p].errors;
+    }
+    completed_ = state.completed;
+    std::deque<SweepShard> missing;
+    for (const SweepShard& shard : pending_) {
+        if (!completed_[shardIndex(shard)]) {
+            missing.push_back(shard);
+        }
+    }
+    pending_.swap(missing);
+    remainingShards_ = pending_.size();
+}
+
+void SweepCoordinator::saveCheckpoint() {
+    SweepCheckpointState state;
+    state.job = SweepProtocol::encodeJob(config_, snrPoints_);
+    state.framesPerShard = framesPerShard_;
+    state.points = points_;
+    state.completed = completed_;
+    checkpoint_->save(state);
+    lastCheckpoint_ = std::chrono::steady_clock::now();
+}
+
+bool SweepCoordinator::handleMessage(Connection& worker) {
+    std::vector<uint8_t> message;
+    try {
+        if (!worker.socket.receive(message)) {
+            return false;
+        }
+        SweepShardResult result = SweepProtocol::decodeResult(message);
+        // Results come back in the order the shards were sent
+        if (worker.inFlight.empty() || worker.inFlight.front().point != result.shard.point ||
+            worker.inFlight.front().firstFrame != result.shard.firstFrame ||
+            worker.inFlight.front().numFrames != result.shard.numFrames) {
+            return false;
+        }
+        worker.inFlight.pop_front();
+        completed_[shardIndex(result.shard)] = 1;
+        points_[result.shard.point].bits += result.bits;
+        points_[result.shard.point].errors += result.errors;
+        --remainingShards_;
+        if (onResult_) {
+            onResult_(result);
+        }
+        return true;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+void SweepCoordinator::requeue(Connection& worker) {
+    while (!worker.inFlight.empty()) {
+        pending_.push_front(worker.inFlight.back());
+        worker.inFlight.pop_back();
+    }
+}
+
+void SweepCoordinator::dispatch(std::vector<Connection>& workers) {
+    for (size_t i = workers.size(); i-- > 0;) {
+        Connection& worker = workers[i];
+        try {
+            while (!pending_.empty() && worker.inFlight.size() < SHARDS_IN_FLIGHT) {
+                worker.socket.send(SweepProtocol::encodeShard(pending_.front()));
+                worker.inFlight.push_back(pending_.front());
+                pending_.pop_front();
+            }
+        } catch (const std::runtime_error&) {
+            requeue(worker);
+            workers.erase(workers.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+}
+
+std::vector<SweepPoint> SweepCoordinator::run(const SweepSocket& listener) {
+    planShards();
+    if (checkpoint_) {
+        resume();
+        lastCheckpoint_ = std::chrono::steady_clock::now();
+    }
+    const std::vector<uint8_t> job = SweepProtocol::encodeJob(config_, snrPoints_);
+    std::vector<Connection> workers;
+    std::vector<pollfd> descriptors;
+
+    while (remainingShards_ > 0) {
+        descriptors.clear();
+        descriptors.push_back(pollfd{listener.getDescriptor(), POLLIN, 0});
+        for (const Connection& worker : workers) {
+            descriptors.push_back(pollfd{worker.socket.getDescriptor(), POLLIN, 0});
+        }
+        if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Sweep poll failed: ") + std::strerror(errno));
+        }
+
+        // Workers first, while their indices still match the poll entries
+        for (size_t i = workers.size(); i-- > 0;) {
+            if (descriptors[i + 1].revents == 0) continue;
+            if (!handleMessage(workers[i])) {
+                requeue(workers[i]);
+                workers.erase(workers.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        if (descriptors[0].revents & POLLIN) {
+            Connection worker;
+            worker.socket = listener.accept();
+            try {
+                worker.socket.send(job);
+                workers.push_back(std::move(worker));
+            } catch (const std::runtime_error&) {
+                // Gone before it got the job; nothing to requeue
+            }
+        }
+        dispatch(workers);
+        if (checkpoint_ && std::chrono::steady_clock::now() - lastCheckpoint_ >= checkpointInterval_) {
+            saveCheckpoint();
+        }
+    }
+    if (checkpoint_) {
+        saveCheckpoint(); // The finished sweep, so rerunning it just prints the table
+    }
+
+    const std::vector<uint8_t> done = SweepProtocol::encodeDone();
+    for (Connection& worker : workers) {
+        try {
+            worker.socket.send(done);
+        } catch (const std::runtime_error&) {
+            // Already gone; it had no shards left
+        }
+    }
+    return points_;
+}
+
+std::vector<SweepPoint> SweepCoordinator::run(const std::string& address) {
+    SweepSocket listener = SweepSocket::listenOn(address);
+    return run(listener);
+}
+
+void SweepCoordinator::setResultCallback(std::function<void(const SweepShardResult&)> callback) {
+    onResult_ = std::move(callback);
+}
+
+void SweepCoordinator::setCheckpoint(const std::string& path, double intervalSeconds) {
+    if (intervalSeconds < 0) {
+        throw std::invalid_argument("Checkpoint interval must not be negative");
+    }
+    checkpoint_.reset(new SweepCheckpoint(path));
+    checkpointInterval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(intervalSeconds));
+}
+
+const std::vector<SweepPoint>& SweepCoordinator::getPoints() const {
+    return points_;
+}
+
+size_t SweepCoordinator::getShardCount() const {
+    return (config_.framesPerPoint + framesPerShard_ - 1) / framesPerShard_ * snrPoints_.size();
+}
+
+size_t SweepCoordinator::getCompletedShardCount() const {
+    return completed_.size() - remainingShards_;
+}
@@ -0,0 +1,70 @@
+#ifndef SWEEP_COORDINATOR_HPP
+#define SWEEP_COORDINATOR_HPP
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cstddef> // For size_t
+#include "BerSweep.hpp"
+#include "SweepProtocol.hpp"
+#include "SweepSocket.hpp"
+#include "SweepCheckpoint.hpp"
+
+// Splits a BER sweep into (SNR point, frame range) shards and serves them to
+// SweepWorker processes over a SweepSocket. Frame f always uses seed + f, so the
+// merged counts equal a single-process BerSweep::run() regardless of how many
+// workers take part or which worker runs which shard. Each worker keeps a few
+// shards queued so it never idles on a round trip; the shards of a worker that
+// disconnects go back to the queue.
+//
+// With a checkpoint set, the merged counts and the set of completed shards are
+// saved at most every checkpoint interval, and run() first loads them and only
+// hands out the missing shards, so a crashed or preempted sweep resumes where it
+// stopped with the same final counts.
+class SweepCoordinator {
+private:
+    struct Connection {
+        SweepSocket socket;
+        std::deque<SweepShard> inFlight; // Sent and not yet answered, oldest first
+    };
+
+    SweepConfig config_;
+    std::vector<double> snrPoints_;
+    size_t framesPerShard_;
+    std::vector<SweepPoint> points_;
+    std::deque<SweepShard> pending_;
+    std::vector<uint8_t> completed_; // Per shard index, see shardIndex()
+    size_t remainingShards_;
+    std::function<void(const SweepShardResult&)> onResult_;
+    std::unique_ptr<SweepCheckpoint> checkpoint_;
+    std::chrono::steady_clock::duration checkpointInterval_;
+    std::chrono::steady_clock::time_point lastCheckpoint_;
+
+    void planShards();
+    size_t shardIndex(const SweepShard& shard) const;
+    void resume();
+    void saveCheckpoint();
+    bool handleMessage(Connection& worker); // False if the worker has to be dropped
+    void requeue(Connection& worker);
+    void dispatch(std::vector<Connection>& workers);
+
+public:
+    static constexpr size_t SHARDS_IN_FLIGHT = 2; // Per worker
+
+    SweepCoordinator(const SweepConfig& config, const std::vector<double>& snrPoints, size_t framesPerShard = 8);
+    // Serves workers on `listener` until every shard has been counted, then tells them to stop
+    std::vector<SweepPoint> run(const SweepSocket& listener);
+    std::vector<SweepPoint> run(const std::string& address);
+    // Called after each shard is merged, e.g. for progress output
+    void setResultCallback(std::function<void(const SweepShardResult&)> callback);
+    // Resume from `path` if it exists and save progress there every intervalSeconds (0 = after every shard)
+    void setCheckpoint(const std::string& path, double intervalSeconds = 60.0);
+    const std::vector<SweepPoint>& getPoints() const; // Counts merged so far
+    size_t getShardCount() const;
+    size_t getCompletedShardCount() const;
+};
+
+#endif // SWEEP_COORDINATOR_HPP
@@ -0,0 +1,183 @@
+#include "SweepProtocol.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    void putU64(std::vector<uint8_t>& out, uint64_t value) {
+        for (size_t i = 0; i < 8; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void putDouble(std::vector<uint8_t>& out, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putU64(out, bits);
+    }
+
+    class Reader {
+    private:
+        const std::vector<uint8_t>& message_;
+        size_t position_;
+
+    public:
+        Reader(const std::vector<uint8_t>& message, SweepMessageType expected) : message_(message), position_(1) {
+            if (message.empty() || message[0] != expected) {
+                throw std::runtime_error("Unexpected sweep message type");
+            }
+        }
+
+        uint64_t u64() {
+            if (position_ + 8 > message_.size()) {
+                throw std::runtime_error("Truncated sweep message");
+            }
+            uint64_t value = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                value |= static_cast<uint64_t>(message_[position_ + i]) << (8 * i);
+            }
+            position_ += 8;
+            return value;
+        }
+
+        double f64() {
+            uint64_t bits = u64();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        void finish() const {
+            if (position_ != message_.size()) {
+                throw std::runtime_error("Trailing bytes in sweep message");
+            }
+        }
+    };
+
+    const size_t MAX_SNR_POINTS = 100000;
+    const size_t MAX_MULTIPATH_TAPS = 100000;
+}
+
+SweepMessageType SweepProtocol::messageType(const std::vector<uint8_t>& message) {
+    if (message.empty()) {
+        throw std::runtime_error("Empty sweep message");
+    }
+    return static_cast<SweepMessageType>(message[0]);
+}
+
+std::vector<uint8_t> SweepProtocol::encodeJob(const SweepConfig& config, const std::vector<double>& snrPoints) {
+    std::vector<uint8_t> out{SWEEP_JOB};
+    putU64(out, VERSION);
+    putU64(out, static_cast<uint64_t>(config.modulation));
+    putU64(out, static_cast<uint64_t>(config.coding));
+    putU64(out, static_cast<uint64_t>(config.codeRate));
+    putU64(out, config.bitsPerFrame);
+    putU64(out, config.framesPerPoint);
+    putU64(out, config.seed);
+    putDouble(out, config.bitRate);
+    putDouble(out, config.bandwidth);
+    putU64(out, config.bandlimitedNoise ? 1 : 0);
+    putU64(out, config.samplesPerSymbol);
+    putDouble(out, config.rolloff);
+    putU64(out, config.multipath.size());
+    for (const MultipathTap& tap : config.multipath) {
+        putU64(out, tap.delay);
+        putDouble(out, tap.gainI);
+        putDouble(out, tap.gainQ);
+    }
+    putDouble(out, config.multipathDoppler);
+    putU64(out, config.equalizerTaps);
+    putDouble(out, config.equalizerStep);
+    putU64(out, config.normalizedLms ? 1 : 0);
+    putU64(out, config.trainingSymbols);
+    putU64(out, snrPoints.size());
+    for (double snr : snrPoints) {
+        putDouble(out, snr);
+    }
+    return out;
+}
+
+void SweepProtocol::decodeJob(const std::vector<uint8_t>& message, SweepConfig& config, std::vector<double>& snrPoints) {
+    Reader in(message, SWEEP_JOB);
+    if (in.u64() != VERSION) {
+        throw std::runtime_error("Sweep coordinator and worker were built with different protocol versions");
+    }
+    config.modulation = static_cast<ModulationType>(in.u64());
+    config.coding = static_cast<CodingType>(in.u64());
+    config.codeRate = static_cast<CodeRate>(in.u64());
+    config.bitsPerFrame = in.u64();
+    config.framesPerPoint = in.u64();
+    config.seed = static_cast<unsigned int>(in.u64());
+    config.bitRate = in.f64();
+    config.bandwidth = in.f64();
+    config.bandlimitedNoise = in.u64() != 0;
+    config.samplesPerSymbol = in.u64();
+    config.rolloff = in.f64();
+    uint64_t numTaps = in.u64();
+    if (numTaps > MAX_MULTIPATH_TAPS) {
+        throw std::runtime_error("Too many multipath taps in sweep job");
+    }
+    config.multipath.resize(numTaps);
+    for (MultipathTap& tap : config.multipath) {
+        tap.delay = in.u64();
+        tap.gainI = in.f64();
+        tap.gainQ = in.f64();
+    }
+    config.multipathDoppler = in.f64();
+    config.equalizerTaps = in.u64();
+    config.equalizerStep = in.f64();
+    config.normalizedLms = in.u64() != 0;
+    config.trainingSymbols = in.u64();
+    uint64_t count = in.u64();
+    if (count > MAX_SNR_POINTS) {
+        throw std::runtime_error("Too many SNR points in sweep job");
+    }
+    snrPoints.resize(count);
+    for (double& snr : snrPoints) {
+        snr = in.f64();
+    }
+    in.finish();
+}
+
+std::vector<uint8_t> SweepProtocol::encodeShard(const SweepShard& shard) {
+    std::vector<uint8_t> out{SWEEP_SHARD};
+    putU64(out, shard.point);
+    putU64(out, shard.firstFrame);
+    putU64(out, shard.numFrames);
+    return out;
+}
+
+SweepShard SweepProtocol::decodeShard(const std::vector<uint8_t>& message) {
+    Reader in(message, SWEEP_SHARD);
+    SweepShard shard;
+    shard.point = static_cast<uint32_t>(in.u64());
+    shard.firstFrame = in.u64();
+    shard.numFrames = in.u64();
+    in.finish();
+    return shard;
+}
+
+std::vector<uint8_t> SweepProtocol::encodeResult(const SweepShardResult& result) {
+    std::vector<uint8_t> out{SWEEP_RESULT};
+    putU64(out, result.shard.point);
+    putU64(out, result.shard.firstFrame);
+    putU64(out, result.shard.numFrames);
+    putU64(out, result.bits);
+    putU64(out, result.errors);
+    return out;
+}
+
+SweepShardResult SweepProtocol::decodeResult(const std::vector<uint8_t>& message) {
+    Reader in(message, SWEEP_RESULT);
+    SweepShardResult result;
+    result.shard.point = static_cast<uint32_t>(in.u64());
+    result.shard.firstFrame = in.u64();
+    result.shard.numFrames = in.u64();
+    result.bits = in.u64();
+    result.errors = in.u64();
+    in.finish();
+    return result;
+}
+
+std::vector<uint8_t> SweepProtocol::encodeDone() {
+    return std::vector<uint8_t>{SWEEP_DONE};
+}
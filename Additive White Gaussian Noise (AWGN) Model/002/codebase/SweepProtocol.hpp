@@ -0,0 +1,44 @@
+#ifndef SWEEP_PROTOCOL_HPP
+#define SWEEP_PROTOCOL_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "BerSweep.hpp"
+
+// Coordinator -> worker: JOB once after connecting, then SHARD messages, then DONE.
+// Worker -> coordinator: one RESULT per SHARD, in the order the shards were sent.
+enum SweepMessageType : uint8_t { SWEEP_JOB = 1, SWEEP_SHARD = 2, SWEEP_RESULT = 3, SWEEP_DONE = 4 };
+
+// Frames [firstFrame, firstFrame + numFrames) of one SNR point
+struct SweepShard {
+    uint32_t point;
+    uint64_t firstFrame;
+    uint64_t numFrames;
+};
+
+struct SweepShardResult {
+    SweepShard shard;
+    uint64_t bits;
+    uint64_t errors;
+};
+
+// Message encoding. Every field is fixed-width little-endian (doubles as their
+// IEEE bit pattern), so workers on other machines of a pool read the same values.
+// Decoders throw std::runtime_error on a malformed or mismatched message.
+class SweepProtocol {
+public:
+    static constexpr uint32_t VERSION = 2; // Bumped whenever a message layout changes
+
+    static SweepMessageType messageType(const std::vector<uint8_t>& message);
+
+    static std::vector<uint8_t> encodeJob(const SweepConfig& config, const std::vector<double>& snrPoints);
+    static void decodeJob(const std::vector<uint8_t>& message, SweepConfig& config, std::vector<double>& snrPoints);
+    static std::vector<uint8_t> encodeShard(const SweepShard& shard);
+    static SweepShard decodeShard(const std::vector<uint8_t>& message);
+    static std::vector<uint8_t> encodeResult(const SweepShardResult& result);
+    static SweepShardResult decodeResult(const std::vector<uint8_t>& message);
+    static std::vector<uint8_t> encodeDone();
+};
+
+#endif // SWEEP_PROTOCOL_HPP
@@ -0,0 +1,91 @@
+#include "SweepRunner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+SweepRunner::SweepRunner()
+    : running_(false), cancel_(false), framesDone_(0), totalFrames_(0), version_(0) {}
+
+SweepRunner::~SweepRunner() {
+    stop();
+}
+
+void SweepRunner::start(const SweepConfig& config, const std::vector<double>& snrPoints) {
+    if (snrPoints.empty()) {
+        throw std::invalid_argument("Sweep needs at least one SNR point");
+    }
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        points_.clear();
+        for (double snr : snrPoints) {
+            points_.push_back(SweepPoint{snr, 0, 0});
+        }
+        framesDone_ = 0;
+        totalFrames_ = config.framesPerPoint;
+        ++version_;
+    }
+    cancel_ = false;
+    running_ = true;
+    thread_ = std::thread(&SweepRunner::run, this, config, snrPoints);
+}
+
+void SweepRunner::stop() {
+    cancel_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool SweepRunner::isRunning() const {
+    return running_;
+}
+
+void SweepRunner::run(SweepConfig config, std::vector<double> snrPoints) {
+    using Clock = std::chrono::steady_clock;
+    try {
+        BerSweep sweep(config);
+        std::vector<SweepPoint> points;
+        for (double snr : snrPoints) {
+            points.push_back(SweepPoint{snr, 0, 0});
+        }
+        // Block length adapts so each block takes about 50 ms
+        const std::chrono::duration<double> target(0.05);
+        size_t frame = 0;
+        size_t block = 1;
+        while (frame < config.framesPerPoint && !cancel_) {
+            size_t count = std::min(block, config.framesPerPoint - frame);
+            Clock::time_point begin = Clock::now();
+            sweep.runFrames(points, frame, count);
+            std::chrono::duration<double> elapsed = Clock::now() - begin;
+            frame += count;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                points_ = points;
+                framesDone_ = frame;
+                ++version_;
+            }
+            double scale = target.count() / std::max(elapsed.count(), 1e-6);
+            block = std::max<size_t>(1, static_cast<size_t>(count * std::min(scale, 2.0)));
+        }
+    } catch (const std::exception&) {
+        // Nothing can be reported from this thread; the reader sees the sweep stop early
+    }
+    running_ = false;
+}
+
+bool SweepRunner::poll(std::vector<SweepPoint>& points, size_t& framesDone, uint64_t& version) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (version_ == version) {
+        return false;
+    }
+    points = points_;
+    framesDone = framesDone_;
+    version = version_;
+    return true;
+}
+
+size_t SweepRunner::getTotalFrames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totalFrames_;
+}
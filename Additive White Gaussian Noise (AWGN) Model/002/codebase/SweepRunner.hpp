@@ -0,0 +1,45 @@
+#ifndef SWEEP_RUNNER_HPP
+#define SWEEP_RUNNER_HPP
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "BerSweep.hpp"
+
+// Runs a BerSweep on a background thread for the GUI. Frames go in blocks of
+// about 50 ms, and the accumulated points are published after each block, so
+// the reader watches the estimates converge instead of waiting for the end.
+class SweepRunner {
+private:
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> cancel_;
+    mutable std::mutex mutex_; // Guards the published state below
+    std::vector<SweepPoint> points_;
+    size_t framesDone_;
+    size_t totalFrames_;
+    uint64_t version_; // Bumped on every publish
+
+    void run(SweepConfig config, std::vector<double> snrPoints); // Thread body
+
+public:
+    SweepRunner();
+    ~SweepRunner();
+    SweepRunner(const SweepRunner&) = delete;
+    SweepRunner& operator=(const SweepRunner&) = delete;
+
+    // Runs config.framesPerPoint frames at every SNR point
+    void start(const SweepConfig& config, const std::vector<double>& snrPoints);
+    void stop(); // Cancels after the current frame and joins
+    bool isRunning() const;
+
+    // Copies the points and frame count when they were published after `version`,
+    // which is updated; returns false without copying otherwise
+    bool poll(std::vector<SweepPoint>& points, size_t& framesDone, uint64_t& version) const;
+    size_t getTotalFrames() const;
+};
+
+#endif // SWEEP_RUNNER_HPP
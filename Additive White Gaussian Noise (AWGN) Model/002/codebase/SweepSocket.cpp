@@ -0,0 +1,227 @@
+#include "SweepSocket.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    const uint32_t MAX_MESSAGE_LENGTH = 1u << 24; // Far above any sweep message; guards against garbage
+
+    std::runtime_error systemError(const std::string& what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    bool isUnixAddress(const std::string& address) {
+        return address.compare(0, 5, "unix:") == 0;
+    }
+
+    sockaddr_un unixAddress(const std::string& address) {
+        std::string path = address.substr(5);
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            throw std::invalid_argument("Unix socket path is empty or too long: " + path);
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return addr;
+    }
+
+    // "tcp:host:port"; the host may be empty for every interface
+    addrinfo* tcpAddresses(const std::string& address, bool passive) {
+        if (address.compare(0, 4, "tcp:") != 0) {
+            throw std::invalid_argument("Sweep address must start with unix: or tcp: (" + address + ")");
+        }
+        std::string rest = address.substr(4);
+        size_t colon = rest.rfind(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("TCP sweep address needs a port: " + address);
+        }
+        std::string host = rest.substr(0, colon);
+        std::string port = rest.substr(colon + 1);
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = passive ? AI_PASSIVE : 0;
+        addrinfo* result = nullptr;
+        int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+        if (status != 0) {
+            throw std::runtime_error("Cannot resolve " + address + ": " + gai_strerror(status));
+        }
+        return result;
+    }
+
+    void setNoDelay(int descriptor) {
+        // Shard and result messages are tiny; do not hold them back for coalescing
+        int one = 1;
+        setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    bool readFully(int descriptor, uint8_t* data, size_t length) {
+        size_t done = 0;
+        while (done < length) {
+            ssize_t n = ::recv(descriptor, data + done, length - done, 0);
+            if (n == 0) {
+                if (done == 0) return false;
+                throw std::runtime_error("Sweep connection closed in the middle of a message");
+            }
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw systemError("Sweep receive failed");
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+SweepSocket::SweepSocket() : descriptor_(-1) {}
+
+SweepSocket::SweepSocket(int descriptor) : descriptor_(descriptor) {}
+
+SweepSocket::~SweepSocket() {
+    close();
+}
+
+SweepSocket::SweepSocket(SweepSocket&& other) noexcept : descriptor_(other.descriptor_) {
+    other.descriptor_ = -1;
+}
+
+SweepSocket& SweepSocket::operator=(SweepSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        descriptor_ = other.descriptor_;
+        other.descriptor_ = -1;
+    }
+    return *this;
+}
+
+SweepSocket SweepSocket::listenOn(const std::string& address) {
+    if (isUnixAddress(address)) {
+        sockaddr_un addr = unixAddress(address);
+        SweepSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (!socket.isOpen()) throw systemError("Cannot create socket");
+        ::unlink(addr.sun_path); // A stale socket file from an earlier run would make bind fail
+        if (::bind(socket.descriptor_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(socket.descriptor_, SOMAXCONN) < 0) {
+            throw systemError("Cannot listen on " + address);
+        }
+        return socket;
+    }
+
+    addrinfo* addresses = tcpAddresses(address, true);
+    for (addrinfo* a = addresses; a; a = a->ai_next) {
+        SweepSocket socket(::socket(a->ai_family, a->ai_socktype, a->ai_protocol));
+        if (!socket.isOpen()) continue;
+        int one = 1;
+        setsockopt(socket.descriptor_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(socket.descriptor_, a->ai_addr, a->ai_addrlen) == 0 && ::listen(socket.descriptor_, SOMAXCONN) == 0) {
+            freeaddrinfo(addresses);
+            return socket;
+        }
+    }
+    freeaddrinfo(addresses);
+    throw systemError("Cannot listen on " + address);
+}
+
+SweepSocket SweepSocket::connectTo(const std::string& address) {
+    if (isUnixAddress(address)) {
+        sockaddr_un addr = unixAddress(address);
+        SweepSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (!socket.isOpen()) throw systemError("Cannot create socket");
+        if (::connect(socket.descriptor_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            throw systemError("Cannot connect to " + address);
+        }
+        return socket;
+    }
+
+    addrinfo* addresses = tcpAddresses(address, false);
+    for (addrinfo* a = addresses; a; a = a->ai_next) {
+        SweepSocket socket(::socket(a->ai_family, a->ai_socktype, a->ai_protocol));
+        if (!socket.isOpen()) continue;
+        if (::connect(socket.descriptor_, a->ai_addr, a->ai_addrlen) == 0) {
+            freeaddrinfo(addresses);
+            setNoDelay(socket.descriptor_);
+            return socket;
+        }
+    }
+    freeaddrinfo(addresses);
+    throw systemError("Cannot connect to " + address);
+}
+
+SweepSocket SweepSocket::accept() const {
+    int descriptor;
+    do {
+        descriptor = ::accept(descriptor_, nullptr, nullptr);
+    } while (descriptor < 0 && errno == EINTR);
+    if (descriptor < 0) {
+        throw systemError("Accepting a sweep worker failed");
+    }
+    setNoDelay(descriptor); // Fails harmlessly on Unix sockets
+    return SweepSocket(descriptor);
+}
+
+void SweepSocket::send(const std::vector<uint8_t>& message) const {
+    if (message.size() > MAX_MESSAGE_LENGTH) {
+        throw std::invalid_argument("Sweep message too long");
+    }
+    // Length prefix (little-endian) and body in one buffer, so each message is one write
+    std::vector<uint8_t> frame(4 + message.size());
+    uint32_t length = static_cast<uint32_t>(message.size());
+    for (size_t i = 0; i < 4; ++i) {
+        frame[i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+    std::copy(message.begin(), message.end(), frame.begin() + 4);
+
+    size_t done = 0;
+    while (done < frame.size()) {
+        ssize_t n = ::send(descriptor_, frame.data() + done, frame.size() - done, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("Sweep send failed");
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+bool SweepSocket::receive(std::vector<uint8_t>& message) const {
+    uint8_t header[4];
+    if (!readFully(descriptor_, header, 4)) {
+        return false;
+    }
+    uint32_t length = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        length |= static_cast<uint32_t>(header[i]) << (8 * i);
+    }
+    if (length > MAX_MESSAGE_LENGTH) {
+        throw std::runtime_error("Sweep message length out of range");
+    }
+    message.resize(length);
+    if (length > 0 && !readFully(descriptor_, message.data(), length)) {
+        throw std::runtime_error("Sweep connection closed in the middle of a message");
+    }
+    return true;
+}
+
+void SweepSocket::close() {
+    if (descriptor_ >= 0) {
+        ::close(descriptor_);
+        descriptor_ = -1;
+    }
+}
+
+bool SweepSocket::isOpen() const {
+    return descriptor_ >= 0;
+}
+
+int SweepSocket::getDescriptor() const {
+    return descriptor_;
+}
@@ -0,0 +1,36 @@
+#ifndef SWEEP_SOCKET_HPP
+#define SWEEP_SOCKET_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Stream socket carrying length-prefixed messages between a sweep coordinator
+// and its workers. Addresses are "unix:/path/to/socket" or "tcp:host:port";
+// a TCP listener on "tcp:0.0.0.0:port" serves other machines of a pool.
+class SweepSocket {
+private:
+    int descriptor_;
+    explicit SweepSocket(int descriptor);
+
+public:
+    SweepSocket();
+    ~SweepSocket();
+    SweepSocket(SweepSocket&& other) noexcept;
+    SweepSocket& operator=(SweepSocket&& other) noexcept;
+    SweepSocket(const SweepSocket&) = delete;
+    SweepSocket& operator=(const SweepSocket&) = delete;
+
+    static SweepSocket listenOn(const std::string& address);
+    static SweepSocket connectTo(const std::string& address);
+    SweepSocket accept() const;
+
+    void send(const std::vector<uint8_t>& message) const;
+    // Blocks for one whole message; returns false once the peer has closed the connection
+    bool receive(std::vector<uint8_t>& message) const;
+    void close();
+    bool isOpen() const;
+    int getDescriptor() const;
+};
+
+#endif // SWEEP_SOCKET_HPP
@@ -0,0 +1,50 @@
+#include "SweepWorker.hpp"
+#include "BerSweep.hpp"
+#include "SweepProtocol.hpp"
+#include "SweepSocket.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+SweepWorker::SweepWorker(const std::string& address, unsigned int connectTimeoutMs)
+    : address_(address), connectTimeoutMs_(connectTimeoutMs) {}
+
+size_t SweepWorker::run() {
+    SweepSocket socket;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connectTimeoutMs_);
+    while (!socket.isOpen()) {
+        try {
+            socket = SweepSocket::connectTo(address_);
+        } catch (const std::runtime_error&) {
+            if (std::chrono::steady_clock::now() >= deadline) throw;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+
+    std::vector<uint8_t> message;
+    if (!socket.receive(message)) {
+        return 0; // The coordinator had nothing left to hand out
+    }
+    SweepConfig config;
+    std::vector<double> snrPoints;
+    SweepProtocol::decodeJob(message, config, snrPoints);
+    BerSweep sweep(config);
+
+    size_t shards = 0;
+    std::vector<SweepPoint> point(1);
+    while (socket.receive(message)) {
+        if (SweepProtocol::messageType(message) == SWEEP_DONE) {
+            break;
+        }
+        SweepShard shard = SweepProtocol::decodeShard(message);
+        if (shard.point >= snrPoints.size()) {
+            throw std::runtime_error("Sweep shard refers to an unknown SNR point");
+        }
+        point[0] = SweepPoint{snrPoints[shard.point], 0, 0};
+        sweep.runFrames(point, shard.firstFrame, shard.numFrames);
+        socket.send(SweepProtocol::encodeResult(SweepShardResult{shard, point[0].bits, point[0].errors}));
+        ++shards;
+    }
+    return shards;
+}
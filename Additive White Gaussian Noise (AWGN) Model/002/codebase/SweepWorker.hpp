@@ -0,0 +1,21 @@
+#ifndef SWEEP_WORKER_HPP
+#define SWEEP_WORKER_HPP
+
+#include <string>
+#include <cstddef> // For size_t
+
+// Worker side of a sharded sweep: connects to a SweepCoordinator, builds a
+// BerSweep from the job it receives, and answers every shard with the bit and
+// error counts of its frames until the coordinator says it is done.
+class SweepWorker {
+private:
+    std::string address_;
+    unsigned int connectTimeoutMs_;
+
+public:
+    // Connecting is retried for up to connectTimeoutMs, so workers may start before the coordinator
+    explicit SweepWorker(const std::string& address, unsigned int connectTimeoutMs = 10000);
+    size_t run(); // Returns the number of shards processed
+};
+
+#endif // SWEEP_WORKER_HPP
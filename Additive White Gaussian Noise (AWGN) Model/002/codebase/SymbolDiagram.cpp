@@ -0,0 +1,179 @@
+#include "SymbolDiagram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+SymbolDiagram::SymbolDiagram(DiagramType type, size_t valuesPerSymbol, size_t samplesPerSymbol, double range,
+                             size_t columns, size_t rows)
+    : type_(type), valuesPerSymbol_(valuesPerSymbol), samplesPerSymbol_(samplesPerSymbol), range_(range),
+      columns_(columns), rows_(rows), counts_(columns * rows, 0), maxCount_(0), symbols_(0), component_(0),
+      phase_(0), traced_(false), lastI_(0.0), lastQ_(0.0) {
+    if (valuesPerSymbol_ == 0 || samplesPerSymbol_ == 0) {
+        throw std::invalid_argument("Values and samples per symbol must be greater than 0");
+    }
+    if (!(range_ > 0)) {
+        throw std::invalid_argument("Diagram range must be greater than 0");
+    }
+    if (columns_ == 0 || rows_ == 0) {
+        throw std::invalid_argument("Diagram size must be greater than 0");
+    }
+    if (type_ == DIAGRAM_EYE && columns_ % 2 != 0) {
+        throw std::invalid_argument("Eye diagrams need an even number of columns");
+    }
+    clearDirty();
+}
+
+void SymbolDiagram::markDirty(size_t columnBegin, size_t columnEnd, size_t rowBegin, size_t rowEnd) {
+    dirtyColumnBegin_ = std::min(dirtyColumnBegin_, columnBegin);
+    dirtyColumnEnd_ = std::max(dirtyColumnEnd_, columnEnd);
+    dirtyRowBegin_ = std::min(dirtyRowBegin_, rowBegin);
+    dirtyRowEnd_ = std::max(dirtyRowEnd_, rowEnd);
+}
+
+void SymbolDiagram::addPoint(double x, double y) {
+    double column = (x + range_) / (2.0 * range_) * columns_;
+    double row = (range_ - y) / (2.0 * range_) * rows_;
+    if (!(column >= 0 && column < columns_ && row >= 0 && row < rows_)) {
+        return; // Off the plot
+    }
+    size_t c = static_cast<size_t>(column);
+    size_t r = static_cast<size_t>(row);
+    uint32_t& bin = counts_[c * rows_ + r];
+    if (bin < std::numeric_limits<uint32_t>::max()) {
+        maxCount_ = std::max(maxCount_, ++bin);
+    }
+    markDirty(c, c + 1, r, r + 1);
+}
+
+void SymbolDiagram::addEyeStep(double previous, double value, size_t phase) {
+    // The step from the previous sample belongs to the trace after one symbol
+    // instant, in the right half, and to the trace before the next instant, the
+    // same columns of the left half. Each column whose centre the step spans gets
+    // the interpolated value there, so every column holds the distribution of the
+    // waveform at that offset from the instant.
+    const size_t half = columns_ / 2;
+    const double sps = static_cast<double>(samplesPerSymbol_);
+    const size_t previousPhase = (phase == 0 ? samplesPerSymbol_ : phase) - 1;
+    const double f0 = half * (1.0 + previousPhase / sps) - 0.5;
+    const double f1 = half * (1.0 + (previousPhase + 1) / sps) - 0.5;
+    size_t first = static_cast<size_t>(f0); // Positive, so truncation is floor
+    first += first < f0;
+    size_t last = static_cast<size_t>(f1);
+    last += last < f1;
+    last = std::min(last, columns_);
+    const double rowScale = rows_ / (2.0 * range_);
+    const double r0 = (range_ - previous) * rowScale;
+    const double slope = (previous - value) * rowScale / (f1 - f0);
+    uint32_t maxCount = maxCount_;
+    size_t rowBegin = rows_;
+    size_t rowEnd = 0;
+    for (size_t c = first; c < last; ++c) {
+        double row = r0 + (c - f0) * slope;
+        if (!(row >= 0 && row < rows_)) {
+            continue; // Off the plot
+        }
+        size_t r = static_cast<size_t>(row);
+        uint32_t* after = &counts_[c * rows_ + r];
+        uint32_t* before = &counts_[(c - half) * rows_ + r];
+        *after += *after < std::numeric_limits<uint32_t>::max();
+        *before += *before < std::numeric_limits<uint32_t>::max();
+        maxCount = std::max(maxCount, std::max(*after, *before));
+        rowBegin = std::min(rowBegin, r);
+        rowEnd = std::max(rowEnd, r + 1);
+    }
+    maxCount_ = maxCount;
+    if (rowBegin < rowEnd) {
+        markDirty(first - half, last, rowBegin, rowEnd);
+    }
+}
+
+void SymbolDiagram::add(const double* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const double value = values[i];
+        // Only I and Q are drawn; the 16-QAM layout repeats them in components 2 and 3
+        if (component_ == 0) {
+            if (type_ == DIAGRAM_EYE && traced_) {
+                addEyeStep(lastI_, value, phase_);
+            }
+            if (phase_ == 0) {
+                ++symbols_;
+                if (type_ == DIAGRAM_CONSTELLATION && valuesPerSymbol_ == 1) {
+                    addPoint(value, 0.0);
+                }
+            }
+            lastI_ = value;
+        } else if (component_ == 1) {
+            if (type_ == DIAGRAM_EYE && traced_) {
+                addEyeStep(lastQ_, value, phase_);
+            }
+            if (type_ == DIAGRAM_CONSTELLATION && phase_ == 0) {
+                addPoint(lastI_, value);
+            }
+            lastQ_ = value;
+        }
+        if (++component_ == valuesPerSymbol_) {
+            component_ = 0;
+            traced_ = true;
+            if (++phase_ == samplesPerSymbol_) {
+                phase_ = 0;
+            }
+        }
+    }
+}
+
+void SymbolDiagram::breakTrace() {
+    component_ = 0;
+    phase_ = 0;
+    traced_ = false;
+}
+
+void SymbolDiagram::clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    maxCount_ = 0;
+    symbols_ = 0;
+    breakTrace();
+    markDirty(0, columns_, 0, rows_);
+}
+
+DiagramType SymbolDiagram::getType() const {
+    return type_;
+}
+
+size_t SymbolDiagram::getColumns() const {
+    return columns_;
+}
+
+size_t SymbolDiagram::getRows() const {
+    return rows_;
+}
+
+double SymbolDiagram::getRange() const {
+    return range_;
+}
+
+const uint32_t* SymbolDiagram::getCounts() const {
+    return counts_.data();
+}
+
+uint32_t SymbolDiagram::getMaxCount() const {
+    return maxCount_;
+}
+
+uint64_t SymbolDiagram::getSymbolCount() const {
+    return symbols_;
+}
+
+void SymbolDiagram::getDirty(size_t& columnBegin, size_t& columnEnd, size_t& rowBegin, size_t& rowEnd) const {
+    columnBegin = dirtyColumnBegin_;
+    columnEnd = std::max(dirtyColumnBegin_, dirtyColumnEnd_);
+    rowBegin = dirtyRowBegin_;
+    rowEnd = std::max(dirtyRowBegin_, dirtyRowEnd_);
+}
+
+void SymbolDiagram::clearDirty() {
+    dirtyColumnBegin_ = columns_;
+    dirtyColumnEnd_ = 0;
+    dirtyRowBegin_ = rows_;
+    dirtyRowEnd_ = 0;
+}
@@ -0,0 +1,66 @@
+#ifndef SYMBOL_DIAGRAM_HPP
+#define SYMBOL_DIAGRAM_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef> // For size_t
+
+enum DiagramType { DIAGRAM_CONSTELLATION, DIAGRAM_EYE };
+
+// Persistent 2D histogram of received symbols (constellation) or of the traces
+// around each symbol instant (eye diagram). The input is a receive-filtered
+// waveform in the modulate() layout, as from ChannelModel::receiveWaveform:
+// valuesPerSymbol interleaved components with a symbol instant every
+// samplesPerSymbol samples. add() bins only the values it is given and widens a
+// dirty rectangle, so a redraw never rescans what was accumulated before.
+//
+// Values span [-range, range] vertically, and horizontally for the constellation;
+// the eye spans one symbol period either side of the instant. Row 0 is the top.
+class SymbolDiagram {
+private:
+    DiagramType type_;
+    size_t valuesPerSymbol_;
+    size_t samplesPerSymbol_;
+    double range_;
+    size_t columns_;
+    size_t rows_;
+    std::vector<uint32_t> counts_; // Column-major
+    uint32_t maxCount_;
+    uint64_t symbols_;  // Symbol instants binned
+    size_t component_;  // Position of the next value within its sample
+    size_t phase_;      // Sample of the next value within its symbol period, 0 at the instant
+    bool traced_;       // A previous sample exists to draw the eye step from
+    double lastI_;      // Previous sample of the I and Q components
+    double lastQ_;
+    size_t dirtyColumnBegin_;
+    size_t dirtyColumnEnd_;
+    size_t dirtyRowBegin_;
+    size_t dirtyRowEnd_;
+
+    void markDirty(size_t columnBegin, size_t columnEnd, size_t rowBegin, size_t rowEnd);
+    void addPoint(double x, double y);
+    void addEyeStep(double previous, double value, size_t phase); // Ends at sample phase `phase`
+
+public:
+    SymbolDiagram(DiagramType type, size_t valuesPerSymbol, size_t samplesPerSymbol, double range,
+                  size_t columns = 256, size_t rows = 256);
+
+    // Continues from the previous call; count need not be whole symbols
+    void add(const double* values, size_t count);
+    // The next value starts a new symbol instant, not joined to the values before it
+    void breakTrace();
+    void clear();
+
+    DiagramType getType() const;
+    size_t getColumns() const;
+    size_t getRows() const;
+    double getRange() const;
+    const uint32_t* getCounts() const; // Bin (column, row) at column * getRows() + row
+    uint32_t getMaxCount() const;
+    uint64_t getSymbolCount() const;
+    // Bins changed since the last clearDirty(), as half-open ranges; empty when none changed
+    void getDirty(size_t& columnBegin, size_t& columnEnd, size_t& rowBegin, size_t& rowEnd) const;
+    void clearDirty();
+};
+
+#endif // SYMBOL_DIAGRAM_HPP
@@ -0,0 +1,299 @@
+#include "TurboCode.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    const float UNREACHABLE = -1e9f; // Metric of a state the trellis cannot be in
+
+    // Trellis of the (13, 15) RSC code. State bits are (s1 s2 s3), newest first;
+    // the register input is a = u ^ s2 ^ s3 and the parity a ^ s1 ^ s3.
+    struct Trellis {
+        unsigned next[8][2];
+        unsigned parity[8][2];
+        unsigned previous[8][2];      // The two states leading into each state
+        unsigned previousInput[8][2];
+        unsigned tailInput[8];        // Input that feeds a = 0 and drives the state towards 0
+
+        Trellis() {
+            unsigned count[8] = {0};
+            for (unsigned s = 0; s < 8; ++s) {
+                unsigned s1 = (s >> 2) & 1, s2 = (s >> 1) & 1, s3 = s & 1;
+                for (unsigned u = 0; u < 2; ++u) {
+                    unsigned a = u ^ s2 ^ s3;
+                    unsigned n = (a << 2) | (s1 << 1) | s2;
+                    next[s][u] = n;
+                    parity[s][u] = a ^ s1 ^ s3;
+                    previous[n][count[n]] = s;
+                    previousInput[n][count[n]] = u;
+                    ++count[n];
+                }
+                tailInput[s] = s2 ^ s3;
+            }
+        }
+    };
+
+    const Trellis& trellis() {
+        static const Trellis t;
+        return t;
+    }
+
+    // LTE CRC-24A, D^24 + D^23 + D^18 + D^17 + D^14 + D^11 + D^10 + D^7 + D^6 + D^5 + D^4 + D^3 + D + 1
+    uint32_t crc24(const int* bits, size_t numBits) {
+        uint32_t crc = 0;
+        for (size_t i = 0; i < numBits; ++i) {
+            uint32_t top = ((crc >> 23) ^ static_cast<uint32_t>(bits[i])) & 1;
+            crc = (crc << 1) & 0xFFFFFF;
+            if (top) crc ^= 0x864CFB;
+        }
+        return crc;
+    }
+}
+
+TurboCode::TurboCode(const Interleaver& interleaver, size_t maxIterations, size_t windowLength)
+    : interleaver_(interleaver), blockLength_(interleaver.getLength()), maxIterations_(maxIterations),
+      windowLength_(windowLength), numWindows_(0) {
+    if (blockLength_ <= CRC_LENGTH) {
+        throw std::invalid_argument("Turbo block must be longer than its CRC");
+    }
+    if (maxIterations == 0 || windowLength == 0) {
+        throw std::invalid_argument("Iteration count and window length must be greater than 0");
+    }
+    numWindows_ = (blockLength_ + windowLength_ - 1) / windowLength_;
+}
+
+TurboCode TurboCode::lte(size_t blockLength, size_t maxIterations, size_t windowLength) {
+    return TurboCode(Interleaver::lte(blockLength), maxIterations, windowLength);
+}
+
+void TurboCode::encodeConstituent(const int* bits, int* parity, int* tail) const {
+    const Trellis& t = trellis();
+    unsigned state = 0;
+    for (size_t i = 0; i < blockLength_; ++i) {
+        unsigned u = static_cast<unsigned>(bits[i] & 1);
+        parity[i] = static_cast<int>(t.parity[state][u]);
+        state = t.next[state][u];
+    }
+    for (size_t j = 0; j < 3; ++j) {
+        unsigned u = t.tailInput[state];
+        tail[2 * j] = static_cast<int>(u);
+        tail[2 * j + 1] = static_cast<int>(t.parity[state][u]);
+        state = t.next[state][u];
+    }
+}
+
+size_t TurboCode::encode(const int* bits, size_t numBits, int* encoded, Arena& scratch) const {
+    const size_t K = blockLength_;
+    const size_t k = getInfoLength();
+    const size_t n = getBlockLength();
+    const size_t blocks = (numBits + k - 1) / k;
+    int* block = scratch.allocate<int>(K);
+    int* permuted = scratch.allocate<int>(K);
+    for (size_t b = 0; b < blocks; ++b) {
+        // Payload, zero-padded in the last block, then its CRC most significant bit first
+        size_t count = std::min(k, numBits - b * k);
+        std::copy(bits + b * k, bits + b * k + count, block);
+        std::fill(block + count, block + k, 0);
+        uint32_t crc = crc24(block, k);
+        for (size_t j = 0; j < CRC_LENGTH; ++j) {
+            block[k + j] = static_cast<int>((crc >> (CRC_LENGTH - 1 - j)) & 1);
+        }
+
+        int* out = encoded + b * n;
+        std::copy(block, block + K, out);
+        encodeConstituent(block, out + K, out + 3 * K);
+        interleaver_.interleave(block, permuted);
+        encodeConstituent(permuted, out + 2 * K, out + 3 * K + TAIL_LENGTH / 2);
+    }
+    return blocks * n;
+}
+
+void TurboCode::constituentPass(const float* systematic, const float* parity, const float* apriori, const float* tail,
+                                float* extrinsic, float* edges, const DecoderBuffers& buffers) const {
+    const Trellis& trellisTables = trellis();
+    const size_t K = blockLength_;
+    const size_t P = numWindows_;
+    float* alphaEdges = edges;
+    float* betaEdges = edges + (P + 1) * NUM_STATES;
+    float* nextAlpha = buffers.nextEdges;
+    float* nextBeta = buffers.nextEdges + (P + 1) * NUM_STATES;
+
+    // The terminated end: backward through the three tail steps from state 0
+    float beta[NUM_STATES];
+    float newBeta[NUM_STATES];
+    std::fill(beta, beta + NUM_STATES, UNREACHABLE);
+    beta[0] = 0.0f;
+    for (size_t j = 3; j-- > 0;) {
+        const float x = 0.5f * tail[2 * j];
+        const float z = 0.5f * tail[2 * j + 1];
+        for (unsigned s = 0; s < NUM_STATES; ++s) {
+            unsigned u = trellisTables.tailInput[s];
+            newBeta[s] = (u ? x : -x) + (trellisTables.parity[s][u] ? z : -z) + beta[trellisTables.next[s][u]];
+        }
+        std::copy(newBeta, newBeta + NUM_STATES, beta);
+    }
+    std::copy(beta, beta + NUM_STATES, betaEdges + P * NUM_STATES);
+    std::copy(alphaEdges, alphaEdges + NUM_STATES, nextAlpha);
+    std::copy(beta, beta + NUM_STATES, nextBeta + P * NUM_STATES);
+
+    // Windows only read last iteration's boundaries and write the next set, so their order is free
+    for (size_t w = 0; w < P; ++w) {
+        const size_t begin = w * windowLength_;
+        const size_t length = std::min(windowLength_, K - begin);
+        float* alpha = buffers.alpha;
+        std::copy(alphaEdges + w * NUM_STATES, alphaEdges + (w + 1) * NUM_STATES, alpha);
+
+        // Forward recursion; branch metrics are +-A for the input and +-B for the parity
+        for (size_t t = 0; t < length; ++t) {
+            const size_t i = begin + t;
+            const float A = 0.5f * (systematic[i] + apriori[i]);
+            const float B = 0.5f * parity[i];
+            const float* a = alpha + t * NUM_STATES;
+            float* an = alpha + (t + 1) * NUM_STATES;
+            for (unsigned s = 0; s < NUM_STATES; ++s) {
+                float m[2];
+                for (unsigned j = 0; j < 2; ++j) {
+                    unsigned p = trellisTables.previous[s][j];
+                    unsigned u = trellisTables.previousInput[s][j];
+                    m[j] = a[p] + (u ? A : -A) + (trellisTables.parity[p][u] ? B : -B);
+                }
+                an[s] = std::max(m[0], m[1]);
+            }
+            const float reference = an[0];
+            for (unsigned s = 0; s < NUM_STATES; ++s) {
+                an[s] -= reference;
+            }
+        }
+        std::copy(alpha + length * NUM_STATES, alpha + (length + 1) * NUM_STATES, nextAlpha + (w + 1) * NUM_STATES);
+
+        // Backward recursion with the extrinsic output; the +-A term is common to
+        // every branch of one input value, so it drops out of the extrinsic
+        std::copy(betaEdges + (w + 1) * NUM_STATES, betaEdges + (w + 2) * NUM_STATES, beta);
+        for (size_t t = length; t-- > 0;) {
+            const size_t i = begin + t;
+            const float A = 0.5f * (systematic[i] + apriori[i]);
+            const float B = 0.5f * parity[i];
+            const float* a = alpha + t * NUM_STATES;
+            float best[2] = {UNREACHABLE * 4, UNREACHABLE * 4};
+            for (unsigned s = 0; s < NUM_STATES; ++s) {
+                float m[2];
+                for (unsigned u = 0; u < 2; ++u) {
+                    float b = (trellisTables.parity[s][u] ? B : -B) + beta[trellisTables.next[s][u]];
+                    best[u] = std::max(best[u], a[s] + b);
+                    m[u] = b + (u ? A : -A);
+                }
+                newBeta[s] = std::max(m[0], m[1]);
+            }
+            extrinsic[i] = best[1] - best[0];
+            const float reference = newBeta[0];
+            for (unsigned s = 0; s < NUM_STATES; ++s) {
+                beta[s] = newBeta[s] - reference;
+            }
+        }
+        std::copy(beta, beta + NUM_STATES, nextBeta + w * NUM_STATES);
+    }
+    std::copy(buffers.nextEdges, buffers.nextEdges + 2 * (P + 1) * NUM_STATES, edges);
+}
+
+size_t TurboCode::decodeBlock(const double* llrs, int* bits, const DecoderBuffers& buffers) const {
+    const size_t K = blockLength_;
+    const size_t P = numWindows_;
+    const uint32_t* pi = interleaver_.getPermutation().data();
+    float* received = buffers.received;
+    for (size_t i = 0; i < getBlockLength(); ++i) {
+        received[i] = static_cast<float>(llrs[i]);
+    }
+    const float* systematic = received;
+    const float* tail = received + 3 * K;
+    interleaver_.interleave(systematic, buffers.interleaved);
+
+    // Window boundaries start uniform, except the known starting state
+    for (float* edges : buffers.edges) {
+        std::fill(edges, edges + 2 * (P + 1) * NUM_STATES, 0.0f);
+        std::fill(edges + 1, edges + NUM_STATES, UNREACHABLE);
+    }
+    std::fill(buffers.apriori[0], buffers.apriori[0] + K, 0.0f);
+
+    size_t iteration = 0;
+    while (iteration < maxIterations_) {
+        float* extrinsic = buffers.extrinsic;
+        constituentPass(systematic, received + K, buffers.apriori[0], tail, extrinsic, buffers.edges[0], buffers);
+        for (size_t i = 0; i < K; ++i) {
+            buffers.apriori[1][i] = EXTRINSIC_SCALE * extrinsic[pi[i]];
+        }
+        constituentPass(buffers.interleaved, received + 2 * K, buffers.apriori[1], tail + TAIL_LENGTH / 2,
+                        extrinsic, buffers.edges[1], buffers);
+        for (size_t i = 0; i < K; ++i) {
+            float app = buffers.interleaved[i] + buffers.apriori[1][i] + extrinsic[i];
+            buffers.decisions[pi[i]] = app > 0.0f ? 1 : 0;
+            buffers.apriori[0][pi[i]] = EXTRINSIC_SCALE * extrinsic[i];
+        }
+        ++iteration;
+        if (crc24(buffers.decisions, K) == 0) {
+            break;
+        }
+    }
+    std::copy(buffers.decisions, buffers.decisions + getInfoLength(), bits);
+    return iteration;
+}
+
+TurboCode::DecoderBuffers TurboCode::allocateBuffers(Arena& scratch) const {
+    const size_t K = blockLength_;
+    const size_t edgeLength = 2 * (numWindows_ + 1) * NUM_STATES;
+    DecoderBuffers buffers;
+    buffers.received = scratch.allocate<float>(getBlockLength());
+    buffers.interleaved = scratch.allocate<float>(K);
+    buffers.apriori[0] = scratch.allocate<float>(K);
+    buffers.apriori[1] = scratch.allocate<float>(K);
+    buffers.extrinsic = scratch.allocate<float>(K);
+    buffers.alpha = scratch.allocate<float>((windowLength_ + 1) * NUM_STATES);
+    buffers.edges[0] = scratch.allocate<float>(edgeLength);
+    buffers.edges[1] = scratch.allocate<float>(edgeLength);
+    buffers.nextEdges = scratch.allocate<float>(edgeLength);
+    buffers.decisions = scratch.allocate<int>(K);
+    return buffers;
+}
+
+size_t TurboCode::decodeBlock(const double* llrs, int* bits, Arena& scratch) const {
+    return decodeBlock(llrs, bits, allocateBuffers(scratch));
+}
+
+size_t TurboCode::decode(const double* llrs, size_t numLlrs, int* bits, Arena& scratch) const {
+    const size_t blocks = numLlrs / getBlockLength();
+    const DecoderBuffers buffers = allocateBuffers(scratch);
+    for (size_t b = 0; b < blocks; ++b) {
+        decodeBlock(llrs + b * getBlockLength(), bits + b * getInfoLength(), buffers);
+    }
+    return blocks * getInfoLength();
+}
+
+size_t TurboCode::encodedLength(size_t numBits) const {
+    return (numBits + getInfoLength() - 1) / getInfoLength() * getBlockLength();
+}
+
+size_t TurboCode::decodedLength(size_t numLlrs) const {
+    return numLlrs / getBlockLength() * getInfoLength();
+}
+
+double TurboCode::getRate() const {
+    return 1.0 / 3.0;
+}
+
+size_t TurboCode::getInfoLength() const {
+    return blockLength_ - CRC_LENGTH;
+}
+
+size_t TurboCode::getBlockLength() const {
+    return 3 * blockLength_ + TAIL_LENGTH;
+}
+
+size_t TurboCode::getMaxIterations() const {
+    return maxIterations_;
+}
+
+size_t TurboCode::getWindowLength() const {
+    return windowLength_;
+}
+
+const Interleaver& TurboCode::getInterleaver() const {
+    return interleaver_;
+}
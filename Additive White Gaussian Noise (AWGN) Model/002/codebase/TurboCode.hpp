@@ -0,0 +1,72 @@
+#ifndef TURBO_CODE_HPP
+#define TURBO_CODE_HPP
+
+#include <cstdint>
+#include <cstddef> // For size_t
+#include "ChannelCodec.hpp"
+#include "Interleaver.hpp"
+
+// Rate 1/3 parallel concatenation of two 8-state recursive systematic (13, 15)
+// encoders, as in LTE. Every block holds getInfoLength() information bits and
+// a CRC-24, so the block length K equals the interleaver length. It is sent as
+// systematic | parity 1 | parity 2, followed by 12 tail bits: each encoder is
+// terminated on its own with 3 (systematic, parity) steps.
+//
+// Decoding is iterative max-log-MAP. Each constituent pass cuts the trellis
+// into windows. A window starts its forward and backward recursions from the
+// boundary metrics its neighbours produced in the previous iteration. So no
+// window waits for another within an iteration, and they could run on separate
+// threads. Iterations stop early once the CRC of the hard decisions checks.
+class TurboCode : public ChannelCodec {
+private:
+    static constexpr size_t NUM_STATES = 8;
+
+    Interleaver interleaver_;
+    size_t blockLength_;
+    size_t maxIterations_;
+    size_t windowLength_;
+    size_t numWindows_;
+
+    struct DecoderBuffers {
+        float* received;    // Channel values of the block
+        float* interleaved; // Systematic values in interleaver order
+        float* apriori[2];  // Per decoder, in that decoder's bit order
+        float* extrinsic;
+        float* alpha;       // Forward metrics of one window, NUM_STATES per step
+        float* edges[2];    // Per decoder: alpha, then beta, at the window boundaries
+        float* nextEdges;
+        int* decisions;
+    };
+
+    DecoderBuffers allocateBuffers(Arena& scratch) const;
+    void encodeConstituent(const int* bits, int* parity, int* tail) const;
+    // One max-log-MAP pass of a constituent decoder; writes extrinsic values
+    void constituentPass(const float* systematic, const float* parity, const float* apriori, const float* tail,
+                         float* extrinsic, float* edges, const DecoderBuffers& buffers) const;
+    size_t decodeBlock(const double* llrs, int* bits, const DecoderBuffers& buffers) const; // Returns iterations run
+
+public:
+    static constexpr size_t CRC_LENGTH = 24;
+    static constexpr size_t TAIL_LENGTH = 12;
+    static constexpr float EXTRINSIC_SCALE = 0.75f; // Offsets the max-log optimism
+
+    explicit TurboCode(const Interleaver& interleaver, size_t maxIterations = 8, size_t windowLength = 64);
+    // LTE QPP interleaver of the given length
+    static TurboCode lte(size_t blockLength = 1024, size_t maxIterations = 8, size_t windowLength = 64);
+
+    size_t encode(const int* bits, size_t numBits, int* encoded, Arena& scratch) const override;
+    size_t decode(const double* llrs, size_t numLlrs, int* bits, Arena& scratch) const override;
+    size_t encodedLength(size_t numBits) const override;
+    size_t decodedLength(size_t numLlrs) const override;
+    double getRate() const override;
+    // Decodes one coded block; returns the iterations used (maxIterations if the CRC never checked)
+    size_t decodeBlock(const double* llrs, int* bits, Arena& scratch) const;
+
+    size_t getInfoLength() const;  // Information bits per block, excluding the CRC
+    size_t getBlockLength() const; // Coded bits per block
+    size_t getMaxIterations() const;
+    size_t getWindowLength() const;
+    const Interleaver& getInterleaver() const;
+};
+
+#endif // TURBO_CODE_HPP
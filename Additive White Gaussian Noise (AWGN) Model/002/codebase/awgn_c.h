@@ -0,0 +1,112 @@
+#ifndef AWGN_C_H
+#define AWGN_C_H
+
+/*
+ * C interface of the AWGN core library (libawgn).
+ *
+ * Callers own every buffer. Sample buffers are passed as pointer, count and
+ * stride (in elements, at least 1), so one channel of an interleaved recording
+ * can be processed in place. Stride-1 buffers are read and written directly.
+ * Other strides go through the handle's scratch memory for modulation and
+ * demodulation; noise addition and the analysis functions never copy.
+ *
+ * Functions return AWGN_OK or a negative awgn_status; awgn_last_error()
+ * describes the most recent failure on the calling thread. A channel handle
+ * may be used by one thread at a time; separate handles are independent.
+ */
+
+#include <stddef.h>
+
+/* The library's own sources define AWGN_BUILDING; consumers get imports */
+#if defined(_WIN32) && defined(AWGN_BUILDING)
+#  define AWGN_API __declspec(dllexport)
+#elif defined(_WIN32)
+#  define AWGN_API __declspec(dllimport)
+#elif defined(__GNUC__)
+#  define AWGN_API __attribute__((visibility("default")))
+#else
+#  define AWGN_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AWGN_API_VERSION 1 /* Bumped on incompatible changes */
+
+typedef enum awgn_status {
+    AWGN_OK = 0,
+    AWGN_ERROR_INVALID_ARGUMENT = -1,
+    AWGN_ERROR_BUFFER_TOO_SMALL = -2,
+    AWGN_ERROR_OUT_OF_MEMORY = -3,
+    AWGN_ERROR_INTERNAL = -4
+} awgn_status;
+
+typedef enum awgn_modulation {
+    AWGN_MODULATION_BPSK = 0,
+    AWGN_MODULATION_QPSK = 1,
+    AWGN_MODULATION_QAM16 = 2
+} awgn_modulation;
+
+typedef enum awgn_coding {
+    AWGN_CODING_NONE = 0,
+    AWGN_CODING_CONVOLUTIONAL = 1,    /* K=3 (7,5) */
+    AWGN_CODING_CONVOLUTIONAL_K7 = 2, /* K=7 (171,133) */
+    AWGN_CODING_LDPC = 3,             /* 802.11n rate 1/2, n=648 */
+    AWGN_CODING_TURBO = 4             /* LTE rate 1/3, K=1024 */
+} awgn_coding;
+
+/* Fill with awgn_channel_config_init() first, then override fields. `size`
+ * lets later library versions append fields without breaking older callers:
+ * any size down to the version 1 layout below is accepted, and fields past
+ * the caller's size take their awgn_channel_config_init() defaults. */
+typedef struct awgn_channel_config {
+    size_t size;
+    awgn_modulation modulation;
+    awgn_coding coding;
+    double snr_db;
+    double bit_rate;
+    double bandwidth;
+    unsigned int seed;
+    int bandlimited_noise; /* Nonzero: lowpass the noise to `bandwidth` */
+} awgn_channel_config;
+
+typedef struct awgn_channel awgn_channel;
+
+AWGN_API int awgn_api_version(void);
+AWGN_API const char* awgn_last_error(void);
+
+AWGN_API void awgn_channel_config_init(awgn_channel_config* config);
+AWGN_API awgn_status awgn_channel_create(const awgn_channel_config* config, awgn_channel** channel);
+AWGN_API void awgn_channel_destroy(awgn_channel* channel);
+AWGN_API awgn_status awgn_channel_set_snr_db(awgn_channel* channel, double snr_db);
+AWGN_API awgn_status awgn_channel_set_seed(awgn_channel* channel, unsigned int seed);
+
+/* out[i * out_stride] = in[i * in_stride] + noise; `out` may alias `in` */
+AWGN_API awgn_status awgn_add_noise(awgn_channel* channel, const double* in, size_t in_stride,
+                                    double* out, size_t out_stride, size_t count);
+
+/* Bits are 0/1 ints. The *_length queries give the capacity a call needs. */
+AWGN_API size_t awgn_modulated_length(const awgn_channel* channel, size_t num_bits);
+AWGN_API awgn_status awgn_modulate(awgn_channel* channel, const int* bits, size_t bits_stride, size_t num_bits,
+                                   double* samples, size_t samples_stride, size_t capacity, size_t* written);
+AWGN_API size_t awgn_demodulated_length(const awgn_channel* channel, size_t num_samples);
+AWGN_API awgn_status awgn_demodulate(awgn_channel* channel, const double* samples, size_t samples_stride,
+                                     size_t num_samples, int* bits, size_t bits_stride, size_t capacity,
+                                     size_t* written);
+
+/* Analysis; these need no channel */
+AWGN_API awgn_status awgn_ebn0_db(const double* signal, size_t stride, size_t count, double snr_db,
+                                  double bit_rate, double bandwidth, double* ebn0_db);
+AWGN_API awgn_status awgn_measure_snr_db(const double* original, size_t original_stride, const double* noisy,
+                                         size_t noisy_stride, size_t count, double* snr_db);
+/* Stores up to `capacity` crossing indices; `found` gets the total, which may be larger */
+AWGN_API awgn_status awgn_zero_crossings(const double* signal, size_t stride, size_t count, size_t* points,
+                                         size_t capacity, size_t* found);
+AWGN_API awgn_status awgn_sine_wave(double* out, size_t stride, size_t count, double amplitude, double frequency);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWGN_C_H */
@@ -5,7 +5,15 @@
 #include "PlotWidget.hpp"
 #include "SignalToNoiseRatio.hpp"
 #include "ChannelModel.hpp"
-#include <random>
+#include "SimulationGraph.hpp"
+#include "SweepCommand.hpp"
+#include "StreamingChannel.hpp"
+#include "SweepRunner.hpp"
+#include "BerTheory.hpp"
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 struct AppWidgets {
     GtkWidget *window;
@@ -17,15 +25,50 @@ struct AppWidgets {
     GtkWidget *bandwidth_entry;
     GtkWidget *modulation_dropdown;
     GtkWidget *coding_dropdown;
+    GtkWidget *rate_dropdown;
+    GtkWidget *noise_dropdown;
     GtkWidget *seed_entry;
+    GtkWidget *sps_entry;
+    GtkWidget *rolloff_entry;
+    GtkWidget *doppler_entry;
+    GtkWidget *kfactor_entry;
+    GtkWidget *cfo_entry;
+    GtkWidget *phase_noise_entry;
+    GtkWidget *iq_gain_entry;
+    GtkWidget *iq_phase_entry;
+    GtkWidget *dc_offset_entry;
+    GtkWidget *stream_rate_entry;
+    GtkWidget *sweep_snr_entry;
+    GtkWidget *sweep_frames_entry;
     GtkWidget *generate_button;
     GtkWidget *reset_button;
+    GtkWidget *stream_button;
+    GtkWidget *sweep_button;
     GtkWidget *notebook;
     GtkWidget *signal_plot;
     GtkWidget *time_plot;
     GtkWidget *time_label;
     GtkWidget *phasor_plot;
     GtkWidget *phasor_label;
+    GtkWidget *constellation_plot;
+    GtkWidget *eye_plot;
+    GtkWidget *ber_plot;
+    GtkWidget *ber_label;
+    SimulationGraph graph; // Keeps each pipeline stage so Generate only redoes what changed
+    StreamingChannel stream;
+    guint stream_tick = 0; // Frame-clock callback feeding the scope plots, 0 when not streaming
+    guint stream_frames = 0;
+    double stream_rate = 0.0;
+    std::vector<StreamSample> stream_buffer;
+    // The diagrams accumulate over every run with the same setup
+    bool diagram_valid = false;
+    SimulationParams diagram_params; // Setup the diagrams were begun with
+    size_t diagram_group = 1;        // Values per symbol period
+    std::vector<double> diagram_buffer;
+    SweepRunner sweep;
+    guint sweep_timer = 0; // Polls the sweep for new counts, 0 when no sweep is running
+    uint64_t sweep_version = 0;
+    std::vector<SweepPoint> sweep_points;
 };
 
 static void show_error_dialog(GtkWidget *window, const char *message) {
@@ -37,8 +80,14 @@ static void show_error_dialog(GtkWidget *window, const char *message) {
     g_object_unref(dialog);
 }
 
+static void stop_stream(AppWidgets *widgets);
+static void stop_sweep(AppWidgets *widgets);
+
 static void reset_inputs(GtkButton *button, gpointer user_data) {
     AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    stop_stream(widgets);
+    stop_sweep(widgets);
+    widgets->graph.invalidate(); // Cleared plots must be redrawn by the next Generate
     gtk_editable_set_text(GTK_EDITABLE(widgets->amplitude_entry), "1.0");
     gtk_editable_set_text(GTK_EDITABLE(widgets->frequency_entry), "0.05");
     gtk_editable_set_text(GTK_EDITABLE(widgets->samples_entry), "1000");
@@ -47,7 +96,22 @@ static void reset_inputs(GtkButton *button, gpointer user_data) {
     gtk_editable_set_text(GTK_EDITABLE(widgets->bandwidth_entry), "0.1");
     gtk_drop_down_set_selected(GTK_DROP_DOWN(widgets->modulation_dropdown), 0);
     gtk_drop_down_set_selected(GTK_DROP_DOWN(widgets->coding_dropdown), 0);
+    gtk_drop_down_set_selected(GTK_DROP_DOWN(widgets->rate_dropdown), 0);
+    gtk_drop_down_set_selected(GTK_DROP_DOWN(widgets->noise_dropdown), 0);
     gtk_editable_set_text(GTK_EDITABLE(widgets->seed_entry), "0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->sps_entry), "1");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->rolloff_entry), "0.35");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->doppler_entry), "0.0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->kfactor_entry), "0.0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->cfo_entry), "0.0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->phase_noise_entry), "0.0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->iq_gain_entry), "0.0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->iq_phase_entry), "0.0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->dc_offset_entry), "0.0");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->stream_rate_entry), "1000000");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->sweep_snr_entry), "0:1:10");
+    gtk_editable_set_text(GTK_EDITABLE(widgets->sweep_frames_entry), "200");
+    gtk_label_set_text(GTK_LABEL(widgets->ber_label), "Sweep: N/A");
     gtk_label_set_text(GTK_LABEL(widgets->time_label), "Bit Error Rate: N/A");
     gtk_label_set_text(GTK_LABEL(widgets->phasor_label), "Phasor Statistics: N/A");
     PlotWidget *signal_plot = PLOT_WIDGET(widgets->signal_plot);
@@ -56,14 +120,20 @@ static void reset_inputs(GtkButton *button, gpointer user_data) {
     plot_widget_set_data(signal_plot, std::vector<double>(), std::vector<double>(), PLOT_TYPE_SIGNAL, 0);
     plot_widget_set_data(time_plot, std::vector<double>(), std::vector<double>(), PLOT_TYPE_TIME, 0);
     plot_widget_set_data(phasor_plot, std::vector<double>(), std::vector<double>(), PLOT_TYPE_PHASOR, 0);
+    plot_widget_end_diagram(PLOT_WIDGET(widgets->constellation_plot));
+    plot_widget_end_diagram(PLOT_WIDGET(widgets->eye_plot));
+    plot_widget_end_ber(PLOT_WIDGET(widgets->ber_plot));
+    widgets->diagram_valid = false;
     gtk_widget_queue_draw(widgets->signal_plot);
     gtk_widget_queue_draw(widgets->time_plot);
     gtk_widget_queue_draw(widgets->phasor_plot);
+    gtk_widget_queue_draw(widgets->constellation_plot);
+    gtk_widget_queue_draw(widgets->eye_plot);
+    gtk_widget_queue_draw(widgets->ber_plot);
 }
 
-static void generate_signals(GtkButton *button, gpointer user_data) {
-    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
-
+// Reads and validates the parameter fields; shows an error and returns false on bad input
+static bool read_params(AppWidgets *widgets, SimulationParams &params) {
     // Get parameters
     double amplitude = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->amplitude_entry)));
     double frequency = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->frequency_entry)));
@@ -73,7 +143,18 @@ static void generate_signals(GtkButton *button, gpointer user_data) {
     double bandwidth = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->bandwidth_entry)));
     guint mod_index = gtk_drop_down_get_selected(GTK_DROP_DOWN(widgets->modulation_dropdown));
     guint code_index = gtk_drop_down_get_selected(GTK_DROP_DOWN(widgets->coding_dropdown));
+    guint rate_index = gtk_drop_down_get_selected(GTK_DROP_DOWN(widgets->rate_dropdown));
+    guint noise_index = gtk_drop_down_get_selected(GTK_DROP_DOWN(widgets->noise_dropdown));
     unsigned int seed = atoi(gtk_editable_get_text(GTK_EDITABLE(widgets->seed_entry)));
+    int samples_per_symbol = atoi(gtk_editable_get_text(GTK_EDITABLE(widgets->sps_entry)));
+    double rolloff = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->rolloff_entry)));
+    double doppler = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->doppler_entry)));
+    double k_factor = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->kfactor_entry)));
+    double cfo = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->cfo_entry)));
+    double phase_noise = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->phase_noise_entry)));
+    double iq_gain_db = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->iq_gain_entry)));
+    double iq_phase_deg = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->iq_phase_entry)));
+    double dc_offset = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->dc_offset_entry)));
 
     // Map dropdown indices to modulation and coding types
     ModulationType mod_type = BPSK;
@@ -82,93 +163,459 @@ static void generate_signals(GtkButton *button, gpointer user_data) {
         case 1: mod_type = QPSK; break;
         case 2: mod_type = QAM16; break;
     }
-    CodingType code_type = (code_index == 0) ? NONE : CONVOLUTIONAL;
+    CodingType code_type = NONE;
+    switch (code_index) {
+        case 0: code_type = NONE; break;
+        case 1: code_type = CONVOLUTIONAL; break;
+        case 2: code_type = CONVOLUTIONAL_K7; break;
+        case 3: code_type = LDPC; break;
+        case 4: code_type = TURBO; break;
+    }
+    CodeRate code_rate = RATE_1_2;
+    switch (rate_index) {
+        case 0: code_rate = RATE_1_2; break;
+        case 1: code_rate = RATE_2_3; break;
+        case 2: code_rate = RATE_3_4; break;
+        case 3: code_rate = RATE_5_6; break;
+    }
 
     // Validate inputs
     if (amplitude <= 0) {
         show_error_dialog(widgets->window, "Amplitude must be greater than 0");
-        return;
+        return false;
     }
     if (frequency <= 0) {
         show_error_dialog(widgets->window, "Frequency must be greater than 0");
-        return;
+        return false;
     }
     if (num_samples == 0 || num_samples > 100000) {
         show_error_dialog(widgets->window, "Number of samples must be between 1 and 100,000");
-        return;
+        return false;
     }
     if (snr_db < 0) {
         show_error_dialog(widgets->window, "SNR must be non-negative");
-        return;
+        return false;
     }
     if (bit_rate <= 0) {
         show_error_dialog(widgets->window, "Bit rate must be greater than 0");
-        return;
+        return false;
     }
     if (bandwidth <= 0) {
         show_error_dialog(widgets->window, "Bandwidth must be greater than 0");
-        return;
+        return false;
     }
-
-    // Generate random bits for digital modulation
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<> bit_dist(0, 1);
-    std::vector<int> bits(num_samples);
-    for (size_t i = 0; i < num_samples; ++i) {
-        bits[i] = bit_dist(gen);
+    if (samples_per_symbol < 1 || samples_per_symbol > 16) {
+        show_error_dialog(widgets->window, "Samples per symbol must be between 1 and 16");
+        return false;
+    }
+    if (rolloff < 0 || rolloff > 1) {
+        show_error_dialog(widgets->window, "Roll-off must be between 0 and 1");
+        return false;
     }
+    if (doppler < 0 || doppler > 0.5) {
+        show_error_dialog(widgets->window, "Doppler must be between 0 and 0.5");
+        return false;
+    }
+    if (k_factor < 0) {
+        show_error_dialog(widgets->window, "K-factor must be non-negative");
+        return false;
+    }
+    if (cfo < -0.5 || cfo > 0.5) {
+        show_error_dialog(widgets->window, "CFO must be between -0.5 and 0.5");
+        return false;
+    }
+    if (phase_noise < 0 || phase_noise > 1) {
+        show_error_dialog(widgets->window, "Phase noise must be between 0 and 1");
+        return false;
+    }
+    if (iq_gain_db < -6 || iq_gain_db > 6) {
+        show_error_dialog(widgets->window, "IQ gain imbalance must be between -6 and 6 dB");
+        return false;
+    }
+    if (iq_phase_deg < -45 || iq_phase_deg > 45) {
+        show_error_dialog(widgets->window, "IQ phase imbalance must be between -45 and 45 degrees");
+        return false;
+    }
+
+    params = SimulationParams();
+    params.numBits = num_samples;
+    params.seed = seed;
+    params.modulation = mod_type;
+    params.coding = code_type;
+    params.codeRate = code_rate;
+    params.samplesPerSymbol = samples_per_symbol;
+    params.rolloff = rolloff;
+    params.amplitude = amplitude;
+    params.snrDb = snr_db;
+    params.bitRate = bit_rate;
+    params.bandwidth = bandwidth;
+    params.bandlimitedNoise = (noise_index == 1);
+    params.doppler = doppler;
+    params.kFactor = k_factor;
+    params.frequencyOffset = cfo;
+    params.phaseNoise = phase_noise;
+    params.iqGainDb = iq_gain_db;
+    params.iqPhaseDeg = iq_phase_deg;
+    params.dcOffset = dc_offset;
+    return true;
+}
+
+// Fixed plot range: signal peak plus three noise standard deviations
+static double plot_limit(const SimulationParams &params) {
+    double noise_std = std::sqrt(std::pow(10.0, -params.snrDb / 10.0));
+    return params.amplitude * (1.5 + 3.0 * noise_std);
+}
 
-    // Initialize channel model and AWGN
-    AWGN awgn(snr_db, bit_rate, bandwidth, mod_type, code_type, seed);
-    ChannelModel& channel = awgn.getChannelModel();
-    Analyzer analyzer;
+// Runs that differ only in seed draw new symbols from the same distribution, so
+// their diagrams add up; any other change starts the diagrams over
+static bool same_diagram_setup(const SimulationParams &a, const SimulationParams &b) {
+    return a.modulation == b.modulation && a.coding == b.coding && a.codeRate == b.codeRate &&
+           a.samplesPerSymbol == b.samplesPerSymbol && a.rolloff == b.rolloff && a.amplitude == b.amplitude &&
+           a.snrDb == b.snrDb && a.bitRate == b.bitRate && a.bandwidth == b.bandwidth &&
+           a.bandlimitedNoise == b.bandlimitedNoise && a.doppler == b.doppler && a.kFactor == b.kFactor &&
+           a.frequencyOffset == b.frequencyOffset && a.phaseNoise == b.phaseNoise && a.iqGainDb == b.iqGainDb &&
+           a.iqPhaseDeg == b.iqPhaseDeg && a.dcOffset == b.dcOffset && a.seed != b.seed;
+}
 
-    // Modulate bits
-    std::vector<double> signal = channel.modulate(bits);
-    // Scale signal to desired amplitude
-    for (auto& sample : signal) {
-        sample *= amplitude;
+static void begin_diagrams(AppWidgets *widgets, const SimulationParams &params) {
+    size_t values_per_symbol = ChannelModel(params.modulation).getBitsPerSymbol();
+    double limit = plot_limit(params);
+    plot_widget_begin_diagram(PLOT_WIDGET(widgets->constellation_plot), PLOT_TYPE_CONSTELLATION,
+                              values_per_symbol, params.samplesPerSymbol, limit);
+    plot_widget_begin_diagram(PLOT_WIDGET(widgets->eye_plot), PLOT_TYPE_EYE,
+                              values_per_symbol, params.samplesPerSymbol, limit);
+    widgets->diagram_valid = true;
+    widgets->diagram_params = params;
+    widgets->diagram_group = values_per_symbol * params.samplesPerSymbol;
+}
+
+// Adds the received symbols of the latest Generate to the diagrams
+static void accumulate_diagrams(AppWidgets *widgets, const SimulationParams &params) {
+    if (!widgets->diagram_valid || !same_diagram_setup(widgets->diagram_params, params)) {
+        begin_diagrams(widgets, params);
     }
-    std::vector<double> noisy_signal = awgn.addNoise(signal);
-    std::vector<int> decoded_bits = channel.demodulate(noisy_signal);
+    widgets->diagram_params.seed = params.seed;
+    const ChannelModel &channel = widgets->graph.getChannel();
+    const std::vector<double> &received = widgets->graph.getReceivedSignal();
+    widgets->diagram_buffer.resize(channel.receivedWaveformLength(received.size()));
+    size_t length = channel.receiveWaveform(received.data(), received.size(), widgets->diagram_buffer.data());
+    plot_widget_diagram_add(PLOT_WIDGET(widgets->constellation_plot), widgets->diagram_buffer.data(), length, true);
+    plot_widget_diagram_add(PLOT_WIDGET(widgets->eye_plot), widgets->diagram_buffer.data(), length, true);
+}
 
-    // Compute BER
-    size_t errors = 0;
-    for (size_t i = 0; i < bits.size() && i < decoded_bits.size(); ++i) {
-        if (bits[i] != decoded_bits[i]) errors++;
+// The sweep engine's view of the GUI setup, one frame per point; it has no fading
+static SweepConfig sweep_config(const SimulationParams &params) {
+    SweepConfig config;
+    config.modulation = params.modulation;
+    config.coding = params.coding;
+    config.codeRate = params.codeRate;
+    config.bitsPerFrame = params.numBits;
+    config.seed = params.seed;
+    config.bitRate = params.bitRate;
+    config.bandwidth = params.bandwidth;
+    config.bandlimitedNoise = params.bandlimitedNoise;
+    config.samplesPerSymbol = params.samplesPerSymbol;
+    config.rolloff = params.rolloff;
+    return config;
+}
+
+static void generate_signals(GtkButton *button, gpointer user_data) {
+    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    stop_stream(widgets);
+    SimulationParams params;
+    if (!read_params(widgets, params)) {
+        return;
     }
-    double ber = static_cast<double>(errors) / bits.size();
+    ModulationType mod_type = params.modulation;
+    CodingType code_type = params.coding;
+    CodeRate code_rate = params.codeRate;
+    unsigned int seed = params.seed;
 
-    // Calculate Eb/N0
-    SignalToNoiseRatio snr_controller(snr_db, bit_rate, bandwidth);
-    double eb_n0 = snr_controller.calculateEbN0(signal);
+    // Only the stages whose inputs changed since the last run are recomputed
+    SimulationGraph& graph = widgets->graph;
+    unsigned int recomputed = graph.run(params);
+    double ber = graph.getBER();
+    double eb_n0 = graph.getEbN0();
 
     // Update time domain label with BER
+    // Setups with a closed form show it next to the measurement
     char time_text[100];
-    snprintf(time_text, sizeof(time_text), "Bit Error Rate: %.4f", ber);
+    SweepConfig config = sweep_config(params);
+    if (BerSweep::hasClosedForm(config) && params.doppler == 0 && !params.hasImpairments()) {
+        double theory = BerSweep::theoryBer(config, {params.snrDb})[0];
+        snprintf(time_text, sizeof(time_text), "Bit Error Rate: %.4f (theory %.4f)", ber, theory);
+    } else {
+        snprintf(time_text, sizeof(time_text), "Bit Error Rate: %.4f", ber);
+    }
     gtk_label_set_text(GTK_LABEL(widgets->time_label), time_text);
 
     // Update phasor label with Eb/N0
     char phasor_text[200];
     snprintf(phasor_text, sizeof(phasor_text),
-             "Phasor Statistics: N/A\nEb/N0: %.2f dB\nModulation: %s\nCoding: %s",
+             "Phasor Statistics: N/A\nEb/N0: %.2f dB\nModulation: %s\nCoding: %s%s",
              eb_n0,
              mod_type == BPSK ? "BPSK" : mod_type == QPSK ? "QPSK" : "16-QAM",
-             code_type == NONE ? "None" : "Convolutional");
+             code_type == NONE ? "None" : code_type == CONVOLUTIONAL ? "Convolutional K=3" :
+             code_type == CONVOLUTIONAL_K7 ? "Convolutional K=7" : code_type == LDPC ? "LDPC (648, 1/2)" : "Turbo (1024, 1/3)",
+             code_type == NONE || code_type == LDPC || code_type == TURBO ? "" : code_rate == RATE_1_2 ? ", rate 1/2" : code_rate == RATE_2_3 ? ", rate 2/3" :
+             code_rate == RATE_3_4 ? ", rate 3/4" : ", rate 5/6");
     gtk_label_set_text(GTK_LABEL(widgets->phasor_label), phasor_text);
 
-    // Update plots
+    // Update plots, unless the plotted signals are unchanged
+    if (!(recomputed & (STAGE_SCALED | STAGE_NOISY))) {
+        return;
+    }
+    const std::vector<double>& signal = graph.getSignal();
+    const std::vector<double>& noisy_signal = graph.getNoisySignal();
+    size_t signal_length = signal.size();
     PlotWidget *signal_plot = PLOT_WIDGET(widgets->signal_plot);
     PlotWidget *time_plot = PLOT_WIDGET(widgets->time_plot);
     PlotWidget *phasor_plot = PLOT_WIDGET(widgets->phasor_plot);
-    plot_widget_set_data(signal_plot, signal, noisy_signal, PLOT_TYPE_SIGNAL, seed);
-    plot_widget_set_data(time_plot, signal, noisy_signal, PLOT_TYPE_TIME, seed);
-    plot_widget_set_data(phasor_plot, signal, noisy_signal, PLOT_TYPE_PHASOR, seed);
+    plot_widget_set_data(signal_plot, signal.data(), noisy_signal.data(), signal_length, PLOT_TYPE_SIGNAL, seed);
+    plot_widget_set_data(time_plot, signal.data(), noisy_signal.data(), signal_length, PLOT_TYPE_TIME, seed);
+    plot_widget_set_data(phasor_plot, signal.data(), noisy_signal.data(), signal_length, PLOT_TYPE_PHASOR, seed);
+    accumulate_diagrams(widgets, params);
     gtk_widget_queue_draw(widgets->signal_plot);
     gtk_widget_queue_draw(widgets->time_plot);
     gtk_widget_queue_draw(widgets->phasor_plot);
 }
 
+// Symbol periods binned into the diagrams per frame while streaming. The eye
+// costs about 2 us per period whatever the samples per symbol, so this bounds
+// the binning to about 10 ms per frame; anything more is skipped.
+static const size_t DIAGRAM_PERIODS_PER_FRAME = 4096;
+
+// Runs once per displayed frame while streaming: hands what arrived since the
+// last frame to the scope plots, which decimate it and draw only the new columns,
+// and to the diagrams, which bin it
+static gboolean on_stream_tick(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data) {
+    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    PlotWidget *signal_plot = PLOT_WIDGET(widgets->signal_plot);
+    PlotWidget *time_plot = PLOT_WIDGET(widgets->time_plot);
+    StreamingChannel& stream = widgets->stream;
+
+    // Only the newest screenful is visible, so a backlog is skipped rather than drawn late
+    size_t window = signal_plot->scope_window;
+    size_t available = stream.available();
+    if (available > window) {
+        stream.discard(available - window);
+        available = window;
+    }
+    const size_t stride = sizeof(StreamSample) / sizeof(double);
+    while (available > 0) {
+        size_t count = stream.read(widgets->stream_buffer.data(), std::min(available, widgets->stream_buffer.size()));
+        if (count == 0) {
+            break;
+        }
+        const StreamSample *samples = widgets->stream_buffer.data();
+        plot_widget_scope_push(signal_plot, &samples->original, &samples->noisy, count, stride);
+        plot_widget_scope_push(time_plot, &samples->original, &samples->noisy, count, stride);
+        available -= count;
+    }
+
+    // The diagrams bin a bounded number of symbol periods per frame; reads and
+    // skips stay in whole periods so the values stay aligned to the symbols
+    const size_t group = widgets->diagram_group;
+    size_t received = stream.availableReceived() / group * group;
+    size_t budget = DIAGRAM_PERIODS_PER_FRAME * group;
+    bool skipped = received > budget;
+    if (skipped) {
+        stream.discardReceived(received - budget);
+        received = budget;
+    }
+    widgets->diagram_buffer.resize(budget);
+    size_t count = stream.readReceived(widgets->diagram_buffer.data(), received);
+    if (count > 0) {
+        plot_widget_diagram_add(PLOT_WIDGET(widgets->constellation_plot), widgets->diagram_buffer.data(), count, skipped);
+        plot_widget_diagram_add(PLOT_WIDGET(widgets->eye_plot), widgets->diagram_buffer.data(), count, skipped);
+    }
+
+    if (!stream.isRunning()) {
+        // The producer stopped on its own; returning G_SOURCE_REMOVE drops this callback
+        widgets->stream_tick = 0;
+        stream.stop();
+        widgets->graph.invalidate();
+        gtk_button_set_label(GTK_BUTTON(widgets->stream_button), "Start Stream");
+        gtk_label_set_text(GTK_LABEL(widgets->time_label), "Stream stopped");
+        return G_SOURCE_REMOVE;
+    }
+    if (++widgets->stream_frames % 30 == 0) {
+        char status[120];
+        snprintf(status, sizeof(status), "Streaming at %.3g samples/s, %llu samples dropped",
+                 widgets->stream_rate, (unsigned long long)stream.getDroppedSamples());
+        gtk_label_set_text(GTK_LABEL(widgets->time_label), status);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void start_stream(AppWidgets *widgets) {
+    SimulationParams params;
+    if (!read_params(widgets, params)) {
+        return;
+    }
+    double rate = atof(gtk_editable_get_text(GTK_EDITABLE(widgets->stream_rate_entry)));
+    if (rate < 1000 || rate > 100e6) {
+        show_error_dialog(widgets->window, "Stream rate must be between 1,000 and 100,000,000 samples/s");
+        return;
+    }
+
+    // The Samples field sets how many samples span the plot width
+    double limit = plot_limit(params);
+    begin_diagrams(widgets, params);
+    plot_widget_begin_scope(PLOT_WIDGET(widgets->signal_plot), PLOT_TYPE_SIGNAL, params.numBits, -limit, limit);
+    plot_widget_begin_scope(PLOT_WIDGET(widgets->time_plot), PLOT_TYPE_TIME, params.numBits, -limit, limit);
+
+    widgets->stream_buffer.resize(65536);
+    widgets->stream_rate = rate;
+    widgets->stream_frames = 0;
+    widgets->stream.start(params, rate);
+    widgets->stream_tick = gtk_widget_add_tick_callback(widgets->notebook, on_stream_tick, widgets, NULL);
+    gtk_button_set_label(GTK_BUTTON(widgets->stream_button), "Stop Stream");
+    gtk_label_set_text(GTK_LABEL(widgets->time_label), "Streaming...");
+}
+
+static void stop_stream(AppWidgets *widgets) {
+    if (widgets->stream_tick == 0) {
+        return;
+    }
+    gtk_widget_remove_tick_callback(widgets->notebook, widgets->stream_tick);
+    widgets->stream_tick = 0;
+    widgets->stream.stop();
+    widgets->graph.invalidate(); // The next Generate must replace the scope views
+    gtk_button_set_label(GTK_BUTTON(widgets->stream_button), "Start Stream");
+}
+
+static void toggle_stream(GtkButton *button, gpointer user_data) {
+    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    if (widgets->stream_tick != 0) {
+        stop_stream(widgets);
+    } else {
+        start_stream(widgets);
+    }
+}
+
+// Runs every 100 ms during a sweep: passes the latest counts to the BER plot,
+// which redraws only if a point or its interval moved on screen
+static gboolean on_sweep_timer(gpointer user_data) {
+    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    // Read before polling, so the last publish is not missed when the sweep ends in between
+    bool running = widgets->sweep.isRunning();
+    size_t frames = 0;
+    if (widgets->sweep.poll(widgets->sweep_points, frames, widgets->sweep_version)) {
+        PlotWidget *ber_plot = PLOT_WIDGET(widgets->ber_plot);
+        for (size_t i = 0; i < widgets->sweep_points.size(); ++i) {
+            plot_widget_ber_update(ber_plot, i, widgets->sweep_points[i].bits, widgets->sweep_points[i].errors);
+        }
+        char status[120];
+        snprintf(status, sizeof(status), "Sweep: %zu of %zu frames per point%s", frames,
+                 widgets->sweep.getTotalFrames(), running ? "" : ", done");
+        gtk_label_set_text(GTK_LABEL(widgets->ber_label), status);
+    }
+    if (!running) {
+        widgets->sweep_timer = 0;
+        widgets->sweep.stop();
+        gtk_button_set_label(GTK_BUTTON(widgets->sweep_button), "Run Sweep");
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+// Sweeps the current setup over the sweep SNR points with the headless engine,
+// in frames of Samples bits. The engine has no fading or RF impairments, so
+// Doppler, K-factor, CFO, phase noise, IQ imbalance and DC offset do not apply.
+static void start_sweep(AppWidgets *widgets) {
+    SimulationParams params;
+    if (!read_params(widgets, params)) {
+        return;
+    }
+    std::vector<double> snr_points;
+    try {
+        snr_points = SweepCommand::parseSnrList(gtk_editable_get_text(GTK_EDITABLE(widgets->sweep_snr_entry)));
+    } catch (const std::exception&) {
+        show_error_dialog(widgets->window, "Sweep SNR must be A,B,C or START:STEP:STOP");
+        return;
+    }
+    if (snr_points.empty() || snr_points.size() > 100) {
+        show_error_dialog(widgets->window, "Sweep SNR must list between 1 and 100 points");
+        return;
+    }
+    int frames = atoi(gtk_editable_get_text(GTK_EDITABLE(widgets->sweep_frames_entry)));
+    if (frames < 1 || frames > 1000000) {
+        show_error_dialog(widgets->window, "Sweep frames must be between 1 and 1,000,000");
+        return;
+    }
+
+    SweepConfig config = sweep_config(params);
+    config.framesPerPoint = frames;
+
+    // Points go on the Eb/N0 axis, where the theory curve does not depend on the setup
+    ChannelModel channel(params.modulation, params.coding);
+    if (channel.supportsPuncturing()) {
+        channel.setCodeRate(params.codeRate);
+    }
+    std::vector<double> eb_n0;
+    for (double snr : snr_points) {
+        eb_n0.push_back(BerTheory::ebN0FromSnr(snr, params.modulation, channel.getCodeRate(), params.samplesPerSymbol));
+    }
+    // The bottom decade is a tenth of one error over the whole sweep of a point
+    double total_bits = (double)config.bitsPerFrame * config.framesPerPoint;
+    plot_widget_begin_ber(PLOT_WIDGET(widgets->ber_plot), params.modulation, eb_n0, std::max(0.1 / total_bits, 1e-12));
+
+    try {
+        widgets->sweep.start(config, snr_points);
+    } catch (const std::exception& e) {
+        show_error_dialog(widgets->window, e.what());
+        return;
+    }
+    widgets->sweep_version = 0;
+    widgets->sweep_timer = g_timeout_add(100, on_sweep_timer, widgets);
+    gtk_button_set_label(GTK_BUTTON(widgets->sweep_button), "Stop Sweep");
+    gtk_label_set_text(GTK_LABEL(widgets->ber_label), "Sweep: starting...");
+}
+
+static void stop_sweep(AppWidgets *widgets) {
+    if (widgets->sweep_timer == 0) {
+        return;
+    }
+    g_source_remove(widgets->sweep_timer);
+    widgets->sweep_timer = 0;
+    widgets->sweep.stop(); // Points keep the counts of the frames already run
+    gtk_button_set_label(GTK_BUTTON(widgets->sweep_button), "Run Sweep");
+    gtk_label_set_text(GTK_LABEL(widgets->ber_label), "Sweep: stopped");
+}
+
+static void toggle_sweep(GtkButton *button, gpointer user_data) {
+    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    if (widgets->sweep_timer != 0) {
+        stop_sweep(widgets);
+    } else {
+        start_sweep(widgets);
+    }
+}
+
+// Enter in any entry regenerates; the graph keeps this cheap for small edits
+static void on_entry_activate(GtkEntry *entry, gpointer user_data) {
+    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    if (widgets->stream_tick != 0) {
+        // While streaming, restart the stream with the new parameters instead
+        stop_stream(widgets);
+        start_stream(widgets);
+        return;
+    }
+    generate_signals(NULL, user_data);
+}
+
+// Dropdown changes regenerate once there are results to update
+static void on_dropdown_changed(GObject *object, GParamSpec *pspec, gpointer user_data) {
+    AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
+    if (widgets->stream_tick != 0) {
+        stop_stream(widgets);
+        start_stream(widgets);
+    } else if (widgets->graph.hasResults()) {
+        generate_signals(NULL, user_data);
+    }
+}
+
 static void activate(GtkApplication *app, gpointer user_data) {
     AppWidgets *widgets = static_cast<AppWidgets*>(user_data);
 
@@ -269,17 +716,114 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_widget_set_halign(coding_label, GTK_ALIGN_END);
     GtkStringList *code_list = gtk_string_list_new(NULL);
     gtk_string_list_append(code_list, "None");
-    gtk_string_list_append(code_list, "Convolutional");
+    gtk_string_list_append(code_list, "Convolutional K=3");
+    gtk_string_list_append(code_list, "Convolutional K=7");
+    gtk_string_list_append(code_list, "LDPC (648, 1/2)");
+    gtk_string_list_append(code_list, "Turbo (1024, 1/3)");
     widgets->coding_dropdown = gtk_drop_down_new(G_LIST_MODEL(code_list), NULL);
     gtk_drop_down_set_selected(GTK_DROP_DOWN(widgets->coding_dropdown), 0);
     gtk_widget_set_tooltip_text(widgets->coding_dropdown, "Select channel coding scheme");
 
+    // Code rate dropdown
+    GtkWidget *rate_label = gtk_label_new("Code Rate:");
+    gtk_widget_set_halign(rate_label, GTK_ALIGN_END);
+    GtkStringList *rate_list = gtk_string_list_new(NULL);
+    gtk_string_list_append(rate_list, "1/2");
+    gtk_string_list_append(rate_list, "2/3");
+    gtk_string_list_append(rate_list, "3/4");
+    gtk_string_list_append(rate_list, "5/6");
+    widgets->rate_dropdown = gtk_drop_down_new(G_LIST_MODEL(rate_list), NULL);
+    gtk_drop_down_set_selected(GTK_DROP_DOWN(widgets->rate_dropdown), 0);
+    gtk_widget_set_tooltip_text(widgets->rate_dropdown, "Punctured code rate (convolutional coding only)");
+
+    // Noise dropdown
+    GtkWidget *noise_label = gtk_label_new("Noise:");
+    gtk_widget_set_halign(noise_label, GTK_ALIGN_END);
+    GtkStringList *noise_list = gtk_string_list_new(NULL);
+    gtk_string_list_append(noise_list, "White");
+    gtk_string_list_append(noise_list, "Bandlimited");
+    widgets->noise_dropdown = gtk_drop_down_new(G_LIST_MODEL(noise_list), NULL);
+    gtk_drop_down_set_selected(GTK_DROP_DOWN(widgets->noise_dropdown), 0);
+    gtk_widget_set_tooltip_text(widgets->noise_dropdown, "White noise or noise lowpass-filtered to the bandwidth");
+
     GtkWidget *seed_label = gtk_label_new("Seed:");
     gtk_widget_set_halign(seed_label, GTK_ALIGN_END);
     widgets->seed_entry = gtk_entry_new();
     gtk_editable_set_text(GTK_EDITABLE(widgets->seed_entry), "0");
     gtk_widget_set_tooltip_text(widgets->seed_entry, "Random seed (non-negative integer)");
 
+    GtkWidget *sps_label = gtk_label_new("Samples/Symbol:");
+    gtk_widget_set_halign(sps_label, GTK_ALIGN_END);
+    widgets->sps_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->sps_entry), "1");
+    gtk_widget_set_tooltip_text(widgets->sps_entry, "Oversampling for RRC pulse shaping (1 = no shaping, up to 16)");
+
+    GtkWidget *rolloff_label = gtk_label_new("Roll-off:");
+    gtk_widget_set_halign(rolloff_label, GTK_ALIGN_END);
+    widgets->rolloff_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->rolloff_entry), "0.35");
+    gtk_widget_set_tooltip_text(widgets->rolloff_entry, "RRC roll-off factor (0 to 1)");
+
+    GtkWidget *doppler_label = gtk_label_new("Doppler:");
+    gtk_widget_set_halign(doppler_label, GTK_ALIGN_END);
+    widgets->doppler_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->doppler_entry), "0.0");
+    gtk_widget_set_tooltip_text(widgets->doppler_entry, "Maximum Doppler shift per sample (0 = no fading, up to 0.5)");
+
+    GtkWidget *kfactor_label = gtk_label_new("K-factor:");
+    gtk_widget_set_halign(kfactor_label, GTK_ALIGN_END);
+    widgets->kfactor_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->kfactor_entry), "0.0");
+    gtk_widget_set_tooltip_text(widgets->kfactor_entry, "Rician K-factor, linear (0 = Rayleigh)");
+
+    GtkWidget *cfo_label = gtk_label_new("CFO:");
+    gtk_widget_set_halign(cfo_label, GTK_ALIGN_END);
+    widgets->cfo_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->cfo_entry), "0.0");
+    gtk_widget_set_tooltip_text(widgets->cfo_entry, "Carrier frequency offset in cycles per sample (-0.5 to 0.5)");
+
+    GtkWidget *phase_noise_label = gtk_label_new("Phase Noise:");
+    gtk_widget_set_halign(phase_noise_label, GTK_ALIGN_END);
+    widgets->phase_noise_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->phase_noise_entry), "0.0");
+    gtk_widget_set_tooltip_text(widgets->phase_noise_entry, "Wiener phase noise, radians per sample (0 to 1)");
+
+    GtkWidget *iq_gain_label = gtk_label_new("IQ Gain (dB):");
+    gtk_widget_set_halign(iq_gain_label, GTK_ALIGN_END);
+    widgets->iq_gain_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->iq_gain_entry), "0.0");
+    gtk_widget_set_tooltip_text(widgets->iq_gain_entry, "Receiver I/Q amplitude imbalance (-6 to 6 dB)");
+
+    GtkWidget *iq_phase_label = gtk_label_new("IQ Phase (deg):");
+    gtk_widget_set_halign(iq_phase_label, GTK_ALIGN_END);
+    widgets->iq_phase_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->iq_phase_entry), "0.0");
+    gtk_widget_set_tooltip_text(widgets->iq_phase_entry, "Receiver quadrature error (-45 to 45 degrees)");
+
+    GtkWidget *dc_offset_label = gtk_label_new("DC Offset:");
+    gtk_widget_set_halign(dc_offset_label, GTK_ALIGN_END);
+    widgets->dc_offset_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->dc_offset_entry), "0.0");
+    gtk_widget_set_tooltip_text(widgets->dc_offset_entry, "Receiver DC offset added to I and Q");
+
+    GtkWidget *stream_rate_label = gtk_label_new("Stream Rate:");
+    gtk_widget_set_halign(stream_rate_label, GTK_ALIGN_END);
+    widgets->stream_rate_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->stream_rate_entry), "1000000");
+    gtk_widget_set_tooltip_text(widgets->stream_rate_entry, "Samples per second in streaming mode (1,000 to 100,000,000)");
+
+    GtkWidget *sweep_snr_label = gtk_label_new("Sweep SNR (dB):");
+    gtk_widget_set_halign(sweep_snr_label, GTK_ALIGN_END);
+    widgets->sweep_snr_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->sweep_snr_entry), "0:1:10");
+    gtk_widget_set_tooltip_text(widgets->sweep_snr_entry, "SNR points of the BER sweep, as A,B,C or START:STEP:STOP");
+
+    GtkWidget *sweep_frames_label = gtk_label_new("Sweep Frames:");
+    gtk_widget_set_halign(sweep_frames_label, GTK_ALIGN_END);
+    widgets->sweep_frames_entry = gtk_entry_new();
+    gtk_editable_set_text(GTK_EDITABLE(widgets->sweep_frames_entry), "200");
+    gtk_widget_set_tooltip_text(widgets->sweep_frames_entry, "Frames of Samples bits per sweep point (1 to 1,000,000)");
+
     // Attach inputs to grid in two columns
     gtk_grid_attach(GTK_GRID(input_grid), amplitude_label, 0, 0, 1, 1);
     gtk_grid_attach(GTK_GRID(input_grid), widgets->amplitude_entry, 1, 0, 1, 1);
@@ -299,6 +843,34 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_grid_attach(GTK_GRID(input_grid), widgets->coding_dropdown, 3, 3, 1, 1);
     gtk_grid_attach(GTK_GRID(input_grid), seed_label, 0, 4, 1, 1);
     gtk_grid_attach(GTK_GRID(input_grid), widgets->seed_entry, 1, 4, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), noise_label, 2, 4, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->noise_dropdown, 3, 4, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), sps_label, 0, 5, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->sps_entry, 1, 5, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), rolloff_label, 2, 5, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->rolloff_entry, 3, 5, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), doppler_label, 0, 6, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->doppler_entry, 1, 6, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), kfactor_label, 2, 6, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->kfactor_entry, 3, 6, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), rate_label, 0, 7, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->rate_dropdown, 1, 7, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), stream_rate_label, 2, 7, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->stream_rate_entry, 3, 7, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), sweep_snr_label, 0, 8, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->sweep_snr_entry, 1, 8, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), sweep_frames_label, 2, 8, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->sweep_frames_entry, 3, 8, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), cfo_label, 0, 9, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->cfo_entry, 1, 9, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), phase_noise_label, 2, 9, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->phase_noise_entry, 3, 9, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), iq_gain_label, 0, 10, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->iq_gain_entry, 1, 10, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), iq_phase_label, 2, 10, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->iq_phase_entry, 3, 10, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), dc_offset_label, 0, 11, 1, 1);
+    gtk_grid_attach(GTK_GRID(input_grid), widgets->dc_offset_entry, 1, 11, 1, 1);
 
     gtk_frame_set_child(GTK_FRAME(input_frame), input_grid);
 
@@ -307,8 +879,14 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_widget_set_halign(button_box, GTK_ALIGN_CENTER);
     widgets->generate_button = gtk_button_new_with_label("Generate");
     widgets->reset_button = gtk_button_new_with_label("Reset");
+    widgets->stream_button = gtk_button_new_with_label("Start Stream");
+    gtk_widget_set_tooltip_text(widgets->stream_button, "Run the channel continuously, scrolling the Signal and Time plots and accumulating the diagrams");
     gtk_box_append(GTK_BOX(button_box), widgets->generate_button);
     gtk_box_append(GTK_BOX(button_box), widgets->reset_button);
+    gtk_box_append(GTK_BOX(button_box), widgets->stream_button);
+    widgets->sweep_button = gtk_button_new_with_label("Run Sweep");
+    gtk_widget_set_tooltip_text(widgets->sweep_button, "Measure BER over the sweep SNR points, plotted live in the BER Sweep tab");
+    gtk_box_append(GTK_BOX(button_box), widgets->sweep_button);
 
     // Notebook for tabs
     widgets->notebook = gtk_notebook_new();
@@ -345,6 +923,26 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_box_append(GTK_BOX(phasor_box), widgets->phasor_label);
     gtk_notebook_append_page(GTK_NOTEBOOK(widgets->notebook), phasor_box, gtk_label_new("Phasor Plot"));
 
+    // Constellation and eye diagram tabs
+    widgets->constellation_plot = GTK_WIDGET(plot_widget_new());
+    gtk_widget_set_vexpand(widgets->constellation_plot, TRUE);
+    gtk_notebook_append_page(GTK_NOTEBOOK(widgets->notebook), widgets->constellation_plot, gtk_label_new("Constellation"));
+    widgets->eye_plot = GTK_WIDGET(plot_widget_new());
+    gtk_widget_set_vexpand(widgets->eye_plot, TRUE);
+    gtk_notebook_append_page(GTK_NOTEBOOK(widgets->notebook), widgets->eye_plot, gtk_label_new("Eye Diagram"));
+
+    // BER sweep tab
+    GtkWidget *ber_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    widgets->ber_plot = GTK_WIDGET(plot_widget_new());
+    gtk_widget_set_vexpand(widgets->ber_plot, TRUE);
+    widgets->ber_label = gtk_label_new("Sweep: N/A");
+    gtk_widget_set_margin_start(widgets->ber_label, 8);
+    gtk_widget_set_margin_end(widgets->ber_label, 8);
+    gtk_widget_set_margin_top(widgets->ber_label, 8);
+    gtk_box_append(GTK_BOX(ber_box), widgets->ber_plot);
+    gtk_box_append(GTK_BOX(ber_box), widgets->ber_label);
+    gtk_notebook_append_page(GTK_NOTEBOOK(widgets->notebook), ber_box, gtk_label_new("BER Sweep"));
+
     // Assemble main box
     gtk_box_append(GTK_BOX(main_box), input_frame);
     gtk_box_append(GTK_BOX(main_box), button_box);
@@ -353,6 +951,22 @@ static void activate(GtkApplication *app, gpointer user_data) {
     // Connect signals
     g_signal_connect(widgets->generate_button, "clicked", G_CALLBACK(generate_signals), widgets);
     g_signal_connect(widgets->reset_button, "clicked", G_CALLBACK(reset_inputs), widgets);
+    g_signal_connect(widgets->stream_button, "clicked", G_CALLBACK(toggle_stream), widgets);
+    g_signal_connect(widgets->sweep_button, "clicked", G_CALLBACK(toggle_sweep), widgets);
+    GtkWidget *entries[] = {widgets->amplitude_entry, widgets->frequency_entry, widgets->samples_entry,
+                            widgets->snr_entry, widgets->bitrate_entry, widgets->bandwidth_entry,
+                            widgets->seed_entry, widgets->sps_entry, widgets->rolloff_entry,
+                            widgets->doppler_entry, widgets->kfactor_entry, widgets->cfo_entry,
+                            widgets->phase_noise_entry, widgets->iq_gain_entry, widgets->iq_phase_entry,
+                            widgets->dc_offset_entry};
+    for (GtkWidget *entry : entries) {
+        g_signal_connect(entry, "activate", G_CALLBACK(on_entry_activate), widgets);
+    }
+    GtkWidget *dropdowns[] = {widgets->modulation_dropdown, widgets->coding_dropdown,
+                              widgets->rate_dropdown, widgets->noise_dropdown};
+    for (GtkWidget *dropdown : dropdowns) {
+        g_signal_connect(dropdown, "notify::selected", G_CALLBACK(on_dropdown_changed), widgets);
+    }
 
     // Set main box as window content
     gtk_window_set_child(GTK_WINDOW(widgets->window), main_box);
@@ -360,6 +974,9 @@ static void activate(GtkApplication *app, gpointer user_data) {
 }
 
 int main(int argc, char *argv[]) {
+    if (SweepCommand::matches(argc, argv)) {
+        return SweepCommand::run(argc, argv); // Headless sweep modes never touch GTK
+    }
     GtkApplication *app = gtk_application_new("com.example.awgn_simulation", G_APPLICATION_DEFAULT_FLAGS);
     AppWidgets widgets;
 